@@ -0,0 +1,157 @@
+#include "Allocation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr size_t f_threadBufferCount{64};
+constexpr size_t f_sharedBufferCount{4096};
+constexpr size_t f_maxBufferCapacity{1 << 20};
+constexpr size_t f_slabBlockCount{64};
+
+std::atomic<uint64_t> f_bufferAllocations{0};
+std::atomic<uint64_t> f_handlerAllocations{0};
+std::atomic<uint64_t> f_slabAllocations{0};
+
+struct SharedBuffers {
+  std::mutex mutex;
+  std::vector<std::string> buffers;
+};
+
+SharedBuffers &sharedBuffers() {
+  static auto *buffers = new SharedBuffers{};
+  return *buffers;
+}
+
+struct ThreadBuffers {
+  std::vector<std::string> buffers;
+
+  ~ThreadBuffers() {
+    auto &shared = sharedBuffers();
+    std::lock_guard<std::mutex> guard{shared.mutex};
+    for (auto &buffer : buffers) {
+      if (shared.buffers.size() < f_sharedBufferCount) {
+        shared.buffers.push_back(std::move(buffer));
+      }
+    }
+  }
+};
+
+thread_local ThreadBuffers f_threadBuffers;
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+struct Slabs {
+  std::mutex mutex;
+  std::unordered_map<size_t, FreeBlock *> freeBlocks;
+};
+
+Slabs &slabs() {
+  static auto *pool = new Slabs{};
+  return *pool;
+}
+}  // namespace
+
+namespace example {
+AllocationStats allocationStats() {
+  return {f_bufferAllocations.load(std::memory_order_relaxed),
+          f_handlerAllocations.load(std::memory_order_relaxed),
+          f_slabAllocations.load(std::memory_order_relaxed)};
+}
+
+std::string BufferPool::acquire() {
+  auto &local = f_threadBuffers.buffers;
+  if (local.empty()) {
+    auto &shared = sharedBuffers();
+    std::lock_guard<std::mutex> guard{shared.mutex};
+    while (!shared.buffers.empty() && local.size() < f_threadBufferCount / 2) {
+      local.push_back(std::move(shared.buffers.back()));
+      shared.buffers.pop_back();
+    }
+  }
+  if (local.empty()) {
+    f_bufferAllocations.fetch_add(1, std::memory_order_relaxed);
+    return {};
+  }
+  auto buffer = std::move(local.back());
+  local.pop_back();
+  return buffer;
+}
+
+void BufferPool::release(std::string &&buffer) {
+  if (buffer.capacity() <= std::string{}.capacity() ||
+      buffer.capacity() > f_maxBufferCapacity) {
+    return;
+  }
+  buffer.clear();
+  auto &local = f_threadBuffers.buffers;
+  if (local.size() == f_threadBufferCount) {
+    auto &shared = sharedBuffers();
+    std::lock_guard<std::mutex> guard{shared.mutex};
+    while (local.size() > f_threadBufferCount / 2 &&
+           shared.buffers.size() < f_sharedBufferCount) {
+      shared.buffers.push_back(std::move(local.back()));
+      local.pop_back();
+    }
+    if (local.size() == f_threadBufferCount) {
+      return;
+    }
+  }
+  local.push_back(std::move(buffer));
+}
+
+HandlerMemory::HandlerMemory() : m_storage{} {}
+
+void *HandlerMemory::allocate(size_t size) {
+  if (size <= sizeof(m_storage) &&
+      !m_isInUse.test_and_set(std::memory_order_acquire)) {
+    return &m_storage;
+  }
+  f_handlerAllocations.fetch_add(1, std::memory_order_relaxed);
+  return ::operator new(size);
+}
+
+void HandlerMemory::deallocate(void *pointer) {
+  if (pointer == &m_storage) {
+    m_isInUse.clear(std::memory_order_release);
+    return;
+  }
+  ::operator delete(pointer);
+}
+
+void *SlabPool::allocate(size_t blockSize) {
+  blockSize = std::max(blockSize, sizeof(FreeBlock));
+  auto &pool = slabs();
+  std::lock_guard<std::mutex> guard{pool.mutex};
+  auto &freeBlock = pool.freeBlocks[blockSize];
+  if (!freeBlock) {
+    f_slabAllocations.fetch_add(1, std::memory_order_relaxed);
+    auto stride = (blockSize + alignof(std::max_align_t) - 1) /
+                  alignof(std::max_align_t) * alignof(std::max_align_t);
+    auto slab = static_cast<char *>(::operator new(stride * f_slabBlockCount));
+    for (size_t i = 0; i < f_slabBlockCount; i++) {
+      auto block = reinterpret_cast<FreeBlock *>(slab + i * stride);
+      block->next = freeBlock;
+      freeBlock = block;
+    }
+  }
+  auto block = freeBlock;
+  freeBlock = block->next;
+  return block;
+}
+
+void SlabPool::deallocate(size_t blockSize, void *block) {
+  blockSize = std::max(blockSize, sizeof(FreeBlock));
+  auto &pool = slabs();
+  std::lock_guard<std::mutex> guard{pool.mutex};
+  auto &freeBlock = pool.freeBlocks[blockSize];
+  auto released = static_cast<FreeBlock *>(block);
+  released->next = freeBlock;
+  freeBlock = released;
+}
+}  // namespace example
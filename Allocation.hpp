@@ -0,0 +1,209 @@
+#ifndef EXAMPLE_ALLOCATION_HPP
+#define EXAMPLE_ALLOCATION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace example {
+/**
+ * AllocationStats struct counts heap allocations performed by the library
+ * allocators when their recycled memory is exhausted.
+ */
+struct AllocationStats {
+  /**
+   * number of message buffers allocated by BufferPool.
+   */
+  uint64_t bufferAllocations;
+  /**
+   * number of completion handlers allocated outside HandlerMemory.
+   */
+  uint64_t handlerAllocations;
+  /**
+   * number of slabs allocated by SlabAllocator.
+   */
+  uint64_t slabAllocations;
+};
+/**
+ * Returns a snapshot of the heap allocations performed so far.
+ */
+AllocationStats allocationStats();
+/**
+ * BufferPool class recycles message buffers. Each thread keeps a bounded
+ * cache of buffers, which overflows into and is refilled from a pool shared
+ * by every thread, so that buffers released by the io thread can be reused
+ * by producer threads.
+ */
+class BufferPool {
+ public:
+  /**
+   * returns an empty buffer, recycled if possible.
+   */
+  static std::string acquire();
+  /**
+   * returns a buffer to the pool.
+   *
+   * @param buffer to recycle.
+   */
+  static void release(std::string &&buffer);
+};
+/**
+ * HandlerMemory class provides storage for a single completion handler at a
+ * time, so that consecutive asynchronous operations reuse the same memory.
+ * The storage is claimed atomically, so handlers posted from several threads
+ * at once never share it.
+ */
+class HandlerMemory {
+ public:
+  HandlerMemory();
+  HandlerMemory(const HandlerMemory &) = delete;
+  HandlerMemory &operator=(const HandlerMemory &) = delete;
+  /**
+   * returns storage of requested size, or heap memory if the storage is in
+   * use or too small.
+   *
+   * @param size in bytes requested.
+   */
+  void *allocate(size_t size);
+  /**
+   * releases memory returned by allocate().
+   *
+   * @param pointer to memory to release.
+   */
+  void deallocate(void *pointer);
+
+ private:
+  std::aligned_storage_t<512> m_storage;
+  std::atomic_flag m_isInUse = ATOMIC_FLAG_INIT;
+};
+/**
+ * HandlerAllocator class is the Asio associated allocator of handlers
+ * created with makeAllocatingHandler().
+ */
+template <typename T>
+class HandlerAllocator {
+ public:
+  using value_type = T;
+
+  explicit HandlerAllocator(HandlerMemory &memory) : m_memory{memory} {}
+
+  template <typename U>
+  HandlerAllocator(const HandlerAllocator<U> &other)
+      : m_memory{other.m_memory} {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(m_memory.allocate(sizeof(T) * n));
+  }
+
+  void deallocate(T *pointer, [[maybe_unused]] size_t n) {
+    m_memory.deallocate(pointer);
+  }
+
+  bool operator==(const HandlerAllocator &other) const {
+    return &m_memory == &other.m_memory;
+  }
+
+  bool operator!=(const HandlerAllocator &other) const {
+    return &m_memory != &other.m_memory;
+  }
+
+ private:
+  template <typename>
+  friend class HandlerAllocator;
+
+  HandlerMemory &m_memory;
+};
+/**
+ * AllocatingHandler class wraps a completion handler, associating it with a
+ * HandlerAllocator.
+ */
+template <typename Handler>
+class AllocatingHandler {
+ public:
+  using allocator_type = HandlerAllocator<Handler>;
+
+  AllocatingHandler(HandlerMemory &memory, Handler handler)
+      : m_memory{memory}, m_handler{std::move(handler)} {}
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type{m_memory};
+  }
+
+  template <typename... Args>
+  void operator()(Args &&...args) {
+    m_handler(std::forward<Args>(args)...);
+  }
+
+ private:
+  HandlerMemory &m_memory;
+  Handler m_handler;
+};
+/**
+ * Returns a completion handler allocated from specified memory.
+ *
+ * @param memory to allocate the handler from.
+ * @param handler to wrap.
+ */
+template <typename Handler>
+AllocatingHandler<std::decay_t<Handler>> makeAllocatingHandler(
+    HandlerMemory &memory, Handler &&handler) {
+  return {memory, std::forward<Handler>(handler)};
+}
+/**
+ * SlabPool class hands out equally sized blocks carved from slabs, recycling
+ * released blocks through free lists shared by every thread.
+ */
+class SlabPool {
+ public:
+  /**
+   * returns a block, recycled if possible.
+   *
+   * @param blockSize in bytes.
+   */
+  static void *allocate(size_t blockSize);
+  /**
+   * returns a block to the free list of its size.
+   *
+   * @param blockSize in bytes.
+   * @param block to recycle.
+   */
+  static void deallocate(size_t blockSize, void *block);
+};
+/**
+ * SlabAllocator class allocates single objects from SlabPool.
+ */
+template <typename T>
+class SlabAllocator {
+ public:
+  using value_type = T;
+
+  SlabAllocator() = default;
+
+  template <typename U>
+  SlabAllocator([[maybe_unused]] const SlabAllocator<U> &other) {}
+
+  T *allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T *>(::operator new(sizeof(T) * n));
+    }
+    return static_cast<T *>(SlabPool::allocate(sizeof(T)));
+  }
+
+  void deallocate(T *pointer, size_t n) {
+    if (n != 1) {
+      return ::operator delete(pointer);
+    }
+    SlabPool::deallocate(sizeof(T), pointer);
+  }
+
+  bool operator==(const SlabAllocator &) const { return true; }
+
+  bool operator!=(const SlabAllocator &) const { return false; }
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,16 @@
+#include "AwaitableClient.hpp"
+
+namespace example {
+AwaitableClient::AwaitableClient(boost::asio::io_context &ioContext,
+                                 const Framing &framing,
+                                 const ConnectionOptions &options)
+    : m_ioContext{ioContext}, m_framing{framing}, m_options{options} {}
+
+boost::asio::awaitable<AwaitableConnection> AwaitableClient::connect(
+    boost::asio::ip::tcp::endpoint endpoint) {
+  boost::asio::ip::tcp::socket socket{m_ioContext, endpoint.protocol()};
+  applySocketOptions(socket.native_handle(), m_options.socketOptions);
+  co_await socket.async_connect(endpoint, boost::asio::use_awaitable);
+  co_return AwaitableConnection{std::move(socket), m_framing, m_options};
+}
+}  // namespace example
@@ -0,0 +1,39 @@
+#ifndef EXAMPLE_AWAITABLE_CLIENT_HPP
+#define EXAMPLE_AWAITABLE_CLIENT_HPP
+
+#include "AwaitableConnection.hpp"
+
+namespace example {
+/**
+ * AwaitableClient class connects to TCP endpoints through C++20
+ * coroutines.
+ */
+class AwaitableClient {
+ public:
+  /**
+   * Constructs an AwaitableClient object.
+   *
+   * @param ioContext required for asynchronous input and ouput operations.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  AwaitableClient(boost::asio::io_context &ioContext,
+                  const Framing &framing = Framing::text(),
+                  const ConnectionOptions &options = {});
+  /**
+   * connects to specified endpoint.
+   *
+   * @param endpoint to connect to.
+   * @return connection established.
+   */
+  boost::asio::awaitable<AwaitableConnection> connect(
+      boost::asio::ip::tcp::endpoint endpoint);
+
+ private:
+  boost::asio::io_context &m_ioContext;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+};
+}  // namespace example
+
+#endif
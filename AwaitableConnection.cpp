@@ -0,0 +1,160 @@
+#include "AwaitableConnection.hpp"
+
+#include "Logging.hpp"
+
+namespace {
+constexpr size_t f_messageMaxSize{std::numeric_limits<uint32_t>::max()};
+constexpr size_t f_readChunkSize{65536};
+
+void checkMessageSize(size_t size) {
+  if (size > f_messageMaxSize) {
+    throw boost::system::system_error{boost::asio::error::message_size,
+                                      "message is too large"};
+  }
+}
+}  // namespace
+
+namespace example {
+AwaitableConnection::AwaitableConnection(
+    boost::asio::ip::tcp::socket &&socket, const Framing &framing,
+    const ConnectionOptions &options)
+    : m_socket{std::move(socket)},
+      m_framing{&framing},
+      m_options{options},
+      m_readBuffer{},
+      m_batch{},
+      m_chunks{},
+      m_message{},
+      m_headers{},
+      m_buffers{},
+      m_consumedBytes{0} {
+  applySocketOptions(m_socket.native_handle(), m_options.socketOptions);
+}
+
+boost::asio::awaitable<MessageView> AwaitableConnection::receive() {
+  co_await receiveFrames(1);
+  co_return m_batch.front();
+}
+
+boost::asio::awaitable<MessageBatch> AwaitableConnection::receiveBatch() {
+  co_await receiveFrames(std::numeric_limits<size_t>::max());
+  co_return MessageBatch{m_batch.data(), m_batch.data() + m_batch.size()};
+}
+
+boost::asio::awaitable<void> AwaitableConnection::send(
+    std::string_view message) {
+  checkMessageSize(message.size());
+  m_headers.resize(1);
+  auto headerSize =
+      m_framing->encode({message.size(), 0}, m_headers.front().data());
+  std::array<boost::asio::const_buffer, 2> buffers{
+      boost::asio::buffer(m_headers.front().data(), headerSize),
+      boost::asio::buffer(message)};
+  co_await boost::asio::async_write(m_socket, buffers,
+                                    boost::asio::use_awaitable);
+}
+
+boost::asio::awaitable<void> AwaitableConnection::send(
+    const MessageBatch &messages) {
+  m_headers.resize(messages.size());
+  m_buffers.clear();
+  for (size_t i = 0; i < messages.size(); i++) {
+    checkMessageSize(messages[i].size());
+    auto headerSize =
+        m_framing->encode({messages[i].size(), 0}, m_headers[i].data());
+    m_buffers.push_back(boost::asio::buffer(m_headers[i].data(), headerSize));
+    m_buffers.push_back(boost::asio::buffer(messages[i].view()));
+  }
+  co_await boost::asio::async_write(m_socket, m_buffers,
+                                    boost::asio::use_awaitable);
+}
+
+void AwaitableConnection::close() {
+  boost::system::error_code error;
+  m_socket.close(error);
+  if (error) {
+    EXAMPLE_LOG_ERROR("Awaitable Connection Close error: ", error.message());
+  }
+}
+
+boost::asio::awaitable<void> AwaitableConnection::receiveFrames(
+    size_t maxCount) {
+  m_readBuffer.consume(m_consumedBytes);
+  m_consumedBytes = 0;
+  size_t missingBytes;
+  while (!parseFrames(maxCount, missingBytes)) {
+    // chunks parsed without completing a message are already copied.
+    m_readBuffer.consume(m_consumedBytes);
+    m_consumedBytes = 0;
+    auto size = co_await m_socket.async_read_some(
+        m_readBuffer.prepare(std::max(missingBytes, f_readChunkSize)),
+        boost::asio::use_awaitable);
+    m_readBuffer.commit(size);
+  }
+}
+
+bool AwaitableConnection::parseFrames(size_t maxCount, size_t &missingBytes) {
+  auto data = m_readBuffer.data();
+  auto size = m_readBuffer.size();
+  size_t offset{0};
+  missingBytes = 0;
+  m_batch.clear();
+  while (offset < size && m_batch.size() < maxCount) {
+    FrameHeader header;
+    size_t headerSize;
+    if (!m_framing->decode(data + offset, size - offset, header,
+                           headerSize)) {
+      throw boost::system::system_error{
+          boost::asio::error::invalid_argument, "invalid message header"};
+    }
+    if (headerSize == 0) {
+      break;
+    }
+    auto frameSize = headerSize + header.size;
+    if (size - offset < frameSize) {
+      missingBytes = frameSize - (size - offset);
+      break;
+    }
+    if (header.flags & FrameHeader::chunkFlag) {
+      auto &chunks = m_chunks[header.flags & FrameHeader::laneMask];
+      checkMessageSize(chunks.size() + header.size);
+      chunks.append(data + offset + headerSize, header.size);
+      offset += frameSize;
+      if (header.flags & FrameHeader::lastChunkFlag) {
+        if (header.flags & FrameHeader::compressedFlag) {
+          decompress(chunks);
+        } else {
+          m_message.swap(chunks);
+        }
+        chunks.clear();
+        // the next reassembled message reuses the buffer, so the message
+        // ends the batch.
+        m_batch.emplace_back(std::string_view{m_message});
+        break;
+      }
+      continue;
+    }
+    if (header.flags & FrameHeader::compressedFlag) {
+      decompress({data + offset + headerSize, header.size});
+      offset += frameSize;
+      m_batch.emplace_back(std::string_view{m_message});
+      break;
+    }
+    m_batch.emplace_back(
+        std::string_view{data + offset + headerSize, header.size},
+        &m_readBuffer.storage());
+    offset += frameSize;
+  }
+  m_consumedBytes = offset;
+  return !m_batch.empty();
+}
+
+void AwaitableConnection::decompress(std::string_view message) {
+  auto codec = Codec::of(message, m_options.codec);
+  if (!codec ||
+      !codec->decompress(message, m_options.maxDecompressedSize, m_message)) {
+    throw boost::system::system_error{boost::asio::error::invalid_argument,
+                                      "invalid compressed message"};
+  }
+}
+}  // namespace example
@@ -0,0 +1,86 @@
+#ifndef EXAMPLE_AWAITABLE_CONNECTION_HPP
+#define EXAMPLE_AWAITABLE_CONNECTION_HPP
+
+#include <array>
+#include <boost/asio.hpp>
+#include <vector>
+
+#include "ConnectionOptions.hpp"
+#include "Framing.hpp"
+#include "Message.hpp"
+#include "ReceiveBuffer.hpp"
+
+namespace example {
+/**
+ * AwaitableConnection class exposes a connected TCP socket through C++20
+ * coroutines, as an alternative to the observers of TcpConnection. Messages
+ * already buffered are returned without suspending, so that they can be
+ * processed inline by the awaiting coroutine. Messages received in chunks
+ * are reassembled, and compressed messages decompressed, before being
+ * returned.
+ *
+ * Operations throw boost::system::system_error on failure. At most one
+ * receive and one send operation can be awaited at a time.
+ */
+class AwaitableConnection {
+ public:
+  /**
+   * Constructs an AwaitableConnection object.
+   *
+   * @param socket connected.
+   * @param framing used to delimit messages.
+   * @param options configuring the AwaitableConnection.
+   */
+  AwaitableConnection(boost::asio::ip::tcp::socket &&socket,
+                      const Framing &framing = Framing::text(),
+                      const ConnectionOptions &options = {});
+  /**
+   * receives next message.
+   *
+   * @return message, valid until the next receive operation.
+   */
+  boost::asio::awaitable<MessageView> receive();
+  /**
+   * receives every complete message buffered, reading from the socket only
+   * if there is none.
+   *
+   * @return messages, valid until the next receive operation.
+   */
+  boost::asio::awaitable<MessageBatch> receiveBatch();
+  /**
+   * sends a message, without copying it.
+   *
+   * @param message to send, valid until the operation completes.
+   */
+  boost::asio::awaitable<void> send(std::string_view message);
+  /**
+   * sends several messages with a single gather write, without copying
+   * them.
+   *
+   * @param messages to send, valid until the operation completes.
+   */
+  boost::asio::awaitable<void> send(const MessageBatch &messages);
+  /**
+   * closes socket, cancelling pending operations.
+   */
+  void close();
+
+ private:
+  boost::asio::awaitable<void> receiveFrames(size_t maxCount);
+  bool parseFrames(size_t maxCount, size_t &missingBytes);
+  void decompress(std::string_view message);
+
+  boost::asio::ip::tcp::socket m_socket;
+  const Framing *m_framing;
+  ConnectionOptions m_options;
+  ReceiveBuffer m_readBuffer;
+  std::vector<MessageView> m_batch;
+  std::array<Buffer, FrameHeader::laneMask + 1> m_chunks;
+  Buffer m_message;
+  std::vector<std::array<char, Framing::maxHeaderSize>> m_headers;
+  std::vector<boost::asio::const_buffer> m_buffers;
+  size_t m_consumedBytes;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,38 @@
+#include "AwaitableServer.hpp"
+
+#include "Logging.hpp"
+
+namespace example {
+AwaitableServer::AwaitableServer(boost::asio::io_context &ioContext,
+                                 const Framing &framing,
+                                 const ConnectionOptions &options)
+    : m_acceptor{ioContext}, m_framing{framing}, m_options{options} {}
+
+bool AwaitableServer::listen(const boost::asio::ip::tcp &protocol,
+                             uint16_t port) {
+  try {
+    m_acceptor.open(protocol);
+    m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+    applySocketOptions(m_acceptor.native_handle(), m_options.socketOptions);
+    m_acceptor.bind({protocol, port});
+    m_acceptor.listen(boost::asio::socket_base::max_connections);
+  } catch (const std::exception &e) {
+    EXAMPLE_LOG_ERROR("Awaitable Server Listen exception: ", e.what());
+    return false;
+  }
+  return true;
+}
+
+boost::asio::awaitable<AwaitableConnection> AwaitableServer::accept() {
+  auto socket = co_await m_acceptor.async_accept(boost::asio::use_awaitable);
+  co_return AwaitableConnection{std::move(socket), m_framing, m_options};
+}
+
+void AwaitableServer::close() {
+  boost::system::error_code error;
+  m_acceptor.close(error);
+  if (error) {
+    EXAMPLE_LOG_ERROR("Awaitable Server Close error: ", error.message());
+  }
+}
+}  // namespace example
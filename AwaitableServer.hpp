@@ -0,0 +1,48 @@
+#ifndef EXAMPLE_AWAITABLE_SERVER_HPP
+#define EXAMPLE_AWAITABLE_SERVER_HPP
+
+#include "AwaitableConnection.hpp"
+
+namespace example {
+/**
+ * AwaitableServer class accepts TCP connections through C++20 coroutines.
+ */
+class AwaitableServer {
+ public:
+  /**
+   * Constructs an AwaitableServer object.
+   *
+   * @param ioContext required for asynchronous input and output operations.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  AwaitableServer(boost::asio::io_context &ioContext,
+                  const Framing &framing = Framing::text(),
+                  const ConnectionOptions &options = {});
+  /**
+   * listen for connections at any interface with specified
+   * protocol to specified port.
+   *
+   * @param protocol of the interfaces to listen at.
+   * @param port to listen to.
+   */
+  bool listen(const boost::asio::ip::tcp &protocol, uint16_t port);
+  /**
+   * accepts next connection.
+   *
+   * @return connection accepted.
+   */
+  boost::asio::awaitable<AwaitableConnection> accept();
+  /**
+   * stops accepting connections, cancelling pending accept operations.
+   */
+  void close();
+
+ private:
+  boost::asio::ip::tcp::acceptor m_acceptor;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,200 @@
+#include "BufferRing.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "Logging.hpp"
+
+namespace {
+constexpr unsigned f_queueDepth{256};
+constexpr int f_bufferGroup{0};
+}  // namespace
+
+namespace example {
+boost::asio::io_context::id BufferRing::id;
+
+BufferRing &BufferRing::of(boost::asio::io_context &ioContext) {
+  return boost::asio::use_service<BufferRing>(ioContext);
+}
+
+BufferRing::BufferRing(boost::asio::io_context &ioContext)
+    : boost::asio::io_context::service{ioContext},
+      m_ring{},
+      m_bufferRing{nullptr},
+      m_buffers(size_t{bufferCount} * bufferSize),
+      m_event{ioContext},
+      m_receives{},
+      m_nextReceiveId{1},
+      m_eventCount{0},
+      m_isAvailable{false} {
+  auto result = io_uring_queue_init(f_queueDepth, &m_ring, 0);
+  if (result < 0) {
+    EXAMPLE_LOG_ERROR("Buffer Ring Init error: ", std::strerror(-result));
+    return;
+  }
+  m_bufferRing = io_uring_setup_buf_ring(&m_ring, bufferCount, f_bufferGroup,
+                                         0, &result);
+  if (!m_bufferRing) {
+    EXAMPLE_LOG_ERROR("Buffer Ring Init error: ", std::strerror(-result));
+    io_uring_queue_exit(&m_ring);
+    return;
+  }
+  for (unsigned i = 0; i < bufferCount; i++) {
+    io_uring_buf_ring_add(m_bufferRing, m_buffers.data() + i * bufferSize,
+                          bufferSize, i, io_uring_buf_ring_mask(bufferCount),
+                          i);
+  }
+  io_uring_buf_ring_advance(m_bufferRing, bufferCount);
+  auto event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event < 0 || io_uring_register_eventfd(&m_ring, event) < 0) {
+    EXAMPLE_LOG_ERROR("Buffer Ring Init error: ", std::strerror(errno));
+    if (event >= 0) {
+      ::close(event);
+    }
+    io_uring_free_buf_ring(&m_ring, m_bufferRing, bufferCount, f_bufferGroup);
+    io_uring_queue_exit(&m_ring);
+    return;
+  }
+  m_event.assign(event);
+  m_isAvailable = true;
+  wait();
+}
+
+BufferRing::~BufferRing() {
+  if (m_isAvailable) {
+    io_uring_free_buf_ring(&m_ring, m_bufferRing, bufferCount, f_bufferGroup);
+    io_uring_queue_exit(&m_ring);
+  }
+}
+
+uint64_t BufferRing::receive(int socket, Handler handler) {
+  if (!m_isAvailable) {
+    return 0;
+  }
+  auto receiveId = m_nextReceiveId++;
+  if (!submitReceive(receiveId, socket)) {
+    return 0;
+  }
+  m_receives.emplace(receiveId, Receive{socket, std::move(handler)});
+  return receiveId;
+}
+
+void BufferRing::cancel(uint64_t receiveId) {
+  if (m_receives.erase(receiveId) == 0) {
+    return;
+  }
+  auto sqe = io_uring_get_sqe(&m_ring);
+  if (!sqe) {
+    io_uring_submit(&m_ring);
+    sqe = io_uring_get_sqe(&m_ring);
+  }
+  if (sqe) {
+    io_uring_prep_cancel64(sqe, receiveId, 0);
+    io_uring_sqe_set_data64(sqe, 0);
+    io_uring_submit(&m_ring);
+  }
+}
+
+void BufferRing::shutdown() {
+  m_receives.clear();
+  boost::system::error_code error;
+  m_event.close(error);
+}
+
+bool BufferRing::submitReceive(uint64_t receiveId, int socket) {
+  auto sqe = io_uring_get_sqe(&m_ring);
+  if (!sqe) {
+    io_uring_submit(&m_ring);
+    sqe = io_uring_get_sqe(&m_ring);
+  }
+  if (!sqe) {
+    EXAMPLE_LOG_ERROR("Buffer Ring Receive error: submission queue full");
+    return false;
+  }
+  io_uring_prep_recv_multishot(sqe, socket, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = f_bufferGroup;
+  io_uring_sqe_set_data64(sqe, receiveId);
+  auto result = io_uring_submit(&m_ring);
+  if (result < 0) {
+    EXAMPLE_LOG_ERROR("Buffer Ring Receive error: ", std::strerror(-result));
+    return false;
+  }
+  return true;
+}
+
+void BufferRing::wait() {
+  m_event.async_wait(boost::asio::posix::descriptor_base::wait_read,
+                     [this](const auto &error) {
+                       if (error) {
+                         return;
+                       }
+                       if (::read(m_event.native_handle(), &m_eventCount,
+                                  sizeof(m_eventCount)) < 0 &&
+                           errno != EAGAIN) {
+                         EXAMPLE_LOG_ERROR("Buffer Ring Wait error: ",
+                                           std::strerror(errno));
+                       }
+                       reap();
+                       wait();
+                     });
+}
+
+void BufferRing::reap() {
+  io_uring_cqe *entry;
+  while (io_uring_peek_cqe(&m_ring, &entry) == 0) {
+    // handlers can submit and cancel receives, so the entry is copied and
+    // marked as seen first.
+    auto cqe = *entry;
+    io_uring_cqe_seen(&m_ring, entry);
+    complete(cqe);
+  }
+}
+
+void BufferRing::complete(const io_uring_cqe &cqe) {
+  auto receiveId = cqe.user_data;
+  const char *data{nullptr};
+  unsigned bufferId{0};
+  if (cqe.flags & IORING_CQE_F_BUFFER) {
+    bufferId = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+    data = m_buffers.data() + size_t{bufferId} * bufferSize;
+  }
+  auto receive = m_receives.find(receiveId);
+  auto isArmed = (cqe.flags & IORING_CQE_F_MORE) != 0;
+  if (receive != m_receives.end()) {
+    if (cqe.res == -ENOBUFS) {
+      // every buffer was in use, the receive is armed again below once
+      // they have been given back.
+    } else {
+      // the handler can cancel its own receive, and release the last
+      // reference to its owner, so it is moved out while it is called.
+      auto handler = std::move(receive->second.handler);
+      handler(cqe.res, data);
+      receive = m_receives.find(receiveId);
+      if (receive != m_receives.end()) {
+        receive->second.handler = std::move(handler);
+      }
+    }
+  }
+  if (data) {
+    io_uring_buf_ring_add(m_bufferRing, const_cast<char *>(data), bufferSize,
+                          bufferId, io_uring_buf_ring_mask(bufferCount), 0);
+    io_uring_buf_ring_advance(m_bufferRing, 1);
+  }
+  if (receive == m_receives.end() || isArmed) {
+    return;
+  }
+  if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+    if (!submitReceive(receiveId, receive->second.socket)) {
+      auto handler = std::move(receive->second.handler);
+      m_receives.erase(receive);
+      handler(-ENOBUFS, nullptr);
+    }
+  } else {
+    m_receives.erase(receive);
+  }
+}
+}  // namespace example
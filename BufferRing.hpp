@@ -0,0 +1,96 @@
+#ifndef EXAMPLE_BUFFER_RING_HPP
+#define EXAMPLE_BUFFER_RING_HPP
+
+#include <liburing.h>
+
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace example {
+/**
+ * BufferRing class receives from stream sockets through an io_uring with a
+ * ring of provided buffers registered with the kernel. Each socket has a
+ * single multishot receive armed, which keeps completing into the next free
+ * buffer of the ring without any further submission, so that receiving does
+ * not make a system call per read. Completions are signalled through an
+ * eventfd waited for by the io_context. It is an io_context service, only
+ * built with `-DEXAMPLE_IO_URING=ON`, and must only be used from the threads
+ * running that io_context.
+ */
+class BufferRing : public boost::asio::io_context::service {
+ public:
+  /**
+   * Handler type called with the result of each receive: number of bytes
+   * received into data, zero at end of stream or a negated errno. Data is
+   * valid only during the call.
+   */
+  using Handler = std::function<void(int result, const char *data)>;
+  /**
+   * number of buffers of the ring.
+   */
+  static constexpr unsigned bufferCount{256};
+  /**
+   * size in bytes of each buffer of the ring.
+   */
+  static constexpr unsigned bufferSize{65536};
+  /**
+   * identifier of the service.
+   */
+  static boost::asio::io_context::id id;
+  /**
+   * returns the BufferRing of specified io_context, creating it if needed.
+   *
+   * @param ioContext waiting for completions.
+   */
+  static BufferRing &of(boost::asio::io_context &ioContext);
+  /**
+   * Constructs a BufferRing object. Use of() instead.
+   *
+   * @param ioContext waiting for completions.
+   */
+  explicit BufferRing(boost::asio::io_context &ioContext);
+  ~BufferRing() override;
+  /**
+   * starts receiving from specified socket until cancelled or until the
+   * handler is called with a result that is not positive.
+   *
+   * @param socket native handle of a connected stream socket.
+   * @param handler called with each receive.
+   * @return identifier of the receive, or zero if the ring is not available
+   * or the receive could not be submitted.
+   */
+  uint64_t receive(int socket, Handler handler);
+  /**
+   * stops a receive. Its handler is not called again.
+   *
+   * @param receiveId identifier returned by receive().
+   */
+  void cancel(uint64_t receiveId);
+
+ private:
+  struct Receive {
+    int socket;
+    Handler handler;
+  };
+
+  void shutdown() override;
+  bool submitReceive(uint64_t receiveId, int socket);
+  void wait();
+  void reap();
+  void complete(const io_uring_cqe &cqe);
+
+  io_uring m_ring;
+  io_uring_buf_ring *m_bufferRing;
+  std::vector<char> m_buffers;
+  boost::asio::posix::stream_descriptor m_event;
+  std::unordered_map<uint64_t, Receive> m_receives;
+  uint64_t m_nextReceiveId;
+  uint64_t m_eventCount;
+  bool m_isAvailable;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,224 @@
+#include "Codec.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef EXAMPLE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef EXAMPLE_LZ4
+#include <lz4.h>
+#endif
+
+#include "Logging.hpp"
+
+namespace {
+#ifdef EXAMPLE_ZLIB
+constexpr uint8_t f_zlibId{1};
+
+struct ZlibStreams {
+  ~ZlibStreams() {
+    if (isDeflaterReady) {
+      deflateEnd(&deflater);
+    }
+    if (isInflaterReady) {
+      inflateEnd(&inflater);
+    }
+  }
+
+  z_stream deflater{};
+  z_stream inflater{};
+  bool isDeflaterReady{false};
+  bool isInflaterReady{false};
+};
+
+thread_local ZlibStreams f_zlibStreams;
+
+class ZlibCodec : public example::Codec {
+ public:
+  uint8_t id() const override { return f_zlibId; }
+
+ protected:
+  size_t maxBlockSize(size_t size) const override {
+    return compressBound(static_cast<uLong>(size));
+  }
+
+  size_t maxOriginalSize(size_t size) const override {
+    // deflate expands at most 1032 times: a 258-byte match in 2 bits.
+    return size * 1032;
+  }
+
+  size_t compressBlock(const char *data, size_t size, char *output,
+                       size_t capacity) const override {
+    auto &streams = f_zlibStreams;
+    if (!streams.isDeflaterReady) {
+      auto result = deflateInit(&streams.deflater, Z_BEST_SPEED);
+      if (result != Z_OK) {
+        EXAMPLE_LOG_ERROR("Codec Compress error: ", zError(result));
+        return 0;
+      }
+      streams.isDeflaterReady = true;
+    }
+    auto &stream = streams.deflater;
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef *>(output);
+    stream.avail_out = static_cast<uInt>(capacity);
+    auto result = deflate(&stream, Z_FINISH);
+    auto compressedSize = stream.total_out;
+    deflateReset(&stream);
+    return result == Z_STREAM_END ? compressedSize : 0;
+  }
+
+  bool decompressBlock(const char *data, size_t size, char *output,
+                       size_t outputSize) const override {
+    auto &streams = f_zlibStreams;
+    if (!streams.isInflaterReady) {
+      auto result = inflateInit(&streams.inflater);
+      if (result != Z_OK) {
+        EXAMPLE_LOG_ERROR("Codec Decompress error: ", zError(result));
+        return false;
+      }
+      streams.isInflaterReady = true;
+    }
+    auto &stream = streams.inflater;
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef *>(output);
+    stream.avail_out = static_cast<uInt>(outputSize);
+    auto result = inflate(&stream, Z_FINISH);
+    auto isComplete = result == Z_STREAM_END && stream.avail_in == 0 &&
+                      stream.total_out == outputSize;
+    inflateReset(&stream);
+    return isComplete;
+  }
+};
+#endif
+
+#ifdef EXAMPLE_LZ4
+constexpr uint8_t f_lz4Id{2};
+
+class Lz4Codec : public example::Codec {
+ public:
+  uint8_t id() const override { return f_lz4Id; }
+
+ protected:
+  size_t maxBlockSize(size_t size) const override {
+    return size > LZ4_MAX_INPUT_SIZE
+               ? 0
+               : LZ4_compressBound(static_cast<int>(size));
+  }
+
+  size_t maxOriginalSize(size_t size) const override {
+    // each byte extending a match length adds at most 255 bytes.
+    return size * 255;
+  }
+
+  size_t compressBlock(const char *data, size_t size, char *output,
+                       size_t capacity) const override {
+    if (size > LZ4_MAX_INPUT_SIZE) {
+      return 0;
+    }
+    auto result = LZ4_compress_default(
+        data, output, static_cast<int>(size),
+        static_cast<int>(std::min<size_t>(
+            capacity, std::numeric_limits<int>::max())));
+    return result > 0 ? static_cast<size_t>(result) : 0;
+  }
+
+  bool decompressBlock(const char *data, size_t size, char *output,
+                       size_t outputSize) const override {
+    if (size > std::numeric_limits<int>::max() ||
+        outputSize > std::numeric_limits<int>::max()) {
+      return false;
+    }
+    auto result =
+        LZ4_decompress_safe(data, output, static_cast<int>(size),
+                            static_cast<int>(outputSize));
+    return result >= 0 && static_cast<size_t>(result) == outputSize;
+  }
+};
+#endif
+}  // namespace
+
+namespace example {
+const Codec *Codec::zlib() {
+#ifdef EXAMPLE_ZLIB
+  static const ZlibCodec codec;
+  return &codec;
+#else
+  return nullptr;
+#endif
+}
+
+const Codec *Codec::lz4() {
+#ifdef EXAMPLE_LZ4
+  static const Lz4Codec codec;
+  return &codec;
+#else
+  return nullptr;
+#endif
+}
+
+const Codec *Codec::of(std::string_view compressed, const Codec *codec) {
+  if (compressed.empty()) {
+    return nullptr;
+  }
+  auto id = static_cast<uint8_t>(compressed[0]);
+  if (codec && codec->id() == id) {
+    return codec;
+  }
+  for (auto builtInCodec : {zlib(), lz4()}) {
+    if (builtInCodec && builtInCodec->id() == id) {
+      return builtInCodec;
+    }
+  }
+  return nullptr;
+}
+
+bool Codec::compress(std::string_view message,
+                     std::string &compressed) const {
+  if (message.size() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  auto maxSize = maxBlockSize(message.size());
+  if (maxSize == 0) {
+    return false;
+  }
+  compressed.resize(headerSize + maxSize);
+  auto size = compressBlock(message.data(), message.size(),
+                            compressed.data() + headerSize, maxSize);
+  if (size == 0 || headerSize + size >= message.size()) {
+    compressed.clear();
+    return false;
+  }
+  auto messageSize = static_cast<uint32_t>(message.size());
+  compressed[0] = static_cast<char>(id());
+  compressed[1] = static_cast<char>(messageSize);
+  compressed[2] = static_cast<char>(messageSize >> 8);
+  compressed[3] = static_cast<char>(messageSize >> 16);
+  compressed[4] = static_cast<char>(messageSize >> 24);
+  compressed.resize(headerSize + size);
+  return true;
+}
+
+bool Codec::decompress(std::string_view compressed, size_t maxSize,
+                       std::string &message) const {
+  if (compressed.size() < headerSize ||
+      static_cast<uint8_t>(compressed[0]) != id()) {
+    return false;
+  }
+  auto bytes = reinterpret_cast<const uint8_t *>(compressed.data());
+  size_t size = static_cast<uint32_t>(bytes[1]) |
+                static_cast<uint32_t>(bytes[2]) << 8 |
+                static_cast<uint32_t>(bytes[3]) << 16 |
+                static_cast<uint32_t>(bytes[4]) << 24;
+  auto blockSize = compressed.size() - headerSize;
+  if (size > maxSize || size > maxOriginalSize(blockSize)) {
+    return false;
+  }
+  message.resize(size);
+  return decompressBlock(compressed.data() + headerSize, blockSize,
+                         message.data(), size);
+}
+}  // namespace example
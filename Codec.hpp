@@ -0,0 +1,113 @@
+#ifndef EXAMPLE_CODEC_HPP
+#define EXAMPLE_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace example {
+/**
+ * Codec class compresses message payloads. A compressed payload begins with
+ * a header holding the identifier of the codec and the size of the original
+ * payload, so that a receiver can pick the codec that decompresses it.
+ * Implementations keep their compression state per thread and reuse it for
+ * every message, so that compressing does not allocate in steady state.
+ * Codecs are stateless otherwise and can be shared by every connection.
+ */
+class Codec {
+ public:
+  /**
+   * size in bytes of the header of a compressed payload: the codec
+   * identifier followed by the 4-byte little-endian original size.
+   */
+  static constexpr size_t headerSize{5};
+  /**
+   * Returns the zlib codec, tuned for speed, or nullptr if the library was
+   * not found at build time.
+   */
+  static const Codec *zlib();
+  /**
+   * Returns the LZ4 codec, or nullptr if the library was not found at build
+   * time.
+   */
+  static const Codec *lz4();
+  /**
+   * Returns the codec that decompresses a compressed payload.
+   *
+   * @param compressed payload.
+   * @param codec tried before the built-in codecs, or nullptr.
+   * @return codec whose identifier begins the payload, or nullptr if none.
+   */
+  static const Codec *of(std::string_view compressed,
+                         const Codec *codec = nullptr);
+
+  virtual ~Codec() = default;
+  /**
+   * returns identifier written in the header of compressed payloads. The
+   * built-in codecs use identifiers below 128.
+   */
+  virtual uint8_t id() const = 0;
+  /**
+   * compresses a payload.
+   *
+   * @param message payload to compress.
+   * @param compressed buffer replaced with the header and the compressed
+   * payload.
+   * @return false if the payload cannot be compressed or does not become
+   * smaller, in which case it is to be sent as is.
+   */
+  bool compress(std::string_view message, std::string &compressed) const;
+  /**
+   * decompresses a payload returned by compress().
+   *
+   * @param compressed payload.
+   * @param maxSize in bytes of the original payload.
+   * @param message buffer replaced with the original payload.
+   * @return false if the payload is invalid or larger than maxSize, or if
+   * its header claims a size the compressed bytes cannot expand to, which is
+   * checked before any memory is allocated for it.
+   */
+  bool decompress(std::string_view compressed, size_t maxSize,
+                  std::string &message) const;
+
+ protected:
+  /**
+   * returns maximum number of bytes compressBlock() writes for a payload.
+   *
+   * @param size of the payload in bytes.
+   */
+  virtual size_t maxBlockSize(size_t size) const = 0;
+  /**
+   * returns maximum size in bytes of the payload that decompressBlock() can
+   * produce from a compressed payload.
+   *
+   * @param size of the compressed payload in bytes.
+   */
+  virtual size_t maxOriginalSize(size_t size) const = 0;
+  /**
+   * compresses a payload.
+   *
+   * @param data of the payload.
+   * @param size of the payload in bytes.
+   * @param output buffer of at least maxBlockSize(size) bytes.
+   * @param capacity of output in bytes.
+   * @return number of bytes written to output, or zero on error.
+   */
+  virtual size_t compressBlock(const char *data, size_t size, char *output,
+                               size_t capacity) const = 0;
+  /**
+   * decompresses a payload written by compressBlock().
+   *
+   * @param data of the compressed payload.
+   * @param size of the compressed payload in bytes.
+   * @param output buffer of the original payload size.
+   * @param outputSize in bytes of the original payload.
+   * @return false if the payload is invalid.
+   */
+  virtual bool decompressBlock(const char *data, size_t size, char *output,
+                               size_t outputSize) const = 0;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef EXAMPLE_CONNECTION_OPTIONS_HPP
+#define EXAMPLE_CONNECTION_OPTIONS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include "Codec.hpp"
+#include "SocketOptions.hpp"
+#include "TokenBucket.hpp"
+
+namespace example {
+/**
+ * ConnectionOptions struct configures the connections of a server or a
+ * client.
+ */
+struct ConnectionOptions {
+  /**
+   * number of pending bytes at which the send queue is full: onSendQueueHigh
+   * is notified when it is reached, and further sends are rejected.
+   */
+  size_t sendQueueHighWatermark{std::numeric_limits<size_t>::max()};
+  /**
+   * number of pending bytes at which onWritable is notified after the send
+   * queue has been full.
+   */
+  size_t sendQueueLowWatermark{0};
+  /**
+   * options applied to the socket of every connection.
+   */
+  SocketOptions socketOptions{};
+  /**
+   * receive TCP and Unix domain connections through the BufferRing of their
+   * io_context instead of a read operation per batch. It is ignored unless
+   * built with `-DEXAMPLE_IO_URING=ON`.
+   */
+  bool bufferRing{false};
+  /**
+   * size in bytes of the chunks that sent payloads larger than it are split
+   * into, so that messages of higher priority can be written between two
+   * chunks, or zero to write every payload whole. Only framings carrying
+   * flags, such as the binary framing, support chunks; receivers always
+   * reassemble them.
+   */
+  size_t writeChunkSize{0};
+  /**
+   * codec compressing the messages sent by TCP and Unix domain connections,
+   * such as Codec::zlib(), or nullptr to send them as is. Only framings
+   * carrying flags, such as the binary framing, support it; receivers always
+   * decompress messages of the built-in codecs.
+   */
+  const Codec *codec{nullptr};
+  /**
+   * size in bytes from which messages are compressed by the codec. Smaller
+   * messages, and messages that do not become smaller, are sent as is.
+   */
+  size_t compressionThreshold{1024};
+  /**
+   * largest size in bytes of a received message once decompressed. A
+   * compressed message claiming a larger size is invalid and closes the
+   * connection.
+   */
+  size_t maxDecompressedSize{64 << 20};
+  /**
+   * size in bytes from which a message received by a TCP or Unix domain
+   * connection is streamed, through onMessageBegin(), onMessageChunk() and
+   * onMessageEnd() as its bytes arrive, instead of being buffered whole, or
+   * zero to buffer every message.
+   */
+  size_t streamingThreshold{0};
+  /**
+   * capacity in bytes of each ring of a shared memory connection, rounded up
+   * to a power of two. The capacity chosen by the server is used by both
+   * sides.
+   */
+  size_t sharedMemoryRingSize{1 << 20};
+  /**
+   * time a shared memory connection keeps polling its receive ring after it
+   * becomes empty, before waiting for a notification from the peer. Polling
+   * avoids the wakeup latency at the cost of a busy io thread.
+   */
+  std::chrono::nanoseconds busyPollDuration{0};
+  /**
+   * number of messages per second a TCP or Unix domain connection receives
+   * on average, and largest burst. Once exceeded, the connection stops
+   * reading, so that the kernel pushes back on the peer, until enough time
+   * has passed; no message is dropped.
+   */
+  RateLimit receiveMessageLimit{};
+  /**
+   * number of bytes per second a TCP or Unix domain connection receives on
+   * average, and largest burst, enforced like receiveMessageLimit.
+   */
+  RateLimit receiveByteLimit{};
+  /**
+   * time without bytes received or sent after which a TCP connection is
+   * closed, or zero to disable it.
+   */
+  std::chrono::nanoseconds idleTimeout{0};
+  /**
+   * time without bytes received after which a TCP connection is closed, or
+   * zero to disable it.
+   */
+  std::chrono::nanoseconds readTimeout{0};
+  /**
+   * time a TCP connection with bytes pending to be sent can go without
+   * writing any of them before it is closed, or zero to disable it.
+   */
+  std::chrono::nanoseconds writeTimeout{0};
+};
+}  // namespace example
+
+#endif
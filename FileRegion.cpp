@@ -0,0 +1,47 @@
+#include "FileRegion.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "Logging.hpp"
+
+namespace example {
+std::shared_ptr<const FileRegion> FileRegion::open(const std::string &path,
+                                                   uint64_t offset,
+                                                   size_t size) {
+  auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    EXAMPLE_LOG_ERROR("File Region Open error: ", path, ": ",
+                      std::strerror(errno));
+    return nullptr;
+  }
+  auto region = std::make_shared<const FileRegion>(file, offset, size);
+  struct stat status;
+  if (fstat(file, &status) < 0) {
+    EXAMPLE_LOG_ERROR("File Region Open error: ", path, ": ",
+                      std::strerror(errno));
+    return nullptr;
+  }
+  if (offset + size > static_cast<uint64_t>(status.st_size)) {
+    EXAMPLE_LOG_ERROR("File Region Open error: ", path,
+                      ": range exceeds file size");
+    return nullptr;
+  }
+  return region;
+}
+
+FileRegion::FileRegion(int file, uint64_t offset, size_t size)
+    : m_file{file}, m_offset{offset}, m_size{size} {}
+
+FileRegion::~FileRegion() { ::close(m_file); }
+
+int FileRegion::file() const { return m_file; }
+
+uint64_t FileRegion::offset() const { return m_offset; }
+
+size_t FileRegion::size() const { return m_size; }
+}  // namespace example
@@ -0,0 +1,62 @@
+#ifndef EXAMPLE_FILE_REGION_HPP
+#define EXAMPLE_FILE_REGION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace example {
+/**
+ * FileRegion class holds an open file and a range of its bytes to be sent as
+ * a message payload. Bytes are sent straight from the page cache to the
+ * socket, without being copied through user space, and reading them does not
+ * move the file position, so a region can be shared by several sends.
+ */
+class FileRegion {
+ public:
+  /**
+   * opens specified range of a file.
+   *
+   * @param path of the file.
+   * @param offset of the first byte of the range.
+   * @param size of the range in bytes.
+   * @return region, or nullptr if the file cannot be opened or is shorter
+   * than the range.
+   */
+  static std::shared_ptr<const FileRegion> open(const std::string &path,
+                                                uint64_t offset, size_t size);
+  /**
+   * Constructs a FileRegion object. Use open() instead.
+   *
+   * @param file descriptor owned by the FileRegion.
+   * @param offset of the first byte of the range.
+   * @param size of the range in bytes.
+   */
+  FileRegion(int file, uint64_t offset, size_t size);
+  FileRegion(const FileRegion &) = delete;
+  FileRegion &operator=(const FileRegion &) = delete;
+  /**
+   * Destroys the FileRegion object, closing the file.
+   */
+  ~FileRegion();
+  /**
+   * returns file descriptor.
+   */
+  int file() const;
+  /**
+   * returns offset of the first byte of the range.
+   */
+  uint64_t offset() const;
+  /**
+   * returns size of the range in bytes.
+   */
+  size_t size() const;
+
+ private:
+  int m_file;
+  uint64_t m_offset;
+  size_t m_size;
+};
+}  // namespace example
+
+#endif
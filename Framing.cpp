@@ -0,0 +1,83 @@
+#include "Framing.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+constexpr char f_textHeaderSeparator{';'};
+constexpr size_t f_textHeaderMaxSize{21};
+constexpr size_t f_binaryHeaderSize{5};
+
+class TextFraming : public example::Framing {
+ public:
+  size_t encode(const example::FrameHeader &header,
+                char *buffer) const override {
+    auto result = std::to_chars(buffer, buffer + maxHeaderSize, header.size);
+    *result.ptr = f_textHeaderSeparator;
+    return result.ptr - buffer + 1;
+  }
+
+  bool decode(const char *data, size_t size, example::FrameHeader &header,
+              size_t &headerSize) const override {
+    headerSize = 0;
+    auto end = data + std::min(size, f_textHeaderMaxSize);
+    auto separator = std::find(data, end, f_textHeaderSeparator);
+    if (separator == end) {
+      return size < f_textHeaderMaxSize;
+    }
+    auto result = std::from_chars(data, separator, header.size);
+    if (result.ec != std::errc{} || result.ptr != separator) {
+      return false;
+    }
+    header.flags = 0;
+    headerSize = separator - data + 1;
+    return true;
+  }
+};
+
+class BinaryFraming : public example::Framing {
+ public:
+  size_t encode(const example::FrameHeader &header,
+                char *buffer) const override {
+    auto size = static_cast<uint32_t>(header.size);
+    buffer[0] = static_cast<char>(size);
+    buffer[1] = static_cast<char>(size >> 8);
+    buffer[2] = static_cast<char>(size >> 16);
+    buffer[3] = static_cast<char>(size >> 24);
+    buffer[4] = static_cast<char>(header.flags);
+    return f_binaryHeaderSize;
+  }
+
+  bool decode(const char *data, size_t size, example::FrameHeader &header,
+              size_t &headerSize) const override {
+    if (size < f_binaryHeaderSize) {
+      headerSize = 0;
+      return true;
+    }
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    header.size = static_cast<uint32_t>(bytes[0]) |
+                  static_cast<uint32_t>(bytes[1]) << 8 |
+                  static_cast<uint32_t>(bytes[2]) << 16 |
+                  static_cast<uint32_t>(bytes[3]) << 24;
+    header.flags = bytes[4];
+    headerSize = f_binaryHeaderSize;
+    return true;
+  }
+
+  bool hasFlags() const override { return true; }
+};
+}  // namespace
+
+namespace example {
+bool Framing::hasFlags() const { return false; }
+
+const Framing &Framing::text() {
+  static const TextFraming framing;
+  return framing;
+}
+
+const Framing &Framing::binary() {
+  static const BinaryFraming framing;
+  return framing;
+}
+}  // namespace example
@@ -0,0 +1,90 @@
+#ifndef EXAMPLE_FRAMING_HPP
+#define EXAMPLE_FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace example {
+/**
+ * FrameHeader struct describes the message that follows a frame header.
+ */
+struct FrameHeader {
+  /**
+   * flag of a frame holding a chunk of a message, in the lane given by the
+   * flags masked by laneMask.
+   */
+  static constexpr uint8_t chunkFlag{0x04};
+  /**
+   * flag of a frame holding the last chunk of a message.
+   */
+  static constexpr uint8_t lastChunkFlag{0x08};
+  /**
+   * mask of the flags holding the lane of a chunk.
+   */
+  static constexpr uint8_t laneMask{0x03};
+  /**
+   * flag of a frame holding a message compressed by a Codec. Every chunk of
+   * a compressed message carries it.
+   */
+  static constexpr uint8_t compressedFlag{0x10};
+  /**
+   * size in bytes of the message.
+   */
+  size_t size;
+  /**
+   * bit flags qualifying the message.
+   */
+  uint8_t flags;
+};
+/**
+ * Framing class encodes and decodes the headers delimiting messages within
+ * a connection byte stream.
+ */
+class Framing {
+ public:
+  /**
+   * maximum number of bytes any Framing implementation encodes per header.
+   */
+  static constexpr size_t maxHeaderSize{24};
+  /**
+   * Returns the legacy text framing, where headers are formatted as the
+   * decimal message size followed by the ';' separator. Flags are not
+   * transmitted.
+   */
+  static const Framing &text();
+  /**
+   * Returns the binary framing, where headers are formatted as a 4-byte
+   * little-endian message size followed by a flags byte.
+   */
+  static const Framing &binary();
+
+  virtual ~Framing() = default;
+  /**
+   * Encodes a header.
+   *
+   * @param header to encode.
+   * @param buffer of at least maxHeaderSize bytes to write the header to.
+   * @return number of bytes written to buffer.
+   */
+  virtual size_t encode(const FrameHeader &header, char *buffer) const = 0;
+  /**
+   * Decodes a header from the beginning of a buffer.
+   *
+   * @param data beginning of the buffer.
+   * @param size of the buffer.
+   * @param header decoded.
+   * @param headerSize number of bytes taken by the decoded header, or zero if
+   * the buffer does not hold a complete header yet.
+   * @return false if the buffer does not begin with a valid header.
+   */
+  virtual bool decode(const char *data, size_t size, FrameHeader &header,
+                      size_t &headerSize) const = 0;
+  /**
+   * returns true if headers transmit flags and have a fixed size, so that
+   * messages can be split into chunk frames. By default it returns false.
+   */
+  virtual bool hasFlags() const;
+};
+}  // namespace example
+
+#endif
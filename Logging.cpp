@@ -0,0 +1,149 @@
+#include "Logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+constexpr std::chrono::milliseconds f_maxWaitTime{10};
+}  // namespace
+
+namespace example {
+void LogSink::write(LogLevel level, std::string_view message) {
+  auto &stream = level >= LogLevel::Warning ? std::cerr : std::cout;
+  stream << message << '\n';
+}
+
+void LogSink::flush() { std::cout.flush(); }
+
+void Logger::setLevel(LogLevel level) {
+  s_level.store(level, std::memory_order_relaxed);
+}
+
+void Logger::setSink(LogSink *sink) {
+  auto &logger = instance();
+  logger.m_sink.store(sink ? sink : &logger.m_defaultSink,
+                      std::memory_order_release);
+}
+
+void Logger::flush() {
+  auto &logger = instance();
+  auto tail = logger.m_tail.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock{logger.m_mutex};
+  logger.m_condition.notify_one();
+  logger.m_flushCondition.wait(lock, [&logger, tail]() {
+    return logger.m_head.load(std::memory_order_acquire) >= tail;
+  });
+}
+
+uint64_t Logger::droppedCount() {
+  return instance().m_droppedCount.load(std::memory_order_relaxed);
+}
+
+void Logger::Record::append(std::string_view characters) {
+  auto count = std::min(characters.size(), recordTextSize - size);
+  std::copy_n(characters.data(), count, text.data() + size);
+  size += count;
+}
+
+Logger::Logger()
+    : m_records{},
+      m_tail{0},
+      m_head{0},
+      m_droppedCount{0},
+      m_sink{&m_defaultSink},
+      m_defaultSink{},
+      m_mutex{},
+      m_condition{},
+      m_flushCondition{},
+      m_isWaiting{false},
+      m_isStopping{false},
+      m_thread{} {
+  for (size_t i = 0; i < recordCount; i++) {
+    m_records[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  m_thread = std::thread{[this]() { run(); }};
+}
+
+Logger::~Logger() {
+  {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_isStopping = true;
+  }
+  m_condition.notify_one();
+  m_thread.join();
+}
+
+Logger &Logger::instance() {
+  static Logger logger;
+  return logger;
+}
+
+Logger::Record *Logger::claim() {
+  auto position = m_tail.load(std::memory_order_relaxed);
+  while (true) {
+    auto &record = m_records[position % recordCount];
+    auto sequence = record.sequence.load(std::memory_order_acquire);
+    auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+    if (difference == 0) {
+      if (m_tail.compare_exchange_weak(position, position + 1,
+                                       std::memory_order_relaxed)) {
+        record.position = position;
+        return &record;
+      }
+    } else if (difference < 0) {
+      m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    } else {
+      position = m_tail.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void Logger::publish(Record &record) {
+  record.sequence.store(record.position + 1, std::memory_order_release);
+  if (m_isWaiting.load(std::memory_order_relaxed) &&
+      m_isWaiting.exchange(false, std::memory_order_relaxed)) {
+    m_condition.notify_one();
+  }
+}
+
+void Logger::run() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    lock.unlock();
+    auto hasDrained = drain();
+    lock.lock();
+    if (hasDrained) {
+      m_flushCondition.notify_all();
+      continue;
+    }
+    if (m_isStopping) {
+      return;
+    }
+    m_isWaiting.store(true, std::memory_order_relaxed);
+    m_condition.wait_for(lock, f_maxWaitTime);
+    m_isWaiting.store(false, std::memory_order_relaxed);
+  }
+}
+
+bool Logger::drain() {
+  auto *sink = m_sink.load(std::memory_order_acquire);
+  auto head = m_head.load(std::memory_order_relaxed);
+  auto hasDrained = false;
+  while (true) {
+    auto &record = m_records[head % recordCount];
+    if (record.sequence.load(std::memory_order_acquire) != head + 1) {
+      break;
+    }
+    sink->write(record.level, {record.text.data(), record.size});
+    record.sequence.store(head + recordCount, std::memory_order_release);
+    m_head.store(++head, std::memory_order_release);
+    hasDrained = true;
+  }
+  if (hasDrained) {
+    sink->flush();
+  }
+  return hasDrained;
+}
+}  // namespace example
@@ -0,0 +1,168 @@
+#ifndef EXAMPLE_LOGGING_HPP
+#define EXAMPLE_LOGGING_HPP
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+/**
+ * lowest level of log messages compiled in: 0 debug, 1 info, 2 warning,
+ * 3 error, 4 none.
+ */
+#ifndef EXAMPLE_LOG_LEVEL
+#define EXAMPLE_LOG_LEVEL 0
+#endif
+
+/**
+ * logs a message made of the concatenation of the arguments, which can be
+ * strings, characters or integers. Arguments are not evaluated when the
+ * level is filtered out at compile time or at runtime.
+ */
+#define EXAMPLE_LOG(level, ...)                   \
+  do {                                            \
+    if (::example::Logger::isEnabled(level)) {    \
+      ::example::Logger::log(level, __VA_ARGS__); \
+    }                                             \
+  } while (false)
+#define EXAMPLE_LOG_DEBUG(...) \
+  EXAMPLE_LOG(::example::LogLevel::Debug, __VA_ARGS__)
+#define EXAMPLE_LOG_INFO(...) \
+  EXAMPLE_LOG(::example::LogLevel::Info, __VA_ARGS__)
+#define EXAMPLE_LOG_WARNING(...) \
+  EXAMPLE_LOG(::example::LogLevel::Warning, __VA_ARGS__)
+#define EXAMPLE_LOG_ERROR(...) \
+  EXAMPLE_LOG(::example::LogLevel::Error, __VA_ARGS__)
+
+namespace example {
+/**
+ * LogLevel enum specifies the severity of a log message.
+ */
+enum class LogLevel { Debug, Info, Warning, Error, None };
+/**
+ * LogSink class allows writing formatted log messages to a destination.
+ */
+struct LogSink {
+  /**
+   * virtual function called by the Logger thread for every message. By
+   * default warnings and errors are written to standard error and other
+   * messages to standard output.
+   *
+   * @param level of the message.
+   * @param message text, without line terminator.
+   */
+  virtual void write(LogLevel level, std::string_view message);
+  /**
+   * virtual function called by the Logger thread after writing the messages
+   * available. By default standard output is flushed.
+   */
+  virtual void flush();
+};
+/**
+ * Logger class queues log messages in a bounded lock-free ring and writes
+ * them from a background thread, so that logging threads never block on
+ * output. Messages are dropped when the ring is full.
+ */
+class Logger {
+ public:
+  /**
+   * returns true if messages of specified level are logged.
+   *
+   * @param level of the message.
+   */
+  static bool isEnabled(LogLevel level) {
+    return static_cast<int>(level) >= EXAMPLE_LOG_LEVEL &&
+           level < LogLevel::None &&
+           level >= s_level.load(std::memory_order_relaxed);
+  }
+  /**
+   * sets lowest level of logged messages. By default it is LogLevel::Info.
+   *
+   * @param level of the messages.
+   */
+  static void setLevel(LogLevel level);
+  /**
+   * sets destination of log messages.
+   *
+   * @param sink to write to, or nullptr to restore the default sink.
+   */
+  static void setSink(LogSink *sink);
+  /**
+   * queues a message made of the concatenation of the arguments.
+   *
+   * @param level of the message.
+   * @param args of the message.
+   */
+  template <typename... Args>
+  static void log(LogLevel level, const Args &...args) {
+    auto &logger = instance();
+    auto *record = logger.claim();
+    if (!record) {
+      return;
+    }
+    record->level = level;
+    record->size = 0;
+    (record->append(args), ...);
+    logger.publish(*record);
+  }
+  /**
+   * waits until every message queued has been written.
+   */
+  static void flush();
+  /**
+   * returns number of messages dropped because the ring was full.
+   */
+  static uint64_t droppedCount();
+
+ private:
+  static constexpr size_t recordCount{1024};
+  static constexpr size_t recordTextSize{240};
+
+  struct Record {
+    void append(std::string_view characters);
+    void append(const char *text) { append(std::string_view{text}); }
+    void append(char character) { append(std::string_view{&character, 1}); }
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    void append(T value) {
+      char buffer[24];
+      auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      append(std::string_view(buffer, result.ptr - buffer));
+    }
+
+    std::atomic<size_t> sequence;
+    size_t position;
+    LogLevel level;
+    size_t size;
+    std::array<char, recordTextSize> text;
+  };
+
+  Logger();
+  ~Logger();
+  static Logger &instance();
+  Record *claim();
+  void publish(Record &record);
+  void run();
+  bool drain();
+
+  inline static std::atomic<LogLevel> s_level{LogLevel::Info};
+  std::array<Record, recordCount> m_records;
+  std::atomic<size_t> m_tail;
+  std::atomic<size_t> m_head;
+  std::atomic<uint64_t> m_droppedCount;
+  std::atomic<LogSink *> m_sink;
+  LogSink m_defaultSink;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::condition_variable m_flushCondition;
+  std::atomic<bool> m_isWaiting;
+  bool m_isStopping;
+  std::thread m_thread;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,55 @@
+#include "Message.hpp"
+
+#include <algorithm>
+
+namespace example {
+SharedMessage::SharedMessage() : m_buffer{}, m_message{} {}
+
+SharedMessage::SharedMessage(std::shared_ptr<const char[]> buffer,
+                             std::string_view message)
+    : m_buffer{std::move(buffer)}, m_message{message} {}
+
+std::string_view SharedMessage::view() const { return m_message; }
+
+const char *SharedMessage::data() const { return m_message.data(); }
+
+size_t SharedMessage::size() const { return m_message.size(); }
+
+MessageView::MessageView(std::string_view message,
+                         const std::shared_ptr<char[]> *buffer)
+    : m_message{message}, m_buffer{buffer} {}
+
+std::string_view MessageView::view() const { return m_message; }
+
+const char *MessageView::data() const { return m_message.data(); }
+
+size_t MessageView::size() const { return m_message.size(); }
+
+std::string MessageView::str() const { return std::string{m_message}; }
+
+MessageView MessageView::suffix(size_t offset) const {
+  return {m_message.substr(offset), m_buffer};
+}
+
+SharedMessage MessageView::retain() const {
+  if (m_buffer) {
+    return {*m_buffer, m_message};
+  }
+  std::shared_ptr<char[]> buffer{new char[m_message.size()]};
+  std::copy(m_message.begin(), m_message.end(), buffer.get());
+  return {buffer, {buffer.get(), m_message.size()}};
+}
+
+MessageBatch::MessageBatch(const MessageView *begin, const MessageView *end)
+    : m_begin{begin}, m_end{end} {}
+
+const MessageView *MessageBatch::begin() const { return m_begin; }
+
+const MessageView *MessageBatch::end() const { return m_end; }
+
+size_t MessageBatch::size() const { return m_end - m_begin; }
+
+const MessageView &MessageBatch::operator[](size_t index) const {
+  return m_begin[index];
+}
+}  // namespace example
@@ -0,0 +1,148 @@
+#ifndef EXAMPLE_MESSAGE_HPP
+#define EXAMPLE_MESSAGE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace example {
+/**
+ * Buffer type holds message payloads that can be shared among several sends.
+ */
+using Buffer = std::string;
+/**
+ * Priority enum selects the lane a message is sent on. A connection always
+ * writes the next frame of the highest priority lane that is not empty.
+ */
+enum class Priority : uint8_t {
+  /** control messages, such as heartbeats and cancellations. */
+  High,
+  /** default lane. */
+  Normal,
+  /** bulk transfers. */
+  Low
+};
+/**
+ * SharedMessage class holds a received message by sharing ownership of the
+ * buffer it was received into, so it remains valid after the callback that
+ * delivered it returns.
+ */
+class SharedMessage {
+ public:
+  /**
+   * Constructs an empty SharedMessage object.
+   */
+  SharedMessage();
+  /**
+   * Constructs a SharedMessage object.
+   *
+   * @param buffer holding the message.
+   * @param message referencing a range of buffer.
+   */
+  SharedMessage(std::shared_ptr<const char[]> buffer, std::string_view message);
+  /**
+   * returns message contents.
+   */
+  std::string_view view() const;
+  /**
+   * returns pointer to first byte of the message.
+   */
+  const char *data() const;
+  /**
+   * returns message size in bytes.
+   */
+  size_t size() const;
+
+ private:
+  std::shared_ptr<const char[]> m_buffer;
+  std::string_view m_message;
+};
+/**
+ * MessageView class references a received message without copying it out of
+ * the connection receive buffer. It is only valid for the duration of the
+ * callback that delivers it.
+ */
+class MessageView {
+ public:
+  /**
+   * Constructs a MessageView object.
+   *
+   * @param message referencing a range of buffer.
+   * @param buffer holding the message, or nullptr if it cannot be shared.
+   */
+  MessageView(std::string_view message,
+              const std::shared_ptr<char[]> *buffer = nullptr);
+  /**
+   * returns message contents.
+   */
+  std::string_view view() const;
+  /**
+   * returns pointer to first byte of the message.
+   */
+  const char *data() const;
+  /**
+   * returns message size in bytes.
+   */
+  size_t size() const;
+  /**
+   * returns a copy of the message contents.
+   */
+  std::string str() const;
+  /**
+   * returns a view of the message contents following specified offset,
+   * sharing the receive buffer of the message.
+   *
+   * @param offset in bytes, not greater than the message size.
+   */
+  MessageView suffix(size_t offset) const;
+  /**
+   * returns a SharedMessage keeping the message valid after the callback
+   * returns. The connection then moves on to a new receive buffer, so no copy
+   * of the message is made.
+   */
+  SharedMessage retain() const;
+
+ private:
+  std::string_view m_message;
+  const std::shared_ptr<char[]> *m_buffer;
+};
+/**
+ * MessageBatch class references a contiguous sequence of received messages.
+ * It is only valid for the duration of the callback that delivers it.
+ */
+class MessageBatch {
+ public:
+  /**
+   * Constructs a MessageBatch object.
+   *
+   * @param begin first message of the sequence.
+   * @param end past the last message of the sequence.
+   */
+  MessageBatch(const MessageView *begin, const MessageView *end);
+  /**
+   * returns pointer to first message.
+   */
+  const MessageView *begin() const;
+  /**
+   * returns pointer past the last message.
+   */
+  const MessageView *end() const;
+  /**
+   * returns number of messages.
+   */
+  size_t size() const;
+  /**
+   * returns message at specified position.
+   *
+   * @param index of the message.
+   */
+  const MessageView &operator[](size_t index) const;
+
+ private:
+  const MessageView *m_begin;
+  const MessageView *m_end;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,231 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+
+namespace {
+constexpr auto f_relaxed{std::memory_order_relaxed};
+
+size_t bucketIndex(uint64_t durationNs) {
+  size_t index{0};
+  while (durationNs > 0 &&
+         index < example::LatencyHistogram::bucketCount - 1) {
+    durationNs >>= 1;
+    index++;
+  }
+  return index;
+}
+
+uint64_t bucketUpperBoundNs(size_t index) { return uint64_t{1} << index; }
+}  // namespace
+
+namespace example {
+std::chrono::nanoseconds LatencyHistogram::Snapshot::percentile(
+    double percentile) const {
+  if (count == 0) {
+    return {};
+  }
+  auto rank = static_cast<uint64_t>(percentile / 100 * count);
+  uint64_t accumulated{0};
+  for (size_t i = 0; i < bucketCount; i++) {
+    accumulated += buckets[i];
+    if (accumulated > rank || accumulated == count) {
+      return std::chrono::nanoseconds(bucketUpperBoundNs(i));
+    }
+  }
+  return std::chrono::nanoseconds(bucketUpperBoundNs(bucketCount - 1));
+}
+
+std::chrono::nanoseconds LatencyHistogram::Snapshot::mean() const {
+  return std::chrono::nanoseconds(count > 0 ? sumNs / count : 0);
+}
+
+LatencyHistogram::Snapshot &LatencyHistogram::Snapshot::operator+=(
+    const Snapshot &other) {
+  for (size_t i = 0; i < bucketCount; i++) {
+    buckets[i] += other.buckets[i];
+  }
+  count += other.count;
+  sumNs += other.sumNs;
+  return *this;
+}
+
+LatencyHistogram::LatencyHistogram() : m_buckets{}, m_sumNs{0} {}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+  auto durationNs =
+      static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+  m_buckets[bucketIndex(durationNs)].fetch_add(1, f_relaxed);
+  m_sumNs.fetch_add(durationNs, f_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot snapshot;
+  for (size_t i = 0; i < bucketCount; i++) {
+    snapshot.buckets[i] = m_buckets[i].load(f_relaxed);
+    snapshot.count += snapshot.buckets[i];
+  }
+  snapshot.sumNs = m_sumNs.load(f_relaxed);
+  return snapshot;
+}
+
+ServerStats &ServerStats::operator+=(const ServerStats &other) {
+  bytesReceived += other.bytesReceived;
+  messagesReceived += other.messagesReceived;
+  reads += other.reads;
+  bytesSent += other.bytesSent;
+  messagesSent += other.messagesSent;
+  writes += other.writes;
+  partialWrites += other.partialWrites;
+  pendingBytes += other.pendingBytes;
+  sendLatency += other.sendLatency;
+  connectionsAccepted += other.connectionsAccepted;
+  connectionsClosed += other.connectionsClosed;
+  acceptErrors += other.acceptErrors;
+  activeConnections += other.activeConnections;
+  uptime = std::max(uptime, other.uptime);
+  connectionLifetime += other.connectionLifetime;
+  return *this;
+}
+
+TrafficMetrics::TrafficMetrics(TrafficMetrics *parent)
+    : m_parent{parent},
+      m_bytesReceived{0},
+      m_messagesReceived{0},
+      m_reads{0},
+      m_bytesSent{0},
+      m_messagesSent{0},
+      m_writes{0},
+      m_partialWrites{0},
+      m_sendLatency{} {}
+
+void TrafficMetrics::recordReceived(size_t bytes, size_t messages) {
+  m_bytesReceived.fetch_add(bytes, f_relaxed);
+  m_messagesReceived.fetch_add(messages, f_relaxed);
+  m_reads.fetch_add(1, f_relaxed);
+  if (m_parent) {
+    m_parent->recordReceived(bytes, messages);
+  }
+}
+
+void TrafficMetrics::recordWritten(size_t bytes, size_t pendingBytes) {
+  m_bytesSent.fetch_add(bytes, f_relaxed);
+  m_writes.fetch_add(1, f_relaxed);
+  if (bytes < pendingBytes) {
+    m_partialWrites.fetch_add(1, f_relaxed);
+  }
+  if (m_parent) {
+    m_parent->recordWritten(bytes, pendingBytes);
+  }
+}
+
+void TrafficMetrics::recordSent(std::chrono::nanoseconds latency) {
+  m_messagesSent.fetch_add(1, f_relaxed);
+  m_sendLatency.record(latency);
+  if (m_parent) {
+    m_parent->recordSent(latency);
+  }
+}
+
+TrafficStats TrafficMetrics::stats() const {
+  TrafficStats stats;
+  stats.bytesReceived = m_bytesReceived.load(f_relaxed);
+  stats.messagesReceived = m_messagesReceived.load(f_relaxed);
+  stats.reads = m_reads.load(f_relaxed);
+  stats.bytesSent = m_bytesSent.load(f_relaxed);
+  stats.messagesSent = m_messagesSent.load(f_relaxed);
+  stats.writes = m_writes.load(f_relaxed);
+  stats.partialWrites = m_partialWrites.load(f_relaxed);
+  stats.sendLatency = m_sendLatency.snapshot();
+  return stats;
+}
+
+ServerMetrics::ServerMetrics()
+    : m_traffic{},
+      m_connectionsAccepted{0},
+      m_connectionsClosed{0},
+      m_acceptErrors{0},
+      m_connectionLifetime{},
+      m_creationTime{std::chrono::steady_clock::now()} {}
+
+TrafficMetrics &ServerMetrics::traffic() { return m_traffic; }
+
+void ServerMetrics::recordAccepted() {
+  m_connectionsAccepted.fetch_add(1, f_relaxed);
+}
+
+void ServerMetrics::recordAcceptError() {
+  m_acceptErrors.fetch_add(1, f_relaxed);
+}
+
+void ServerMetrics::recordClosed(std::chrono::nanoseconds lifetime) {
+  m_connectionLifetime.record(lifetime);
+  m_connectionsClosed.fetch_add(1, f_relaxed);
+}
+
+ServerStats ServerMetrics::stats() const {
+  ServerStats stats;
+  static_cast<TrafficStats &>(stats) = m_traffic.stats();
+  stats.connectionsClosed = m_connectionsClosed.load(f_relaxed);
+  stats.connectionsAccepted = m_connectionsAccepted.load(f_relaxed);
+  stats.acceptErrors = m_acceptErrors.load(f_relaxed);
+  stats.activeConnections =
+      stats.connectionsAccepted - std::min(stats.connectionsAccepted,
+                                           stats.connectionsClosed);
+  stats.uptime = std::chrono::steady_clock::now() - m_creationTime;
+  stats.connectionLifetime = m_connectionLifetime.snapshot();
+  return stats;
+}
+
+TextMetricsExporter::TextMetricsExporter(std::ostream &stream,
+                                         std::string prefix)
+    : m_stream{stream}, m_prefix{std::move(prefix)} {}
+
+void TextMetricsExporter::exportStats(const ServerStats &stats) {
+  writeCounter("bytes_received_total", stats.bytesReceived);
+  writeCounter("messages_received_total", stats.messagesReceived);
+  writeCounter("reads_total", stats.reads);
+  writeCounter("bytes_sent_total", stats.bytesSent);
+  writeCounter("messages_sent_total", stats.messagesSent);
+  writeCounter("writes_total", stats.writes);
+  writeCounter("partial_writes_total", stats.partialWrites);
+  writeGauge("pending_bytes", stats.pendingBytes);
+  writeCounter("connections_accepted_total", stats.connectionsAccepted);
+  writeCounter("connections_closed_total", stats.connectionsClosed);
+  writeCounter("accept_errors_total", stats.acceptErrors);
+  writeGauge("active_connections", stats.activeConnections);
+  writeGauge("uptime_seconds",
+             std::chrono::duration_cast<std::chrono::seconds>(stats.uptime)
+                 .count());
+  writeHistogram("send_latency_seconds", stats.sendLatency);
+  writeHistogram("connection_lifetime_seconds", stats.connectionLifetime);
+  m_stream.flush();
+}
+
+void TextMetricsExporter::writeCounter(const char *name, uint64_t value) {
+  m_stream << "# TYPE " << m_prefix << '_' << name << " counter\n"
+           << m_prefix << '_' << name << ' ' << value << '\n';
+}
+
+void TextMetricsExporter::writeGauge(const char *name, uint64_t value) {
+  m_stream << "# TYPE " << m_prefix << '_' << name << " gauge\n"
+           << m_prefix << '_' << name << ' ' << value << '\n';
+}
+
+void TextMetricsExporter::writeHistogram(
+    const char *name, const LatencyHistogram::Snapshot &histogram) {
+  m_stream << "# TYPE " << m_prefix << '_' << name << " histogram\n";
+  uint64_t accumulated{0};
+  for (size_t i = 0; i < LatencyHistogram::bucketCount &&
+                     accumulated < histogram.count;
+       i++) {
+    accumulated += histogram.buckets[i];
+    m_stream << m_prefix << '_' << name << "_bucket{le=\""
+             << bucketUpperBoundNs(i) * 1e-9 << "\"} " << accumulated << '\n';
+  }
+  m_stream << m_prefix << '_' << name << "_bucket{le=\"+Inf\"} "
+           << histogram.count << '\n'
+           << m_prefix << '_' << name << "_sum " << histogram.sumNs * 1e-9
+           << '\n'
+           << m_prefix << '_' << name << "_count " << histogram.count << '\n';
+}
+}  // namespace example
@@ -0,0 +1,255 @@
+#ifndef EXAMPLE_METRICS_HPP
+#define EXAMPLE_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace example {
+/**
+ * LatencyHistogram class records durations in buckets of power of two
+ * nanoseconds, with relaxed atomic counters so that it can be updated from
+ * any thread at the cost of a few uncontended increments.
+ */
+class LatencyHistogram {
+ public:
+  /**
+   * number of buckets, bucket i counting durations lower than 2^i ns and
+   * not lower than 2^(i-1) ns.
+   */
+  static constexpr size_t bucketCount{64};
+  /**
+   * Snapshot struct holds the counters of a LatencyHistogram at a given
+   * time.
+   */
+  struct Snapshot {
+    /**
+     * returns upper bound of the bucket containing specified percentile, or
+     * zero if no duration has been recorded.
+     *
+     * @param percentile between 0 and 100.
+     */
+    std::chrono::nanoseconds percentile(double percentile) const;
+    /**
+     * returns mean of recorded durations, or zero if no duration has been
+     * recorded.
+     */
+    std::chrono::nanoseconds mean() const;
+    /**
+     * adds counters of another snapshot.
+     *
+     * @param other snapshot to add.
+     */
+    Snapshot &operator+=(const Snapshot &other);
+
+    std::array<uint64_t, bucketCount> buckets{};
+    uint64_t count{0};
+    uint64_t sumNs{0};
+  };
+  /**
+   * Constructs an empty LatencyHistogram object.
+   */
+  LatencyHistogram();
+  /**
+   * records a duration.
+   *
+   * @param duration to record.
+   */
+  void record(std::chrono::nanoseconds duration);
+  /**
+   * returns current counters.
+   */
+  Snapshot snapshot() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, bucketCount> m_buckets;
+  std::atomic<uint64_t> m_sumNs;
+};
+/**
+ * TrafficStats struct holds counters of messages received and sent.
+ */
+struct TrafficStats {
+  /** bytes read from sockets, including framing headers. */
+  uint64_t bytesReceived{0};
+  /** messages delivered to observers. */
+  uint64_t messagesReceived{0};
+  /** read operations completed. */
+  uint64_t reads{0};
+  /** bytes written to sockets, including framing headers. */
+  uint64_t bytesSent{0};
+  /** messages completely written to sockets. */
+  uint64_t messagesSent{0};
+  /** write operations completed. */
+  uint64_t writes{0};
+  /** write operations that wrote fewer bytes than were pending. */
+  uint64_t partialWrites{0};
+  /** bytes queued and not yet written to sockets. */
+  uint64_t pendingBytes{0};
+  /** time from send() to the last byte of the message being written. */
+  LatencyHistogram::Snapshot sendLatency{};
+};
+/**
+ * ConnectionStats struct holds counters of a single connection.
+ */
+struct ConnectionStats : TrafficStats {
+  /** time since the connection was established. */
+  std::chrono::nanoseconds lifetime{0};
+};
+/**
+ * ServerStats struct holds counters of a server, including those of
+ * connections already closed.
+ */
+struct ServerStats : TrafficStats {
+  /**
+   * adds counters of another server, such as another shard.
+   *
+   * @param other stats to add.
+   */
+  ServerStats &operator+=(const ServerStats &other);
+
+  /** connections accepted. */
+  uint64_t connectionsAccepted{0};
+  /** connections closed. */
+  uint64_t connectionsClosed{0};
+  /** accept operations failed. */
+  uint64_t acceptErrors{0};
+  /** connections currently open. */
+  uint64_t activeConnections{0};
+  /** time since the server was constructed. */
+  std::chrono::nanoseconds uptime{0};
+  /** lifetime of closed connections. */
+  LatencyHistogram::Snapshot connectionLifetime{};
+};
+/**
+ * TrafficMetrics class updates traffic counters of a connection or a server.
+ * Counters of a connection are also added to those of its parent server.
+ */
+class TrafficMetrics {
+ public:
+  /**
+   * Constructs a TrafficMetrics object.
+   *
+   * @param parent whose counters are also updated, or nullptr.
+   */
+  explicit TrafficMetrics(TrafficMetrics *parent = nullptr);
+  /**
+   * records messages received by a single read operation.
+   *
+   * @param bytes read.
+   * @param messages delivered.
+   */
+  void recordReceived(size_t bytes, size_t messages);
+  /**
+   * records a completed write operation.
+   *
+   * @param bytes written.
+   * @param pendingBytes queued when the write operation started.
+   */
+  void recordWritten(size_t bytes, size_t pendingBytes);
+  /**
+   * records a message completely written.
+   *
+   * @param latency from send() to the last byte being written.
+   */
+  void recordSent(std::chrono::nanoseconds latency);
+  /**
+   * returns current counters, with zero pending bytes.
+   */
+  TrafficStats stats() const;
+
+ private:
+  TrafficMetrics *m_parent;
+  std::atomic<uint64_t> m_bytesReceived;
+  std::atomic<uint64_t> m_messagesReceived;
+  std::atomic<uint64_t> m_reads;
+  std::atomic<uint64_t> m_bytesSent;
+  std::atomic<uint64_t> m_messagesSent;
+  std::atomic<uint64_t> m_writes;
+  std::atomic<uint64_t> m_partialWrites;
+  LatencyHistogram m_sendLatency;
+};
+/**
+ * ServerMetrics class updates counters of a server and of its connections.
+ */
+class ServerMetrics {
+ public:
+  /**
+   * Constructs a ServerMetrics object.
+   */
+  ServerMetrics();
+  /**
+   * returns traffic metrics to be used as parent of connection metrics.
+   */
+  TrafficMetrics &traffic();
+  /**
+   * records a connection accepted.
+   */
+  void recordAccepted();
+  /**
+   * records an accept operation failed.
+   */
+  void recordAcceptError();
+  /**
+   * records a connection closed.
+   *
+   * @param lifetime of the connection.
+   */
+  void recordClosed(std::chrono::nanoseconds lifetime);
+  /**
+   * returns current counters, with zero pending bytes.
+   */
+  ServerStats stats() const;
+
+ private:
+  TrafficMetrics m_traffic;
+  std::atomic<uint64_t> m_connectionsAccepted;
+  std::atomic<uint64_t> m_connectionsClosed;
+  std::atomic<uint64_t> m_acceptErrors;
+  LatencyHistogram m_connectionLifetime;
+  const std::chrono::steady_clock::time_point m_creationTime;
+};
+/**
+ * MetricsExporter class allows publishing server stats to a monitoring
+ * system.
+ */
+struct MetricsExporter {
+  virtual ~MetricsExporter() = default;
+  /**
+   * publishes a snapshot of server stats.
+   *
+   * @param stats to publish.
+   */
+  virtual void exportStats(const ServerStats &stats) = 0;
+};
+/**
+ * TextMetricsExporter class writes server stats to a stream in the
+ * Prometheus text exposition format, so that they can be served to a
+ * scraper.
+ */
+class TextMetricsExporter : public MetricsExporter {
+ public:
+  /**
+   * Constructs a TextMetricsExporter object.
+   *
+   * @param stream to write to.
+   * @param prefix of every metric name.
+   */
+  explicit TextMetricsExporter(std::ostream &stream,
+                               std::string prefix = "example");
+  void exportStats(const ServerStats &stats) override;
+
+ private:
+  void writeCounter(const char *name, uint64_t value);
+  void writeGauge(const char *name, uint64_t value);
+  void writeHistogram(const char *name,
+                      const LatencyHistogram::Snapshot &histogram);
+
+  std::ostream &m_stream;
+  const std::string m_prefix;
+};
+}  // namespace example
+
+#endif
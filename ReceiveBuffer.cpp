@@ -0,0 +1,54 @@
+#include "ReceiveBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr size_t f_minCapacity{4096};
+}  // namespace
+
+namespace example {
+ReceiveBuffer::ReceiveBuffer()
+    : m_storage{}, m_capacity{0}, m_begin{0}, m_end{0} {}
+
+const char *ReceiveBuffer::data() const { return m_storage.get() + m_begin; }
+
+size_t ReceiveBuffer::size() const { return m_end - m_begin; }
+
+const std::shared_ptr<char[]> &ReceiveBuffer::storage() const {
+  return m_storage;
+}
+
+boost::asio::mutable_buffer ReceiveBuffer::prepare(size_t size) {
+  auto isShared = m_storage.use_count() > 1;
+  if (isShared || m_end + size > m_capacity) {
+    auto received = m_end - m_begin;
+    if (isShared || received + size > m_capacity) {
+      auto capacity = received + size > m_capacity ? 2 * m_capacity
+                                                   : m_capacity;
+      capacity = std::max({received + size, capacity, f_minCapacity});
+      std::shared_ptr<char[]> storage{new char[capacity]};
+      if (received > 0) {
+        std::memcpy(storage.get(), data(), received);
+      }
+      m_storage = std::move(storage);
+      m_capacity = capacity;
+    } else {
+      std::memmove(m_storage.get(), data(), received);
+    }
+    m_begin = 0;
+    m_end = received;
+  }
+  return {m_storage.get() + m_end, size};
+}
+
+void ReceiveBuffer::commit(size_t size) { m_end += size; }
+
+void ReceiveBuffer::consume(size_t size) {
+  m_begin += size;
+  if (m_begin == m_end) {
+    m_begin = 0;
+    m_end = 0;
+  }
+}
+}  // namespace example
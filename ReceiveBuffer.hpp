@@ -0,0 +1,59 @@
+#ifndef EXAMPLE_RECEIVE_BUFFER_HPP
+#define EXAMPLE_RECEIVE_BUFFER_HPP
+
+#include <boost/asio/buffer.hpp>
+#include <memory>
+
+namespace example {
+/**
+ * ReceiveBuffer class holds received bytes contiguously, so that messages can
+ * be delivered as views into it. Storage retained by a SharedMessage is never
+ * modified again; the buffer moves on to new storage instead.
+ */
+class ReceiveBuffer {
+ public:
+  /**
+   * Constructs an empty ReceiveBuffer object.
+   */
+  ReceiveBuffer();
+  /**
+   * returns pointer to first received byte not yet consumed.
+   */
+  const char *data() const;
+  /**
+   * returns number of received bytes not yet consumed.
+   */
+  size_t size() const;
+  /**
+   * returns storage shared with the messages delivered from the buffer.
+   */
+  const std::shared_ptr<char[]> &storage() const;
+  /**
+   * returns writable buffer of at least the requested size placed after the
+   * received bytes.
+   *
+   * @param size in bytes requested.
+   */
+  boost::asio::mutable_buffer prepare(size_t size);
+  /**
+   * appends bytes written to a previously prepared buffer.
+   *
+   * @param size in bytes to append.
+   */
+  void commit(size_t size);
+  /**
+   * removes bytes from the beginning of the received bytes.
+   *
+   * @param size in bytes to remove.
+   */
+  void consume(size_t size);
+
+ private:
+  std::shared_ptr<char[]> m_storage;
+  size_t m_capacity;
+  size_t m_begin;
+  size_t m_end;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,41 @@
+#include "Rpc.hpp"
+
+namespace {
+const char *describe(example::RpcStatus status) {
+  switch (status) {
+    case example::RpcStatus::Ok:
+      return "RPC call succeeded";
+    case example::RpcStatus::Timeout:
+      return "RPC call timed out";
+    case example::RpcStatus::Disconnected:
+      return "RPC connection was closed";
+    case example::RpcStatus::SendFailed:
+      return "RPC request could not be sent";
+  }
+  return "RPC call failed";
+}
+}  // namespace
+
+namespace example {
+RpcError::RpcError(RpcStatus status)
+    : std::runtime_error{describe(status)}, m_status{status} {}
+
+RpcStatus RpcError::status() const { return m_status; }
+
+void RpcHeader::encode(uint64_t id, char *buffer) {
+  for (size_t i = 0; i < size; i++) {
+    buffer[i] = static_cast<char>(id >> (8 * i));
+  }
+}
+
+bool RpcHeader::decode(std::string_view message, uint64_t &id) {
+  if (message.size() < size) {
+    return false;
+  }
+  id = 0;
+  for (size_t i = 0; i < size; i++) {
+    id |= uint64_t{static_cast<uint8_t>(message[i])} << (8 * i);
+  }
+  return true;
+}
+}  // namespace example
@@ -0,0 +1,70 @@
+#ifndef EXAMPLE_RPC_HPP
+#define EXAMPLE_RPC_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace example {
+/**
+ * RpcStatus enum specifies how a remote call completed.
+ */
+enum class RpcStatus {
+  /** response was received. */
+  Ok,
+  /** no response was received before the call deadline. */
+  Timeout,
+  /** connection was closed before a response was received. */
+  Disconnected,
+  /** request could not be queued at the connection. */
+  SendFailed
+};
+/**
+ * RpcError class is the exception thrown by futures of remote calls that
+ * did not complete with RpcStatus::Ok.
+ */
+class RpcError : public std::runtime_error {
+ public:
+  /**
+   * Constructs a RpcError object.
+   *
+   * @param status of the remote call.
+   */
+  explicit RpcError(RpcStatus status);
+  /**
+   * returns status of the remote call.
+   */
+  RpcStatus status() const;
+
+ private:
+  RpcStatus m_status;
+};
+/**
+ * RpcHeader struct encodes and decodes the correlation identifier that
+ * prefixes the payload of every request and response, so that responses
+ * can be matched to requests in any order.
+ */
+struct RpcHeader {
+  /**
+   * size in bytes of the header.
+   */
+  static constexpr size_t size{8};
+  /**
+   * encodes a correlation identifier as little endian.
+   *
+   * @param id correlation identifier.
+   * @param buffer of at least size bytes.
+   */
+  static void encode(uint64_t id, char *buffer);
+  /**
+   * decodes the correlation identifier of a message.
+   *
+   * @param message starting with the header.
+   * @param id decoded.
+   * @return false if the message is shorter than the header.
+   */
+  static bool decode(std::string_view message, uint64_t &id);
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,170 @@
+#include "RpcClient.hpp"
+
+#include <vector>
+
+#include "Allocation.hpp"
+#include "Logging.hpp"
+
+namespace example {
+void RpcClient::Observer::onConnected() {}
+
+void RpcClient::Observer::onDisconnected() {}
+
+RpcClient::RpcClient(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : m_observer{observer},
+      m_client{ioContext, *this, framing, options},
+      m_timer{ioContext},
+      m_mutex{},
+      m_pendingCalls{},
+      m_deadlines{},
+      m_timerDeadline{std::chrono::steady_clock::time_point::max()},
+      m_nextId{0} {}
+
+void RpcClient::connect(const boost::asio::ip::tcp::endpoint &endpoint) {
+  m_client.connect(endpoint);
+}
+
+void RpcClient::connect(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  m_client.connect(endpoint);
+}
+
+bool RpcClient::call(std::string_view request,
+                     std::chrono::nanoseconds timeout, Callback callback) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto message = BufferPool::acquire();
+  message.resize(RpcHeader::size);
+  message.append(request);
+  uint64_t id;
+  {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    id = m_nextId++;
+    auto deadlineIterator = m_deadlines.emplace(deadline, id);
+    m_pendingCalls.emplace(
+        id, PendingCall{std::move(callback), deadlineIterator});
+  }
+  RpcHeader::encode(id, message.data());
+  if (!m_client.send(std::move(message))) {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    auto pendingCall = m_pendingCalls.find(id);
+    if (pendingCall != m_pendingCalls.end()) {
+      m_deadlines.erase(pendingCall->second.deadline);
+      m_pendingCalls.erase(pendingCall);
+    }
+    return false;
+  }
+  // the timer deadline is lowered only once the request is sent, so that a
+  // failed call does not leave it earlier than any pending deadline.
+  bool isTimerLate;
+  {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    isTimerLate = deadline < m_timerDeadline;
+    if (isTimerLate) {
+      m_timerDeadline = deadline;
+    }
+  }
+  if (isTimerLate) {
+    boost::asio::post(m_timer.get_executor(), [this]() { armTimer(); });
+  }
+  return true;
+}
+
+std::future<std::string> RpcClient::call(std::string_view request,
+                                         std::chrono::nanoseconds timeout) {
+  auto promise = std::make_shared<std::promise<std::string>>();
+  auto future = promise->get_future();
+  auto callback = [promise](auto status, const auto &response) {
+    if (status == RpcStatus::Ok) {
+      promise->set_value(response.str());
+    } else {
+      promise->set_exception(std::make_exception_ptr(RpcError{status}));
+    }
+  };
+  if (!call(request, timeout, std::move(callback))) {
+    promise->set_exception(
+        std::make_exception_ptr(RpcError{RpcStatus::SendFailed}));
+  }
+  return future;
+}
+
+size_t RpcClient::pendingCount() {
+  std::lock_guard<std::mutex> guard{m_mutex};
+  return m_pendingCalls.size();
+}
+
+void RpcClient::disconnect() { m_client.disconnect(); }
+
+void RpcClient::onConnected() { m_observer.onConnected(); }
+
+void RpcClient::onReceivedBatch(const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    uint64_t id;
+    if (!RpcHeader::decode(message.view(), id)) {
+      EXAMPLE_LOG_ERROR("RPC Client Receive error: invalid response header");
+      continue;
+    }
+    Callback callback;
+    {
+      std::lock_guard<std::mutex> guard{m_mutex};
+      auto pendingCall = m_pendingCalls.find(id);
+      if (pendingCall == m_pendingCalls.end()) {
+        continue;
+      }
+      callback = std::move(pendingCall->second.callback);
+      m_deadlines.erase(pendingCall->second.deadline);
+      m_pendingCalls.erase(pendingCall);
+    }
+    callback(RpcStatus::Ok, message.suffix(RpcHeader::size));
+  }
+}
+
+void RpcClient::onDisconnected() {
+  std::vector<Callback> callbacks;
+  {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    for (auto &pendingCall : m_pendingCalls) {
+      callbacks.push_back(std::move(pendingCall.second.callback));
+    }
+    m_pendingCalls.clear();
+    m_deadlines.clear();
+  }
+  for (const auto &callback : callbacks) {
+    callback(RpcStatus::Disconnected, MessageView{std::string_view{}});
+  }
+  m_observer.onDisconnected();
+}
+
+void RpcClient::armTimer() {
+  std::lock_guard<std::mutex> guard{m_mutex};
+  if (m_deadlines.empty()) {
+    m_timerDeadline = std::chrono::steady_clock::time_point::max();
+    return;
+  }
+  m_timerDeadline = m_deadlines.begin()->first;
+  m_timer.expires_at(m_timerDeadline);
+  m_timer.async_wait([this](const auto &error) {
+    if (error != boost::asio::error::operation_aborted) {
+      onTimer();
+    }
+  });
+}
+
+void RpcClient::onTimer() {
+  std::vector<Callback> callbacks;
+  {
+    std::lock_guard<std::mutex> guard{m_mutex};
+    auto now = std::chrono::steady_clock::now();
+    while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+      auto pendingCall = m_pendingCalls.find(m_deadlines.begin()->second);
+      callbacks.push_back(std::move(pendingCall->second.callback));
+      m_pendingCalls.erase(pendingCall);
+      m_deadlines.erase(m_deadlines.begin());
+    }
+  }
+  for (const auto &callback : callbacks) {
+    callback(RpcStatus::Timeout, MessageView{std::string_view{}});
+  }
+  armTimer();
+}
+}  // namespace example
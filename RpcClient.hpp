@@ -0,0 +1,126 @@
+#ifndef EXAMPLE_RPC_CLIENT_HPP
+#define EXAMPLE_RPC_CLIENT_HPP
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "Rpc.hpp"
+#include "TcpClient.hpp"
+
+namespace example {
+/**
+ * RpcClient class sends requests to a RpcServer and matches responses to
+ * them by correlation identifier, allowing many requests in flight on a
+ * single connection and responses in any order. Every request has a
+ * deadline after which it completes with RpcStatus::Timeout.
+ *
+ * Calls can be made from any thread. Completion callbacks are invoked from
+ * the thread running the io_context.
+ */
+class RpcClient : private TcpClient::Observer {
+ public:
+  /**
+   * Callback type invoked once per call with its status and, if the status
+   * is RpcStatus::Ok, the response payload, valid only during the call.
+   */
+  using Callback = std::function<void(RpcStatus, const MessageView &)>;
+  /**
+   * Observer class allows monitoring of RpcClient connection events.
+   */
+  struct Observer {
+    /**
+     * virtual function called by RpcClient after it has been connected.
+     */
+    virtual void onConnected();
+    /**
+     * virtual function called by RpcClient after it has been disconnected,
+     * once pending calls have completed with RpcStatus::Disconnected.
+     */
+    virtual void onDisconnected();
+  };
+  /**
+   * Constructs a RpcClient object.
+   *
+   * @param ioContext required for asynchronous input and ouput operations.
+   * @param observer to monitor RpcClient events.
+   * @param framing used to delimit messages on the connection.
+   * @param options configuring the connection.
+   */
+  RpcClient(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::text(),
+            const ConnectionOptions &options = {});
+  /**
+   * attempts to connect to specified endpoint.
+   *
+   * @param endpoint to connect to.
+   */
+  void connect(const boost::asio::ip::tcp::endpoint &endpoint);
+  /**
+   * attempts to connect to specified Unix domain socket endpoint.
+   *
+   * @param endpoint to connect to.
+   */
+  void connect(const boost::asio::local::stream_protocol::endpoint &endpoint);
+  /**
+   * Sends a request, invoking callback when its response is received or its
+   * deadline expires.
+   *
+   * @param request payload.
+   * @param timeout after which the call completes with RpcStatus::Timeout.
+   * @param callback invoked once when the call completes.
+   * @return false if the request could not be sent, in which case callback
+   * is not invoked.
+   */
+  bool call(std::string_view request, std::chrono::nanoseconds timeout,
+            Callback callback);
+  /**
+   * Sends a request, returning a future of its response.
+   *
+   * @param request payload.
+   * @param timeout after which the call completes with RpcStatus::Timeout.
+   * @return future of the response payload, throwing RpcError if the call
+   * does not complete with RpcStatus::Ok.
+   */
+  std::future<std::string> call(std::string_view request,
+                                std::chrono::nanoseconds timeout);
+  /**
+   * returns number of calls waiting for a response.
+   */
+  size_t pendingCount();
+  /**
+   * Closes connection.
+   */
+  void disconnect();
+
+ private:
+  using Deadlines =
+      std::multimap<std::chrono::steady_clock::time_point, uint64_t>;
+
+  struct PendingCall {
+    Callback callback;
+    Deadlines::iterator deadline;
+  };
+
+  void onConnected() override;
+  void onReceivedBatch(const MessageBatch &messages) override;
+  void onDisconnected() override;
+  void armTimer();
+  void onTimer();
+
+  Observer &m_observer;
+  TcpClient m_client;
+  boost::asio::steady_timer m_timer;
+  std::mutex m_mutex;
+  std::unordered_map<uint64_t, PendingCall> m_pendingCalls;
+  Deadlines m_deadlines;
+  std::chrono::steady_clock::time_point m_timerDeadline;
+  uint64_t m_nextId;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,58 @@
+#include "RpcServer.hpp"
+
+#include "Allocation.hpp"
+#include "Logging.hpp"
+
+namespace example {
+void RpcServer::Observer::onRequest(
+    [[maybe_unused]] ConnectionId connectionId,
+    [[maybe_unused]] uint64_t requestId,
+    [[maybe_unused]] const MessageView &request) {}
+
+RpcServer::RpcServer(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : m_ioContext{ioContext},
+      m_observer{observer},
+      m_server{ioContext, *this, framing, options} {}
+
+bool RpcServer::listen(const boost::asio::ip::tcp &protocol, uint16_t port) {
+  return m_server.listen(protocol, port);
+}
+
+bool RpcServer::listen(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  return m_server.listen(endpoint);
+}
+
+void RpcServer::startAcceptingConnections() {
+  m_server.startAcceptingConnections();
+}
+
+bool RpcServer::respond(ConnectionId connectionId, uint64_t requestId,
+                        std::string_view response) {
+  auto message = BufferPool::acquire();
+  message.resize(RpcHeader::size);
+  RpcHeader::encode(requestId, message.data());
+  message.append(response);
+  if (!m_ioContext.get_executor().running_in_this_thread()) {
+    m_server.submit(connectionId, std::move(message));
+    return true;
+  }
+  return m_server.send(connectionId, std::move(message));
+}
+
+void RpcServer::close() { m_server.close(); }
+
+void RpcServer::onReceivedBatch(ConnectionId connectionId,
+                                const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    uint64_t requestId;
+    if (!RpcHeader::decode(message.view(), requestId)) {
+      EXAMPLE_LOG_ERROR("RPC Server Receive error: invalid request header");
+      continue;
+    }
+    m_observer.onRequest(connectionId, requestId,
+                         message.suffix(RpcHeader::size));
+  }
+}
+}  // namespace example
@@ -0,0 +1,93 @@
+#ifndef EXAMPLE_RPC_SERVER_HPP
+#define EXAMPLE_RPC_SERVER_HPP
+
+#include <boost/asio.hpp>
+
+#include "Rpc.hpp"
+#include "TcpServer.hpp"
+
+namespace example {
+/**
+ * RpcServer class accepts connections from RpcClient objects and delivers
+ * their requests, which can be responded to at any later time and in any
+ * order.
+ */
+class RpcServer : private TcpServer::Observer {
+ public:
+  /**
+   * Observer class allows handling of RpcServer requests.
+   */
+  struct Observer {
+    /**
+     * virtual function called by RpcServer after a request is received.
+     * The request is responded to by calling RpcServer::respond(), either
+     * during the call or afterwards.
+     *
+     * @param connectionId unique identifier of the requesting connection.
+     * @param requestId correlation identifier of the request.
+     * @param request payload, valid only during the call.
+     */
+    virtual void onRequest(ConnectionId connectionId, uint64_t requestId,
+                           const MessageView &request);
+  };
+  /**
+   * Constructs a RpcServer object.
+   *
+   * @param ioContext required for asynchronous input and output operations.
+   * @param observer to handle requests.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  RpcServer(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::text(),
+            const ConnectionOptions &options = {});
+  /**
+   * listen for connections at any interface with specified
+   * protocol to specified port.
+   *
+   * @param protocol of the interfaces to listen at.
+   * @param port to listen to.
+   */
+  bool listen(const boost::asio::ip::tcp &protocol, uint16_t port);
+  /**
+   * listen for connections at specified Unix domain socket path, replacing
+   * any socket file left at the path.
+   *
+   * @param endpoint to listen at.
+   */
+  bool listen(const boost::asio::local::stream_protocol::endpoint &endpoint);
+  /**
+   * starts accepting connections and associated asynchronous read and
+   * write operations.
+   */
+  void startAcceptingConnections();
+  /**
+   * Sends the response to a request. It can be called from any thread:
+   * responses from other threads than the one running the io_context are
+   * submitted to the TcpServer, and discarded once there if the connection
+   * no longer exists or its send queue is full.
+   *
+   * @param connectionId unique identifier of the requesting connection.
+   * @param requestId correlation identifier of the request.
+   * @param response payload.
+   * @return false if the response is sent from the thread running the
+   * io_context and the connection does not exist or its send queue is full.
+   */
+  bool respond(ConnectionId connectionId, uint64_t requestId,
+               std::string_view response);
+  /**
+   * Close active connections and stops accepting new connections.
+   */
+  void close();
+
+ private:
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+
+  boost::asio::io_context &m_ioContext;
+  Observer &m_observer;
+  TcpServer m_server;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,29 @@
+#include "SendLimit.hpp"
+
+#include <limits>
+
+namespace example {
+SendLimit::SendLimit()
+    : m_bytes{0}, m_maxBytes{std::numeric_limits<size_t>::max()} {}
+
+void SendLimit::setMaxBytes(size_t maxBytes) {
+  m_maxBytes.store(maxBytes, std::memory_order_relaxed);
+}
+
+size_t SendLimit::bytes() const {
+  return m_bytes.load(std::memory_order_relaxed);
+}
+
+bool SendLimit::tryAcquire(size_t bytes) {
+  auto maxBytes = m_maxBytes.load(std::memory_order_relaxed);
+  if (m_bytes.fetch_add(bytes, std::memory_order_relaxed) >= maxBytes) {
+    m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void SendLimit::release(size_t bytes) {
+  m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+}  // namespace example
@@ -0,0 +1,48 @@
+#ifndef EXAMPLE_SEND_LIMIT_HPP
+#define EXAMPLE_SEND_LIMIT_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace example {
+/**
+ * SendLimit class bounds the bytes pending to be sent by a group of
+ * connections. It can be shared by connections running on different threads.
+ */
+class SendLimit {
+ public:
+  /**
+   * Constructs an unbounded SendLimit object.
+   */
+  SendLimit();
+  /**
+   * sets number of pending bytes at which further sends are rejected.
+   *
+   * @param maxBytes pending.
+   */
+  void setMaxBytes(size_t maxBytes);
+  /**
+   * returns number of bytes pending.
+   */
+  size_t bytes() const;
+  /**
+   * reserves bytes to be sent if the limit has not been reached.
+   *
+   * @param bytes to reserve.
+   * @return false if the limit has been reached.
+   */
+  bool tryAcquire(size_t bytes);
+  /**
+   * releases bytes previously reserved, once sent or discarded.
+   *
+   * @param bytes to release.
+   */
+  void release(size_t bytes);
+
+ private:
+  std::atomic<size_t> m_bytes;
+  std::atomic<size_t> m_maxBytes;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,192 @@
+#include "ShardedTcpServer.hpp"
+
+#include <algorithm>
+#include <future>
+
+namespace example {
+ShardedTcpServer::Shard::Shard(TcpServer::Observer &observer,
+                               const Framing &framing,
+                               const ConnectionOptions &options, int index,
+                               int count)
+    : ioContext{1},
+      workGuard{ioContext.get_executor()},
+      server{ioContext, observer, framing, options, index, count},
+      thread{} {}
+
+ShardedTcpServer::ShardedTcpServer(TcpServer::Observer &observer,
+                                   size_t shardCount, const Framing &framing,
+                                   const ConnectionOptions &options)
+    : m_shards{}, m_framing{framing} {
+  auto count = static_cast<int>(std::max<size_t>(shardCount, 1));
+  for (int i = 0; i < count; i++) {
+    m_shards.push_back(
+        std::make_unique<Shard>(observer, framing, options, i, count));
+  }
+}
+
+ShardedTcpServer::~ShardedTcpServer() {
+  close();
+  for (auto &shard : m_shards) {
+    shard->workGuard.reset();
+    shard->ioContext.stop();
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+  }
+}
+
+bool ShardedTcpServer::listen(const boost::asio::ip::tcp &protocol,
+                              uint16_t port) {
+  for (auto &shard : m_shards) {
+    if (!shard->server.listen(protocol, port)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ShardedTcpServer::startAcceptingConnections() {
+  for (auto &shard : m_shards) {
+    auto &server = shard->server;
+    boost::asio::post(shard->ioContext,
+                      [&server]() { server.startAcceptingConnections(); });
+    if (!shard->thread.joinable()) {
+      shard->thread = std::thread{[&context = shard->ioContext]() {
+        context.run();
+      }};
+    }
+  }
+}
+
+void ShardedTcpServer::send(ConnectionId connectionId,
+                            const std::string &message, Priority priority) {
+  doSend(connectionId, message, priority);
+}
+
+void ShardedTcpServer::send(ConnectionId connectionId, std::string &&message,
+                            Priority priority) {
+  doSend(connectionId, std::move(message), priority);
+}
+
+void ShardedTcpServer::send(ConnectionId connectionId,
+                            std::shared_ptr<const Buffer> message,
+                            Priority priority) {
+  doSend(connectionId, std::move(message), priority);
+}
+
+void ShardedTcpServer::broadcast(const std::string &message) {
+  auto frame = TcpConnection::frame(m_framing, message);
+  if (!frame) {
+    return;
+  }
+  for (auto &shard : m_shards) {
+    dispatch(*shard, [&server = shard->server, frame]() {
+      server.broadcastFrame(frame);
+    });
+  }
+}
+
+void ShardedTcpServer::multicast(const std::vector<ConnectionId> &connectionIds,
+                                 const std::string &message) {
+  auto frame = TcpConnection::frame(m_framing, message);
+  if (!frame) {
+    return;
+  }
+  std::vector<std::vector<ConnectionId>> shardConnectionIds(m_shards.size());
+  for (auto connectionId : connectionIds) {
+    shardConnectionIds[shardOf(connectionId)].push_back(connectionId);
+  }
+  for (size_t i = 0; i < m_shards.size(); i++) {
+    if (shardConnectionIds[i].empty()) {
+      continue;
+    }
+    dispatch(*m_shards[i],
+             [&server = m_shards[i]->server, frame,
+              connectionIds = std::move(shardConnectionIds[i])]() {
+               server.multicastFrame(connectionIds, frame);
+             });
+  }
+}
+
+void ShardedTcpServer::setSlowReceiverPolicy(
+    TcpServer::SlowReceiverPolicy policy, size_t maxPendingBytes) {
+  for (auto &shard : m_shards) {
+    dispatch(*shard, [&server = shard->server, policy, maxPendingBytes]() {
+      server.setSlowReceiverPolicy(policy, maxPendingBytes);
+    });
+  }
+}
+
+void ShardedTcpServer::setMaxBufferedBytes(size_t maxBytes) {
+  for (auto &shard : m_shards) {
+    // every shard buffers at least one byte, so that none rejects every send.
+    shard->server.setMaxBufferedBytes(
+        std::max<size_t>(maxBytes / m_shards.size(), 1));
+  }
+}
+
+void ShardedTcpServer::setMaxConnections(size_t maxConnections) {
+  for (auto &shard : m_shards) {
+    // every shard accepts at least one connection, so that none starves.
+    shard->server.setMaxConnections(
+        std::max<size_t>(maxConnections / m_shards.size(), 1));
+  }
+}
+
+void ShardedTcpServer::setAcceptRateLimit(const RateLimit &limit) {
+  auto shardCount = static_cast<double>(m_shards.size());
+  for (auto &shard : m_shards) {
+    shard->server.setAcceptRateLimit(
+        {limit.rate / shardCount, limit.burst / shardCount});
+  }
+}
+
+ServerStats ShardedTcpServer::stats() const {
+  ServerStats stats;
+  for (const auto &shard : m_shards) {
+    stats += shard->server.stats();
+  }
+  return stats;
+}
+
+void ShardedTcpServer::close() {
+  for (auto &shard : m_shards) {
+    if (!shard->thread.joinable() ||
+        shard->ioContext.get_executor().running_in_this_thread()) {
+      shard->server.close();
+      continue;
+    }
+    std::promise<void> closed;
+    boost::asio::post(shard->ioContext, [&shard, &closed]() {
+      shard->server.close();
+      closed.set_value();
+    });
+    closed.get_future().wait();
+  }
+}
+
+template <typename Message>
+void ShardedTcpServer::doSend(ConnectionId connectionId, Message &&message,
+                              Priority priority) {
+  auto &shard = *m_shards[shardOf(connectionId)];
+  if (shard.ioContext.get_executor().running_in_this_thread()) {
+    shard.server.send(connectionId, std::forward<Message>(message), priority);
+    return;
+  }
+  shard.server.submit(connectionId, std::forward<Message>(message), priority);
+}
+
+size_t ShardedTcpServer::shardOf(ConnectionId connectionId) const {
+  return TcpServer::ConnectionMap::partitionOf(
+      connectionId, static_cast<uint32_t>(m_shards.size()));
+}
+
+template <typename Handler>
+void ShardedTcpServer::dispatch(Shard &shard, Handler &&handler) {
+  if (!shard.thread.joinable() ||
+      shard.ioContext.get_executor().running_in_this_thread()) {
+    return handler();
+  }
+  boost::asio::post(shard.ioContext, std::forward<Handler>(handler));
+}
+}  // namespace example
@@ -0,0 +1,172 @@
+#ifndef EXAMPLE_SHARDED_TCP_SERVER_HPP
+#define EXAMPLE_SHARDED_TCP_SERVER_HPP
+
+#include <boost/asio.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "TcpServer.hpp"
+
+namespace example {
+/**
+ * ShardedTcpServer class distributes TCP connections over several shards,
+ * each one owning an io_context run by a dedicated worker thread and an
+ * acceptor listening with SO_REUSEPORT at the same port, so that the kernel
+ * balances incoming connections among shards.
+ *
+ * Every connection stays pinned to the thread of the shard that accepted it.
+ * TcpServer::Observer functions are therefore invoked from the worker
+ * threads: calls related to the same connection never overlap, while calls
+ * related to connections of different shards may run concurrently.
+ */
+class ShardedTcpServer {
+ public:
+  /**
+   * Constructs a ShardedTcpServer object.
+   *
+   * @param observer to monitor events of every shard.
+   * @param shardCount number of shards and worker threads.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  ShardedTcpServer(TcpServer::Observer &observer, size_t shardCount,
+                   const Framing &framing = Framing::text(),
+                   const ConnectionOptions &options = {});
+  /**
+   * Closes every shard and joins worker threads.
+   */
+  ~ShardedTcpServer();
+  /**
+   * listen for connections at any interface with specified
+   * protocol to specified port, with an acceptor per shard.
+   *
+   * @param protocol of the interfaces to listen at.
+   * @param port to listen to.
+   */
+  bool listen(const boost::asio::ip::tcp &protocol, uint16_t port);
+  /**
+   * starts worker threads, accepting connections and associated
+   * asynchronous read and write operations.
+   */
+  void startAcceptingConnections();
+  /**
+   * Sends string message to peer associated to specified connection. It can
+   * be called from any thread; calls from threads other than the connection
+   * shard thread are submitted to it through a lock-free queue.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void send(ConnectionId connectionId, const std::string &message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends string message to peer associated to specified connection, taking
+   * ownership of the message instead of copying it.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void send(ConnectionId connectionId, std::string &&message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends message to peer associated to specified connection, sharing
+   * ownership of the message payload instead of copying it.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void send(ConnectionId connectionId, std::shared_ptr<const Buffer> message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends string message to peers associated to every connection of every
+   * shard. The message is framed once and the frame is shared by every
+   * connection. Sending is completed asynchronously by each shard.
+   *
+   * @param message to send.
+   */
+  void broadcast(const std::string &message);
+  /**
+   * Sends string message to peers associated to specified connections. The
+   * message is framed once and the frame is shared by every connection.
+   * Sending is completed asynchronously by each shard.
+   *
+   * @param connectionIds unique identifiers associated to receiving peers.
+   * @param message to send.
+   */
+  void multicast(const std::vector<ConnectionId> &connectionIds,
+                 const std::string &message);
+  /**
+   * Sets how broadcast() and multicast() treat slow receivers of every
+   * shard.
+   *
+   * @param policy applied to slow receivers.
+   * @param maxPendingBytes above which a connection is a slow receiver.
+   */
+  void setSlowReceiverPolicy(TcpServer::SlowReceiverPolicy policy,
+                             size_t maxPendingBytes);
+  /**
+   * Sets number of bytes pending to be sent by all connections at which
+   * further sends are rejected, evenly split among shards but at least one
+   * byte per shard. By default it is unbounded.
+   *
+   * @param maxBytes pending.
+   */
+  void setMaxBufferedBytes(size_t maxBytes);
+  /**
+   * Sets number of connections at which accepting pauses, evenly split
+   * among shards but at least one per shard. Every shard notifies
+   * onAcceptPaused() and onAcceptResumed() on its own.
+   * It must be called before startAcceptingConnections().
+   *
+   * @param maxConnections open at once.
+   */
+  void setMaxConnections(size_t maxConnections);
+  /**
+   * Sets rate at which connections are accepted, evenly split among shards.
+   * It must be called before startAcceptingConnections().
+   *
+   * @param limit of accepted connections per second.
+   */
+  void setAcceptRateLimit(const RateLimit &limit);
+  /**
+   * returns the sum of the counters of every shard. It can be called from
+   * any thread.
+   */
+  ServerStats stats() const;
+  /**
+   * Closes active connections of every shard and stops accepting new
+   * connections, waiting for every shard to complete. In order to restart
+   * operation, a call to functions listen() and startAcceptingConnections()
+   * is required.
+   */
+  void close();
+
+ private:
+  struct Shard {
+    Shard(TcpServer::Observer &observer, const Framing &framing,
+          const ConnectionOptions &options, int index, int count);
+
+    boost::asio::io_context ioContext;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        workGuard;
+    TcpServer server;
+    std::thread thread;
+  };
+
+  template <typename Message>
+  void doSend(ConnectionId connectionId, Message &&message,
+              Priority priority);
+  size_t shardOf(ConnectionId connectionId) const;
+  template <typename Handler>
+  void dispatch(Shard &shard, Handler &&handler);
+
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  const Framing &m_framing;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,108 @@
+#include "ShmClient.hpp"
+
+#include "Logging.hpp"
+
+namespace example {
+ShmClient::ShmClient(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : m_ioContext{ioContext},
+      m_connection{},
+      m_observer{observer},
+      m_framing{framing},
+      m_options{options} {}
+
+void ShmClient::connect(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  if (connection()) {
+    return;
+  }
+  auto socket = std::make_shared<ShmConnection::Socket>(m_ioContext);
+  socket->async_connect(endpoint, [this, socket](const auto &error) {
+    if (error) {
+      EXAMPLE_LOG_ERROR("SHM Client Connect error: ", error.message());
+      m_observer.onDisconnected();
+      return;
+    }
+    socket->async_wait(
+        boost::asio::socket_base::wait_read,
+        [this, socket](const auto &error) {
+          if (error) {
+            EXAMPLE_LOG_ERROR("SHM Client Connect error: ", error.message());
+            m_observer.onDisconnected();
+            return;
+          }
+          auto connection = ShmConnection::connect(
+              std::move(*socket), *this, m_framing, m_options);
+          if (!connection) {
+            m_observer.onDisconnected();
+            return;
+          }
+          std::atomic_store(&m_connection, connection);
+          connection->startReceiving();
+          EXAMPLE_LOG_INFO("SHM Client was connected");
+          m_observer.onConnected();
+        });
+  });
+}
+
+bool ShmClient::send(const std::string &message) { return doSend(message); }
+
+bool ShmClient::send(std::string &&message) {
+  return doSend(std::move(message));
+}
+
+bool ShmClient::send(std::shared_ptr<const Buffer> message) {
+  return doSend(std::move(message));
+}
+
+bool ShmClient::stats(ConnectionStats &stats) {
+  auto connection = this->connection();
+  if (!connection) {
+    return false;
+  }
+  stats = connection->stats();
+  return true;
+}
+
+void ShmClient::disconnect() {
+  auto connection = this->connection();
+  if (connection) {
+    connection->close();
+  }
+}
+
+template <typename Message>
+bool ShmClient::doSend(Message &&message) {
+  auto connection = this->connection();
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("SHM Client Send error: no connection");
+    return false;
+  }
+  return connection->send(std::forward<Message>(message));
+}
+
+std::shared_ptr<ShmConnection> ShmClient::connection() const {
+  return std::atomic_load(&m_connection);
+}
+
+void ShmClient::onReceivedBatch([[maybe_unused]] ConnectionId connectionId,
+                                const MessageBatch &messages) {
+  m_observer.onReceivedBatch(messages);
+}
+
+void ShmClient::onSendQueueHigh([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onSendQueueHigh();
+}
+
+void ShmClient::onWritable([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onWritable();
+}
+
+void ShmClient::onConnectionClosed([[maybe_unused]] ConnectionId connectionId) {
+  if (std::atomic_exchange(&m_connection,
+                           std::shared_ptr<ShmConnection>{})) {
+    EXAMPLE_LOG_INFO("SHM Client was disconnected");
+    m_observer.onDisconnected();
+  }
+}
+}  // namespace example
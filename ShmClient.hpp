@@ -0,0 +1,95 @@
+#ifndef EXAMPLE_SHM_CLIENT_HPP
+#define EXAMPLE_SHM_CLIENT_HPP
+
+#include <boost/asio.hpp>
+#include <memory>
+
+#include "ShmConnection.hpp"
+#include "TcpClient.hpp"
+
+namespace example {
+/**
+ * ShmClient class allows to connect to a ShmServer of the same host through
+ * specified Unix domain socket endpoint, and use the shared memory
+ * connection to send and receive string messages. It notifies the same
+ * observer as a TcpClient. Functions send() and stats() can be called from
+ * any thread.
+ */
+class ShmClient : private ShmConnection::Observer {
+ public:
+  /**
+   * Observer class allows monitoring of ShmClient events.
+   */
+  using Observer = TcpClient::Observer;
+  /**
+   * Constructs a ShmClient object.
+   *
+   * @param ioContext required for asynchronous input and ouput operations.
+   * @param observer to monitor ShmClient events.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  ShmClient(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::binary(),
+            const ConnectionOptions &options = {});
+  /**
+   * attempts to connect to specified Unix domain socket endpoint.
+   *
+   * @param endpoint to connect to.
+   */
+  void connect(const boost::asio::local::stream_protocol::endpoint &endpoint);
+  /**
+   * Sends string message to peer associated to ShmClient connection if
+   * exists.
+   *
+   * @param message to send.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(const std::string &message);
+  /**
+   * Sends string message to peer associated to ShmClient connection if
+   * exists, taking ownership of the message if it has to be queued.
+   *
+   * @param message to send.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(std::string &&message);
+  /**
+   * Sends message to peer associated to ShmClient connection if exists,
+   * sharing ownership of the message payload if it has to be queued.
+   *
+   * @param message to send.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(std::shared_ptr<const Buffer> message);
+  /**
+   * gets a snapshot of the counters of the ShmClient connection.
+   *
+   * @param stats of the connection.
+   * @return false if there is no connection.
+   */
+  bool stats(ConnectionStats &stats);
+  /**
+   * Closes connection.
+   */
+  void disconnect();
+
+ private:
+  template <typename Message>
+  bool doSend(Message &&message);
+  std::shared_ptr<ShmConnection> connection() const;
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+  void onSendQueueHigh(ConnectionId connectionId) override;
+  void onWritable(ConnectionId connectionId) override;
+  void onConnectionClosed(ConnectionId connectionId) override;
+
+  boost::asio::io_context &m_ioContext;
+  std::shared_ptr<ShmConnection> m_connection;
+  Observer &m_observer;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,472 @@
+#include "ShmConnection.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+
+#include "Logging.hpp"
+
+namespace {
+constexpr size_t f_messageMaxSize{std::numeric_limits<uint32_t>::max()};
+constexpr size_t f_ringMinSize{4096};
+constexpr size_t f_serverToClient{0};
+constexpr size_t f_clientToServer{1};
+constexpr size_t f_descriptorCount{3};
+
+struct SegmentHeader {
+  std::array<example::ShmRing::Control, 2> rings;
+  uint64_t ringSize;
+};
+
+class Descriptor {
+ public:
+  explicit Descriptor(int descriptor = -1) : m_descriptor{descriptor} {}
+  Descriptor(const Descriptor &) = delete;
+  Descriptor &operator=(const Descriptor &) = delete;
+  ~Descriptor() {
+    if (m_descriptor >= 0) {
+      ::close(m_descriptor);
+    }
+  }
+  int get() const { return m_descriptor; }
+  int release() { return std::exchange(m_descriptor, -1); }
+
+ private:
+  int m_descriptor;
+};
+
+size_t ringSize(size_t requestedSize) {
+  size_t size{f_ringMinSize};
+  while (size < requestedSize) {
+    size <<= 1;
+  }
+  return size;
+}
+
+size_t segmentSize(size_t ringSize) {
+  return sizeof(SegmentHeader) + 2 * ringSize;
+}
+
+example::ShmRing ring(char *memory, size_t index) {
+  auto *header = reinterpret_cast<SegmentHeader *>(memory);
+  return {header->rings[index],
+          memory + sizeof(SegmentHeader) + index * header->ringSize,
+          header->ringSize};
+}
+
+bool sendDescriptors(int socket,
+                     const std::array<int, f_descriptorCount> &descriptors) {
+  char byte{0};
+  iovec data{&byte, sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(descriptors))]{};
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  auto *controlMessage = CMSG_FIRSTHDR(&message);
+  controlMessage->cmsg_level = SOL_SOCKET;
+  controlMessage->cmsg_type = SCM_RIGHTS;
+  controlMessage->cmsg_len = CMSG_LEN(sizeof(descriptors));
+  std::memcpy(CMSG_DATA(controlMessage), descriptors.data(),
+              sizeof(descriptors));
+  return ::sendmsg(socket, &message, MSG_NOSIGNAL) == sizeof(byte);
+}
+
+bool receiveDescriptors(int socket,
+                        std::array<int, f_descriptorCount> &descriptors) {
+  char byte;
+  iovec data{&byte, sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * f_descriptorCount)];
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  if (::recvmsg(socket, &message, MSG_CMSG_CLOEXEC) != sizeof(byte)) {
+    return false;
+  }
+  auto *controlMessage = CMSG_FIRSTHDR(&message);
+  if (!controlMessage || controlMessage->cmsg_level != SOL_SOCKET ||
+      controlMessage->cmsg_type != SCM_RIGHTS ||
+      controlMessage->cmsg_len != CMSG_LEN(sizeof(int) * f_descriptorCount)) {
+    return false;
+  }
+  std::memcpy(descriptors.data(), CMSG_DATA(controlMessage),
+              sizeof(descriptors));
+  return true;
+}
+
+void signal(int notification) {
+  uint64_t count{1};
+  [[maybe_unused]] auto result = ::write(notification, &count, sizeof(count));
+}
+
+void notifyIfWaiting(std::atomic<uint32_t> &isWaiting, int notification) {
+  if (isWaiting.load(std::memory_order_seq_cst) != 0 &&
+      isWaiting.exchange(0) != 0) {
+    signal(notification);
+  }
+}
+}  // namespace
+
+namespace example {
+ShmConnection::ShmConnection(ConstructionKey, Socket &&socket, char *memory,
+                             size_t memorySize, int notification,
+                             int peerNotification, bool isServer,
+                             Observer &observer, const Framing &framing,
+                             const ConnectionOptions &options,
+                             TrafficMetrics *parentMetrics, ConnectionId id)
+    : m_socket{std::move(socket)},
+      m_notification{m_socket.get_executor(), notification},
+      m_peerNotification{peerNotification},
+      m_memory{memory},
+      m_memorySize{memorySize},
+      m_receiveRing{
+          ring(memory, isServer ? f_clientToServer : f_serverToClient)},
+      m_sendRing{ring(memory, isServer ? f_serverToClient : f_clientToServer)},
+      m_readBuffer{},
+      m_writeQueue{},
+      m_batch{},
+      m_writeMutex{},
+      m_observer{observer},
+      m_framing{framing},
+      m_options{options},
+      m_metrics{parentMetrics},
+      m_creationTime{std::chrono::steady_clock::now()},
+      m_receiveTime{m_creationTime},
+      m_hasPendingBytes{false},
+      m_isSendQueueHigh{false},
+      m_isClosed{false},
+      m_peerByte{0},
+      m_id{id} {}
+
+ShmConnection::~ShmConnection() {
+  ::munmap(m_memory, m_memorySize);
+  ::close(m_peerNotification);
+}
+
+std::shared_ptr<ShmConnection> ShmConnection::accept(
+    Socket &&socket, Observer &observer, const Framing &framing,
+    const ConnectionOptions &options, TrafficMetrics *parentMetrics,
+    ConnectionId id) {
+  auto size = ringSize(options.sharedMemoryRingSize);
+  Descriptor memoryDescriptor{::memfd_create("example", MFD_CLOEXEC)};
+  Descriptor notification{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+  Descriptor peerNotification{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+  if (memoryDescriptor.get() < 0 || notification.get() < 0 ||
+      peerNotification.get() < 0 ||
+      ::ftruncate(memoryDescriptor.get(), segmentSize(size)) != 0) {
+    EXAMPLE_LOG_ERROR("SHM Connection Accept error: ", std::strerror(errno));
+    return nullptr;
+  }
+  auto *memory = ::mmap(nullptr, segmentSize(size), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, memoryDescriptor.get(), 0);
+  if (memory == MAP_FAILED) {
+    EXAMPLE_LOG_ERROR("SHM Connection Accept error: ", std::strerror(errno));
+    return nullptr;
+  }
+  auto *header = new (memory) SegmentHeader{};
+  header->ringSize = size;
+  if (!sendDescriptors(socket.native_handle(),
+                       {memoryDescriptor.get(), peerNotification.get(),
+                        notification.get()})) {
+    EXAMPLE_LOG_ERROR("SHM Connection Accept error: ", std::strerror(errno));
+    ::munmap(memory, segmentSize(size));
+    return nullptr;
+  }
+  return std::make_shared<ShmConnection>(
+      ConstructionKey{}, std::move(socket), static_cast<char *>(memory),
+      segmentSize(size), notification.release(), peerNotification.release(),
+      true, observer, framing, options, parentMetrics, id);
+}
+
+std::shared_ptr<ShmConnection> ShmConnection::connect(
+    Socket &&socket, Observer &observer, const Framing &framing,
+    const ConnectionOptions &options, ConnectionId id) {
+  std::array<int, f_descriptorCount> descriptors;
+  if (!receiveDescriptors(socket.native_handle(), descriptors)) {
+    EXAMPLE_LOG_ERROR("SHM Connection Connect error: no segment received");
+    return nullptr;
+  }
+  Descriptor memoryDescriptor{descriptors[0]};
+  Descriptor notification{descriptors[1]};
+  Descriptor peerNotification{descriptors[2]};
+  struct stat status;
+  if (::fstat(memoryDescriptor.get(), &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(SegmentHeader)) {
+    EXAMPLE_LOG_ERROR("SHM Connection Connect error: invalid segment");
+    return nullptr;
+  }
+  auto size = static_cast<size_t>(status.st_size);
+  auto *memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        memoryDescriptor.get(), 0);
+  if (memory == MAP_FAILED) {
+    EXAMPLE_LOG_ERROR("SHM Connection Connect error: ", std::strerror(errno));
+    return nullptr;
+  }
+  auto ringSize = static_cast<SegmentHeader *>(memory)->ringSize;
+  // rings smaller than the server ever creates are rejected, including an
+  // empty ring, which would pass the power of two check.
+  if (ringSize < f_ringMinSize || (ringSize & (ringSize - 1)) != 0 ||
+      segmentSize(ringSize) != size) {
+    EXAMPLE_LOG_ERROR("SHM Connection Connect error: invalid segment");
+    ::munmap(memory, size);
+    return nullptr;
+  }
+  return std::make_shared<ShmConnection>(
+      ConstructionKey{}, std::move(socket), static_cast<char *>(memory), size,
+      notification.release(), peerNotification.release(), false, observer,
+      framing, options, nullptr, id);
+}
+
+void ShmConnection::startReceiving() {
+  m_receiveTime = std::chrono::steady_clock::now();
+  watchPeer();
+  auto self = shared_from_this();
+  boost::asio::post(m_socket.get_executor(), [this, self]() { receive(); });
+}
+
+bool ShmConnection::send(const std::string &message) {
+  return enqueue(message, message);
+}
+
+bool ShmConnection::send(std::string &&message) {
+  std::string_view view{message};
+  return enqueue(std::move(message), view);
+}
+
+bool ShmConnection::send(std::shared_ptr<const Buffer> message) {
+  if (!message) {
+    return false;
+  }
+  std::string_view view{*message};
+  return enqueue(std::move(message), view);
+}
+
+size_t ShmConnection::pendingBytes() {
+  std::lock_guard<std::mutex> guard{m_writeMutex};
+  return m_writeQueue.size();
+}
+
+ConnectionStats ShmConnection::stats() {
+  ConnectionStats stats;
+  static_cast<TrafficStats &>(stats) = m_metrics.stats();
+  stats.pendingBytes = pendingBytes();
+  stats.lifetime = std::chrono::steady_clock::now() - m_creationTime;
+  return stats;
+}
+
+void ShmConnection::close() {
+  if (m_isClosed) {
+    return;
+  }
+  m_isClosed = true;
+  boost::system::error_code error;
+  m_socket.close(error);
+  m_notification.close(error);
+  m_observer.onConnectionClosed(m_id);
+}
+
+template <typename Payload>
+bool ShmConnection::enqueue(Payload &&payload, std::string_view message) {
+  if (m_isClosed) {
+    return false;
+  }
+  if (message.size() > f_messageMaxSize) {
+    EXAMPLE_LOG_ERROR("SHM Connection Send error: message is too large");
+    return false;
+  }
+  char header[Framing::maxHeaderSize];
+  auto headerSize = m_framing.encode({message.size(), 0}, header);
+  auto size = headerSize + message.size();
+  std::unique_lock<std::mutex> guard{m_writeMutex};
+  if (m_writeQueue.size() >= m_options.sendQueueHighWatermark) {
+    return false;
+  }
+  if (m_writeQueue.empty() && m_sendRing.writableSize() >= size) {
+    m_sendRing.write(header, headerSize);
+    m_sendRing.write(message.data(), message.size());
+    m_metrics.recordWritten(size, size);
+    m_metrics.recordSent(std::chrono::nanoseconds{0});
+    guard.unlock();
+    notifyIfWaiting(m_sendRing.control().isReaderWaiting, m_peerNotification);
+    return true;
+  }
+  push(header, headerSize, std::forward<Payload>(payload));
+  writePending();
+  auto isSendQueueHigh =
+      !m_isSendQueueHigh &&
+      m_writeQueue.size() >= m_options.sendQueueHighWatermark;
+  m_isSendQueueHigh = m_isSendQueueHigh || isSendQueueHigh;
+  guard.unlock();
+  notifyIfWaiting(m_sendRing.control().isReaderWaiting, m_peerNotification);
+  if (isSendQueueHigh) {
+    m_observer.onSendQueueHigh(m_id);
+  }
+  return true;
+}
+
+void ShmConnection::push(const char *header, size_t headerSize,
+                         const std::string &payload) {
+  auto buffer = BufferPool::acquire();
+  buffer.assign(payload);
+  m_writeQueue.push(header, headerSize, std::move(buffer));
+}
+
+void ShmConnection::push(const char *header, size_t headerSize,
+                         std::string &&payload) {
+  m_writeQueue.push(header, headerSize, std::move(payload));
+}
+
+void ShmConnection::push(const char *header, size_t headerSize,
+                         std::shared_ptr<const Buffer> payload) {
+  m_writeQueue.push(header, headerSize, std::move(payload));
+}
+
+void ShmConnection::writePending() {
+  while (!m_writeQueue.empty()) {
+    auto pendingBytes = m_writeQueue.size();
+    size_t size{0};
+    for (const auto &buffer : m_writeQueue.buffers()) {
+      auto written = m_sendRing.write(static_cast<const char *>(buffer.data()),
+                                      buffer.size());
+      size += written;
+      if (written < buffer.size()) {
+        break;
+      }
+    }
+    if (size > 0) {
+      m_metrics.recordWritten(size, pendingBytes);
+      m_writeQueue.consume(size, m_metrics);
+      continue;
+    }
+    m_sendRing.control().isWriterWaiting.store(1, std::memory_order_seq_cst);
+    if (m_sendRing.writableSize() == 0) {
+      break;
+    }
+  }
+  m_hasPendingBytes.store(!m_writeQueue.empty(), std::memory_order_relaxed);
+}
+
+void ShmConnection::flush() {
+  std::unique_lock<std::mutex> guard{m_writeMutex};
+  writePending();
+  auto isWritable = m_isSendQueueHigh &&
+                    m_writeQueue.size() <= m_options.sendQueueLowWatermark;
+  m_isSendQueueHigh = m_isSendQueueHigh && !isWritable;
+  guard.unlock();
+  notifyIfWaiting(m_sendRing.control().isReaderWaiting, m_peerNotification);
+  if (isWritable) {
+    m_observer.onWritable(m_id);
+  }
+}
+
+void ShmConnection::receive() {
+  if (m_isClosed) {
+    return;
+  }
+  if (m_hasPendingBytes.load(std::memory_order_relaxed)) {
+    flush();
+  }
+  auto size = m_receiveRing.readableSize();
+  auto now = std::chrono::steady_clock::now();
+  if (size > 0) {
+    auto buffer = m_readBuffer.prepare(size);
+    m_receiveRing.read(static_cast<char *>(buffer.data()), size);
+    m_readBuffer.commit(size);
+    notifyIfWaiting(m_receiveRing.control().isWriterWaiting,
+                    m_peerNotification);
+    if (!deliver()) {
+      EXAMPLE_LOG_ERROR("SHM Connection Read error: invalid message header");
+      return close();
+    }
+    m_metrics.recordReceived(size, m_batch.size());
+    m_receiveTime = now;
+  } else if (now - m_receiveTime >= m_options.busyPollDuration) {
+    return wait();
+  }
+  auto self = shared_from_this();
+  boost::asio::post(m_socket.get_executor(), [this, self]() { receive(); });
+}
+
+void ShmConnection::wait() {
+  if (m_isClosed) {
+    return;
+  }
+  auto &isWaiting = m_receiveRing.control().isReaderWaiting;
+  isWaiting.store(1, std::memory_order_seq_cst);
+  auto self = shared_from_this();
+  if (m_receiveRing.readableSize() > 0) {
+    isWaiting.store(0, std::memory_order_relaxed);
+    boost::asio::post(m_socket.get_executor(), [this, self]() { receive(); });
+    return;
+  }
+  m_notification.async_wait(
+      boost::asio::posix::descriptor_base::wait_read,
+      [this, self](const auto &error) {
+        if (m_isClosed) {
+          return;
+        }
+        if (error) {
+          EXAMPLE_LOG_ERROR("SHM Connection Wait error: ", error.message());
+          return close();
+        }
+        uint64_t count;
+        [[maybe_unused]] auto result =
+            ::read(m_notification.native_handle(), &count, sizeof(count));
+        m_receiveRing.control().isReaderWaiting.store(
+            0, std::memory_order_relaxed);
+        m_receiveTime = std::chrono::steady_clock::now();
+        receive();
+      });
+}
+
+void ShmConnection::watchPeer() {
+  auto self = shared_from_this();
+  m_socket.async_read_some(
+      boost::asio::buffer(&m_peerByte, sizeof(m_peerByte)),
+      [this, self](const auto &error, [[maybe_unused]] auto size) {
+        if (m_isClosed) {
+          return;
+        }
+        if (!error) {
+          return watchPeer();
+        }
+        EXAMPLE_LOG_ERROR("SHM Connection Read error: ", error.message());
+        close();
+      });
+}
+
+bool ShmConnection::deliver() {
+  auto data = m_readBuffer.data();
+  auto size = m_readBuffer.size();
+  size_t offset{0};
+  m_batch.clear();
+  while (offset < size) {
+    FrameHeader header;
+    size_t headerSize;
+    if (!m_framing.decode(data + offset, size - offset, header, headerSize)) {
+      return false;
+    }
+    if (headerSize == 0 || size - offset < headerSize + header.size) {
+      break;
+    }
+    m_batch.emplace_back(
+        std::string_view{data + offset + headerSize, header.size},
+        &m_readBuffer.storage());
+    offset += headerSize + header.size;
+  }
+  if (!m_batch.empty()) {
+    m_observer.onReceivedBatch(
+        m_id, {m_batch.data(), m_batch.data() + m_batch.size()});
+  }
+  m_readBuffer.consume(offset);
+  return true;
+}
+}  // namespace example
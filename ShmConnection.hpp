@@ -0,0 +1,165 @@
+#ifndef EXAMPLE_SHM_CONNECTION_HPP
+#define EXAMPLE_SHM_CONNECTION_HPP
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <mutex>
+#include <vector>
+
+#include "Allocation.hpp"
+#include "ConnectionOptions.hpp"
+#include "Framing.hpp"
+#include "Message.hpp"
+#include "Metrics.hpp"
+#include "ReceiveBuffer.hpp"
+#include "ShmRing.hpp"
+#include "TcpConnection.hpp"
+#include "WriteQueue.hpp"
+
+namespace example {
+/**
+ * ShmConnection class exchanges framed messages with a process on the same
+ * host through a shared memory segment holding a ring in each direction.
+ * The segment and an eventfd per side are passed to the client through a
+ * connected Unix domain socket, which is then only used to detect that the
+ * peer has gone away. Messages are copied into the ring directly by the
+ * sending thread whenever it has room, and the receiving side is woken up
+ * only if it is waiting.
+ */
+class ShmConnection : public std::enable_shared_from_this<ShmConnection> {
+ public:
+  /**
+   * Socket type used for the handshake and for detecting peer closure.
+   */
+  using Socket = boost::asio::local::stream_protocol::socket;
+  /**
+   * Observer class allows monitoring of ShmConnection events, with the same
+   * interface as for a TcpConnection.
+   */
+  using Observer = TcpConnection::Observer;
+  /**
+   * Creates a ShmConnection instance at the server side of an accepted
+   * socket, creating the shared memory segment and passing it to the peer.
+   *
+   * @param socket accepted.
+   * @param observer to monitor ShmConnection events.
+   * @param framing used to delimit messages.
+   * @param options configuring the ShmConnection.
+   * @param parentMetrics where traffic counters are also added, or nullptr.
+   * @param id unique identifier the ShmConnection.
+   * @return connection, or nullptr if the segment could not be shared.
+   */
+  static std::shared_ptr<ShmConnection> accept(
+      Socket &&socket, Observer &observer, const Framing &framing,
+      const ConnectionOptions &options, TrafficMetrics *parentMetrics = nullptr,
+      ConnectionId id = 0);
+  /**
+   * Creates a ShmConnection instance at the client side of a connected
+   * socket, mapping the shared memory segment passed by the server. The
+   * socket must be readable.
+   *
+   * @param socket connected.
+   * @param observer to monitor ShmConnection events.
+   * @param framing used to delimit messages.
+   * @param options configuring the ShmConnection.
+   * @param id unique identifier the ShmConnection.
+   * @return connection, or nullptr if the segment could not be mapped.
+   */
+  static std::shared_ptr<ShmConnection> connect(
+      Socket &&socket, Observer &observer, const Framing &framing,
+      const ConnectionOptions &options, ConnectionId id = 0);
+  /**
+   * starts receiving messages and watching for peer closure.
+   */
+  void startReceiving();
+  /**
+   * sends string message to peer.
+   *
+   * @param message to send.
+   * @return false if the connection is closed or the send queue is full.
+   */
+  bool send(const std::string &message);
+  /**
+   * sends string message to peer, taking ownership of the message if it has
+   * to be queued.
+   *
+   * @param message to send.
+   * @return false if the connection is closed or the send queue is full.
+   */
+  bool send(std::string &&message);
+  /**
+   * sends message to peer, sharing ownership of the message payload if it
+   * has to be queued.
+   *
+   * @param message to send.
+   * @return false if the message is null, the connection is closed or the
+   * send queue is full.
+   */
+  bool send(std::shared_ptr<const Buffer> message);
+  /**
+   * returns number of bytes queued because the ring was full.
+   */
+  size_t pendingBytes();
+  /**
+   * returns a snapshot of the ShmConnection counters. It can be called from
+   * any thread.
+   */
+  ConnectionStats stats();
+  /**
+   * closes socket and notification descriptors. The shared memory segment
+   * is unmapped when the ShmConnection is destroyed.
+   */
+  void close();
+
+ private:
+  struct ConstructionKey {};
+
+ public:
+  ShmConnection(ConstructionKey, Socket &&socket, char *memory,
+                size_t memorySize, int notification, int peerNotification,
+                bool isServer, Observer &observer, const Framing &framing,
+                const ConnectionOptions &options,
+                TrafficMetrics *parentMetrics, ConnectionId id);
+  ~ShmConnection();
+
+ private:
+  template <typename Payload>
+  bool enqueue(Payload &&payload, std::string_view message);
+  void push(const char *header, size_t headerSize,
+            const std::string &payload);
+  void push(const char *header, size_t headerSize, std::string &&payload);
+  void push(const char *header, size_t headerSize,
+            std::shared_ptr<const Buffer> payload);
+  void writePending();
+  void flush();
+  void receive();
+  void wait();
+  void watchPeer();
+  bool deliver();
+
+  Socket m_socket;
+  boost::asio::posix::stream_descriptor m_notification;
+  const int m_peerNotification;
+  char *const m_memory;
+  const size_t m_memorySize;
+  ShmRing m_receiveRing;
+  ShmRing m_sendRing;
+  ReceiveBuffer m_readBuffer;
+  WriteQueue m_writeQueue;
+  std::vector<MessageView> m_batch;
+  std::mutex m_writeMutex;
+  Observer &m_observer;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+  TrafficMetrics m_metrics;
+  const std::chrono::steady_clock::time_point m_creationTime;
+  std::chrono::steady_clock::time_point m_receiveTime;
+  std::atomic<bool> m_hasPendingBytes;
+  bool m_isSendQueueHigh;
+  std::atomic<bool> m_isClosed;
+  char m_peerByte;
+  ConnectionId m_id;
+};
+}  // namespace example
+
+#endif
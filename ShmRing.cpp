@@ -0,0 +1,59 @@
+#include "ShmRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// positions are published and read with sequential consistency, so that a
+// peer setting a waiting flag and then checking the positions is never missed
+// by a side updating the positions and then checking the flag.
+constexpr auto f_ordered{std::memory_order_seq_cst};
+constexpr auto f_relaxed{std::memory_order_relaxed};
+}  // namespace
+
+namespace example {
+ShmRing::ShmRing(Control &control, char *data, size_t capacity)
+    : m_control{control}, m_data{data}, m_capacity{capacity} {}
+
+size_t ShmRing::readableSize() const {
+  auto size = m_control.writePosition.load(f_ordered) -
+              m_control.readPosition.load(f_relaxed);
+  return std::min<uint64_t>(size, m_capacity);
+}
+
+size_t ShmRing::writableSize() const {
+  auto size = m_control.writePosition.load(f_relaxed) -
+              m_control.readPosition.load(f_ordered);
+  return m_capacity - std::min<uint64_t>(size, m_capacity);
+}
+
+size_t ShmRing::write(const char *data, size_t size) {
+  size = std::min(size, writableSize());
+  if (size == 0) {
+    return 0;
+  }
+  auto position = m_control.writePosition.load(f_relaxed);
+  auto offset = position & (m_capacity - 1);
+  auto firstSize = std::min(size, m_capacity - offset);
+  std::memcpy(m_data + offset, data, firstSize);
+  std::memcpy(m_data, data + firstSize, size - firstSize);
+  m_control.writePosition.store(position + size, f_ordered);
+  return size;
+}
+
+size_t ShmRing::read(char *buffer, size_t size) {
+  size = std::min(size, readableSize());
+  if (size == 0) {
+    return 0;
+  }
+  auto position = m_control.readPosition.load(f_relaxed);
+  auto offset = position & (m_capacity - 1);
+  auto firstSize = std::min(size, m_capacity - offset);
+  std::memcpy(buffer, m_data + offset, firstSize);
+  std::memcpy(buffer + firstSize, m_data, size - firstSize);
+  m_control.readPosition.store(position + size, f_ordered);
+  return size;
+}
+
+ShmRing::Control &ShmRing::control() { return m_control; }
+}  // namespace example
@@ -0,0 +1,78 @@
+#ifndef EXAMPLE_SHM_RING_HPP
+#define EXAMPLE_SHM_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace example {
+/**
+ * ShmRing class transfers a stream of bytes from a single producer to a
+ * single consumer through memory that can be shared between processes.
+ * Positions grow monotonically and are masked by the capacity, which must be
+ * a power of two.
+ */
+class ShmRing {
+ public:
+  /**
+   * Control struct holds the positions and flags of a ring, each in its own
+   * cache line so that producer and consumer do not invalidate each other.
+   */
+  struct Control {
+    /** bytes read by the consumer since the ring was created. */
+    alignas(64) std::atomic<uint64_t> readPosition{0};
+    /** bytes written by the producer since the ring was created. */
+    alignas(64) std::atomic<uint64_t> writePosition{0};
+    /** set by the consumer before waiting for a notification. */
+    alignas(64) std::atomic<uint32_t> isReaderWaiting{0};
+    /** set by the producer before waiting for free space. */
+    alignas(64) std::atomic<uint32_t> isWriterWaiting{0};
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                    std::atomic<uint32_t>::is_always_lock_free,
+                "shared memory atomics must be lock free");
+  /**
+   * Constructs a ShmRing object.
+   *
+   * @param control of the ring, placed in shared memory.
+   * @param data of the ring, placed in shared memory.
+   * @param capacity of the data in bytes, a power of two.
+   */
+  ShmRing(Control &control, char *data, size_t capacity);
+  /**
+   * returns number of bytes that can be read.
+   */
+  size_t readableSize() const;
+  /**
+   * returns number of bytes that can be written.
+   */
+  size_t writableSize() const;
+  /**
+   * copies bytes into the ring. Called only by the producer.
+   *
+   * @param data to copy.
+   * @param size in bytes of the data.
+   * @return number of bytes copied, lower than size if the ring is full.
+   */
+  size_t write(const char *data, size_t size);
+  /**
+   * copies bytes out of the ring. Called only by the consumer.
+   *
+   * @param buffer to copy to.
+   * @param size in bytes of the buffer.
+   * @return number of bytes copied, lower than size if the ring is empty.
+   */
+  size_t read(char *buffer, size_t size);
+  /**
+   * returns control of the ring.
+   */
+  Control &control();
+
+ private:
+  Control &m_control;
+  char *m_data;
+  const size_t m_capacity;
+};
+}  // namespace example
+
+#endif
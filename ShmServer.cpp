@@ -0,0 +1,142 @@
+#include "ShmServer.hpp"
+
+#include <filesystem>
+
+#include "Logging.hpp"
+
+namespace example {
+ShmServer::ShmServer(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : m_acceptor{ioContext},
+      m_connections{},
+      m_observer{observer},
+      m_framing{framing},
+      m_options{options},
+      m_metrics{},
+      m_isAccepting{false},
+      m_isClosing{false} {}
+
+bool ShmServer::listen(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  std::error_code error;
+  if (std::filesystem::is_socket(endpoint.path(), error)) {
+    std::filesystem::remove(endpoint.path(), error);
+  }
+  try {
+    m_acceptor.open(endpoint.protocol());
+    m_acceptor.bind(endpoint);
+    m_acceptor.listen(boost::asio::socket_base::max_connections);
+  } catch (const std::exception &e) {
+    EXAMPLE_LOG_ERROR("SHM Server Listen exception: ", e.what());
+    return false;
+  }
+  return true;
+}
+
+void ShmServer::startAcceptingConnections() {
+  if (!m_isAccepting) {
+    doAccept();
+  }
+}
+
+bool ShmServer::send(ConnectionId connectionId, const std::string &message) {
+  return doSend(connectionId, message);
+}
+
+bool ShmServer::send(ConnectionId connectionId, std::string &&message) {
+  return doSend(connectionId, std::move(message));
+}
+
+bool ShmServer::send(ConnectionId connectionId,
+                     std::shared_ptr<const Buffer> message) {
+  return doSend(connectionId, std::move(message));
+}
+
+ServerStats ShmServer::stats() const { return m_metrics.stats(); }
+
+bool ShmServer::stats(ConnectionId connectionId, ConnectionStats &stats) {
+  auto connection = m_connections.find(connectionId);
+  if (!connection) {
+    return false;
+  }
+  stats = (*connection)->stats();
+  return true;
+}
+
+void ShmServer::close() {
+  m_isClosing = true;
+  m_acceptor.cancel();
+  for (const auto &connection : m_connections) {
+    connection->close();
+    m_metrics.recordClosed(connection->stats().lifetime);
+  }
+  m_connections.clear();
+  m_isClosing = false;
+  EXAMPLE_LOG_INFO("SHM Server was closed");
+}
+
+template <typename Message>
+bool ShmServer::doSend(ConnectionId connectionId, Message &&message) {
+  auto connection = m_connections.find(connectionId);
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("SHM Server Send error: connection not found");
+    return false;
+  }
+  return (*connection)->send(std::forward<Message>(message));
+}
+
+void ShmServer::doAccept() {
+  m_isAccepting = true;
+  m_acceptor.async_accept([this](const auto &error, auto socket) {
+    if (error) {
+      EXAMPLE_LOG_ERROR("SHM Server Accept error: ", error.message());
+      if (error != boost::asio::error::operation_aborted) {
+        m_metrics.recordAcceptError();
+      }
+      m_isAccepting = false;
+      return;
+    }
+    auto connectionId = m_connections.insert(nullptr);
+    auto connection{ShmConnection::accept(std::move(socket), *this, m_framing,
+                                          m_options, &m_metrics.traffic(),
+                                          connectionId)};
+    if (connection) {
+      *m_connections.find(connectionId) = connection;
+      connection->startReceiving();
+      m_metrics.recordAccepted();
+      EXAMPLE_LOG_INFO("SHM Server accepted connection");
+      m_observer.onConnectionAccepted(connectionId);
+    } else {
+      m_connections.erase(connectionId);
+      m_metrics.recordAcceptError();
+    }
+    doAccept();
+  });
+}
+
+void ShmServer::onReceivedBatch(ConnectionId connectionId,
+                                const MessageBatch &messages) {
+  m_observer.onReceivedBatch(connectionId, messages);
+}
+
+void ShmServer::onSendQueueHigh(ConnectionId connectionId) {
+  m_observer.onSendQueueHigh(connectionId);
+}
+
+void ShmServer::onWritable(ConnectionId connectionId) {
+  m_observer.onWritable(connectionId);
+}
+
+void ShmServer::onConnectionClosed(ConnectionId connectionId) {
+  if (m_isClosing) {
+    return;
+  }
+  auto connection = m_connections.find(connectionId);
+  if (connection) {
+    m_metrics.recordClosed((*connection)->stats().lifetime);
+    m_connections.erase(connectionId);
+    EXAMPLE_LOG_INFO("SHM Server removed connection");
+    m_observer.onConnectionClosed(connectionId);
+  }
+}
+}  // namespace example
@@ -0,0 +1,112 @@
+#ifndef EXAMPLE_SHM_SERVER_HPP
+#define EXAMPLE_SHM_SERVER_HPP
+
+#include <boost/asio.hpp>
+
+#include "ShmConnection.hpp"
+#include "SlotMap.hpp"
+#include "TcpServer.hpp"
+
+namespace example {
+/**
+ * ShmServer class allows to accept shared memory connections from processes
+ * on the same host through a Unix domain socket at specified path. It
+ * notifies the same observer as a TcpServer, so that an application can
+ * switch between transports by choosing which server to construct.
+ */
+class ShmServer : private ShmConnection::Observer {
+ public:
+  /**
+   * Observer class allows monitoring of ShmServer events.
+   */
+  using Observer = TcpServer::Observer;
+  /**
+   * Constructs a ShmServer object.
+   *
+   * @param ioContext required for asynchronous input and output operations.
+   * @param observer to monitor ShmServer events.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
+   */
+  ShmServer(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::binary(),
+            const ConnectionOptions &options = {});
+  /**
+   * listen for connections at specified Unix domain socket path, replacing
+   * any socket file left at the path.
+   *
+   * @param endpoint to listen at.
+   */
+  bool listen(const boost::asio::local::stream_protocol::endpoint &endpoint);
+  /**
+   * starts accepting connections and associated asynchronous operations.
+   */
+  void startAcceptingConnections();
+  /**
+   * Sends string message to peer associated to specified connection.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, const std::string &message);
+  /**
+   * Sends string message to peer associated to specified connection, taking
+   * ownership of the message if it has to be queued.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, std::string &&message);
+  /**
+   * Sends message to peer associated to specified connection, sharing
+   * ownership of the message payload if it has to be queued.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, std::shared_ptr<const Buffer> message);
+  /**
+   * returns a snapshot of the counters of the ShmServer and its connections,
+   * including connections already closed. It can be called from any thread.
+   */
+  ServerStats stats() const;
+  /**
+   * gets a snapshot of the counters of specified connection.
+   *
+   * @param connectionId unique identifier of the connection.
+   * @param stats of the connection.
+   * @return false if the connection does not exist.
+   */
+  bool stats(ConnectionId connectionId, ConnectionStats &stats);
+  /**
+   * Close active connections and stops accepting new connections. In order to
+   * restart operation, a call to functions listen() and
+   * startAcceptingConnections() is required.
+   */
+  void close();
+
+ private:
+  template <typename Message>
+  bool doSend(ConnectionId connectionId, Message &&message);
+  void doAccept();
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+  void onSendQueueHigh(ConnectionId connectionId) override;
+  void onWritable(ConnectionId connectionId) override;
+  void onConnectionClosed(ConnectionId connectionId) override;
+
+  boost::asio::local::stream_protocol::acceptor m_acceptor;
+  SlotMap<std::shared_ptr<ShmConnection>> m_connections;
+  Observer &m_observer;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+  ServerMetrics m_metrics;
+  bool m_isAccepting;
+  bool m_isClosing;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef EXAMPLE_SLOT_MAP_HPP
+#define EXAMPLE_SLOT_MAP_HPP
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace example {
+/**
+ * SlotMap class stores values in a dense array and identifies them by 64-bit
+ * handles made of a slot index and a generation. Lookups by handle take
+ * constant time without hashing, and the generation of a slot is
+ * incremented whenever its value is erased, so that stale handles are
+ * detected instead of referring to a newer value. The handle index space
+ * can be partitioned among several maps, so that the map owning a handle is
+ * known from the handle.
+ */
+template <typename T>
+class SlotMap {
+ public:
+  /**
+   * Handle type identifying a value, never equal to invalidHandle.
+   */
+  using Handle = uint64_t;
+  /**
+   * handle never returned by insert().
+   */
+  static constexpr Handle invalidHandle{0};
+  /**
+   * returns the partition of a handle.
+   *
+   * @param handle returned by a SlotMap.
+   * @param partitionCount number of partitions of the handle index space.
+   */
+  static uint32_t partitionOf(Handle handle, uint32_t partitionCount) {
+    return static_cast<uint32_t>(handle) % partitionCount;
+  }
+  /**
+   * Constructs an empty SlotMap object.
+   *
+   * @param partition of the handle index space used by the SlotMap.
+   * @param partitionCount number of partitions of the handle index space.
+   */
+  explicit SlotMap(uint32_t partition = 0, uint32_t partitionCount = 1)
+      : m_slots{},
+        m_values{},
+        m_valueSlots{},
+        m_freeSlot{noSlot},
+        m_partition{partition},
+        m_partitionCount{partitionCount} {}
+  /**
+   * inserts a value.
+   *
+   * @param value to insert.
+   * @return handle identifying the value.
+   */
+  Handle insert(T value) {
+    uint32_t slotIndex;
+    if (m_freeSlot != noSlot) {
+      slotIndex = m_freeSlot;
+      m_freeSlot = m_slots[slotIndex].position;
+    } else {
+      slotIndex = static_cast<uint32_t>(m_slots.size());
+      m_slots.push_back({1, 0});
+    }
+    auto &slot = m_slots[slotIndex];
+    slot.position = static_cast<uint32_t>(m_values.size());
+    m_values.push_back(std::move(value));
+    m_valueSlots.push_back(slotIndex);
+    return handle(slotIndex, slot.generation);
+  }
+  /**
+   * returns value identified by a handle, or nullptr if the handle is stale
+   * or was not returned by this SlotMap.
+   *
+   * @param handle of the value.
+   */
+  T *find(Handle handle) {
+    auto slotIndex = this->slotIndex(handle);
+    if (slotIndex >= m_slots.size() ||
+        m_slots[slotIndex].generation != generation(handle) ||
+        !isOccupied(slotIndex)) {
+      return nullptr;
+    }
+    return &m_values[m_slots[slotIndex].position];
+  }
+  /**
+   * erases value identified by a handle, moving the last value into its
+   * position.
+   *
+   * @param handle of the value.
+   * @return false if the handle is stale or was not returned by this
+   * SlotMap.
+   */
+  bool erase(Handle handle) {
+    if (!find(handle)) {
+      return false;
+    }
+    auto slotIndex = this->slotIndex(handle);
+    auto &slot = m_slots[slotIndex];
+    auto position = slot.position;
+    if (position + 1 != m_values.size()) {
+      m_values[position] = std::move(m_values.back());
+      m_valueSlots[position] = m_valueSlots.back();
+      m_slots[m_valueSlots[position]].position = position;
+    }
+    m_values.pop_back();
+    m_valueSlots.pop_back();
+    // a slot whose generation would wrap around is retired, so that a handle
+    // is never reused.
+    if (++slot.generation != 0) {
+      slot.position = m_freeSlot;
+      m_freeSlot = slotIndex;
+    }
+    return true;
+  }
+  /**
+   * erases every value. Handles of erased values remain stale.
+   */
+  void clear() {
+    while (!m_values.empty()) {
+      erase(handle(m_valueSlots.back(),
+                   m_slots[m_valueSlots.back()].generation));
+    }
+  }
+  /**
+   * returns number of values.
+   */
+  size_t size() const { return m_values.size(); }
+  /**
+   * returns true if there are no values.
+   */
+  bool empty() const { return m_values.empty(); }
+  /**
+   * returns iterator to the first of the contiguous values.
+   */
+  typename std::vector<T>::iterator begin() { return m_values.begin(); }
+  /**
+   * returns iterator past the last of the contiguous values.
+   */
+  typename std::vector<T>::iterator end() { return m_values.end(); }
+
+ private:
+  struct Slot {
+    uint32_t generation;
+    uint32_t position;
+  };
+
+  static constexpr uint32_t noSlot{std::numeric_limits<uint32_t>::max()};
+
+  Handle handle(uint32_t slotIndex, uint32_t generation) const {
+    auto index = static_cast<uint64_t>(slotIndex) * m_partitionCount +
+                 m_partition;
+    return (static_cast<uint64_t>(generation) << 32) | index;
+  }
+  uint32_t slotIndex(Handle handle) const {
+    auto index = static_cast<uint32_t>(handle);
+    if (index % m_partitionCount != m_partition) {
+      return noSlot;
+    }
+    return index / m_partitionCount;
+  }
+  static uint32_t generation(Handle handle) {
+    return static_cast<uint32_t>(handle >> 32);
+  }
+  bool isOccupied(uint32_t slotIndex) const {
+    auto position = m_slots[slotIndex].position;
+    return position < m_valueSlots.size() &&
+           m_valueSlots[position] == slotIndex;
+  }
+
+  std::vector<Slot> m_slots;
+  std::vector<T> m_values;
+  std::vector<uint32_t> m_valueSlots;
+  uint32_t m_freeSlot;
+  const uint32_t m_partition;
+  const uint32_t m_partitionCount;
+};
+}  // namespace example
+
+#endif
@@ -0,0 +1,68 @@
+#include "SocketOptions.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include "Logging.hpp"
+
+namespace {
+bool isTcp(int socket) {
+  sockaddr_storage address{};
+  socklen_t size{sizeof(address)};
+  if (getsockname(socket, reinterpret_cast<sockaddr *>(&address), &size) !=
+      0) {
+    return false;
+  }
+  return address.ss_family == AF_INET || address.ss_family == AF_INET6;
+}
+
+bool setOption(int socket, int level, int name, int value,
+               const char *description) {
+  if (setsockopt(socket, level, name, &value, sizeof(value)) == 0) {
+    return true;
+  }
+  EXAMPLE_LOG_ERROR("Socket Option error: ", description, ": ",
+                    std::error_code{errno, std::system_category()}.message());
+  return false;
+}
+}  // namespace
+
+namespace example {
+bool applySocketOptions(int socket, const SocketOptions &options) {
+  auto isApplied{true};
+  if (options.sendBufferSize > 0) {
+    isApplied &= setOption(socket, SOL_SOCKET, SO_SNDBUF,
+                           options.sendBufferSize, "SO_SNDBUF");
+  }
+  if (options.receiveBufferSize > 0) {
+    isApplied &= setOption(socket, SOL_SOCKET, SO_RCVBUF,
+                           options.receiveBufferSize, "SO_RCVBUF");
+  }
+  if (!isTcp(socket)) {
+    return isApplied;
+  }
+  isApplied &= setOption(socket, IPPROTO_TCP, TCP_NODELAY, options.noDelay,
+                         "TCP_NODELAY");
+  if (options.quickAck) {
+    isApplied &= setQuickAck(socket);
+  }
+  if (options.busyPoll.count() > 0) {
+    isApplied &= setOption(socket, SOL_SOCKET, SO_BUSY_POLL,
+                           static_cast<int>(options.busyPoll.count()),
+                           "SO_BUSY_POLL");
+  }
+  return isApplied;
+}
+
+bool setQuickAck(int socket) {
+  return setOption(socket, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+}
+
+bool enableZeroCopy(int socket) {
+  return setOption(socket, SOL_SOCKET, SO_ZEROCOPY, 1, "SO_ZEROCOPY");
+}
+}  // namespace example
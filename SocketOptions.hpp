@@ -0,0 +1,74 @@
+#ifndef EXAMPLE_SOCKET_OPTIONS_HPP
+#define EXAMPLE_SOCKET_OPTIONS_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace example {
+/**
+ * SocketOptions struct tunes the sockets of the connections of a server or a
+ * client. Options specific to TCP are ignored by Unix domain sockets.
+ */
+struct SocketOptions {
+  /**
+   * disables Nagle's algorithm, so that small messages are not delayed
+   * waiting for the acknowledgement of previous ones. Queued messages are
+   * already coalesced into gather writes.
+   */
+  bool noDelay{true};
+  /**
+   * acknowledges received segments immediately instead of delaying the
+   * acknowledgement. The kernel may clear it, so it is set again after every
+   * read.
+   */
+  bool quickAck{false};
+  /**
+   * size in bytes of the kernel send buffer, or zero to keep the system
+   * default.
+   */
+  int sendBufferSize{0};
+  /**
+   * size in bytes of the kernel receive buffer, or zero to keep the system
+   * default. It is also set on listening sockets and before connecting, so
+   * that the TCP window scale is negotiated for it.
+   */
+  int receiveBufferSize{0};
+  /**
+   * time the kernel busy polls the device queue for received packets when
+   * there are none, or zero to disable it.
+   */
+  std::chrono::microseconds busyPoll{0};
+  /**
+   * size in bytes from which message payloads are sent with MSG_ZEROCOPY
+   * instead of being copied into the kernel, or zero to disable it. Each
+   * payload is kept until the kernel reports its transmission. Zero copy is
+   * disabled for a connection when the kernel reports having copied a
+   * payload anyway, as it does for loopback peers.
+   */
+  size_t zeroCopyThreshold{0};
+};
+/**
+ * applies socket options to a socket, logging options that cannot be set.
+ *
+ * @param socket native handle.
+ * @param options to apply.
+ * @return false if an option could not be set.
+ */
+bool applySocketOptions(int socket, const SocketOptions &options);
+/**
+ * sets TCP quick acknowledgements again on a socket.
+ *
+ * @param socket native handle.
+ * @return false if the option could not be set.
+ */
+bool setQuickAck(int socket);
+/**
+ * allows sends with MSG_ZEROCOPY on a TCP socket.
+ *
+ * @param socket native handle.
+ * @return false if the kernel does not support it for the socket.
+ */
+bool enableZeroCopy(int socket);
+}  // namespace example
+
+#endif
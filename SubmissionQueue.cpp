@@ -0,0 +1,174 @@
+#include "SubmissionQueue.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Allocation.hpp"
+
+namespace {
+constexpr size_t f_threadSubmissionCount{64};
+constexpr size_t f_sharedSubmissionCount{4096};
+
+using Submission = example::SubmissionQueue::Submission;
+
+struct Submissions {
+  Submission *head{nullptr};
+  size_t count{0};
+
+  void push(Submission *submission) {
+    submission->next = head;
+    head = submission;
+    count++;
+  }
+
+  Submission *pop() {
+    auto submission = head;
+    head = submission->next;
+    count--;
+    return submission;
+  }
+};
+
+struct SharedSubmissions {
+  std::mutex mutex;
+  Submissions submissions;
+};
+
+SharedSubmissions &sharedSubmissions() {
+  static auto *submissions = new SharedSubmissions{};
+  return *submissions;
+}
+
+void destroy(Submission *submission) {
+  submission->~Submission();
+  example::SlabPool::deallocate(sizeof(Submission), submission);
+}
+
+struct ThreadSubmissions {
+  Submissions submissions;
+
+  ~ThreadSubmissions() {
+    auto &shared = sharedSubmissions();
+    std::lock_guard<std::mutex> guard{shared.mutex};
+    while (submissions.count > 0) {
+      auto submission = submissions.pop();
+      if (shared.submissions.count < f_sharedSubmissionCount) {
+        shared.submissions.push(submission);
+      } else {
+        destroy(submission);
+      }
+    }
+  }
+};
+
+thread_local ThreadSubmissions f_threadSubmissions;
+}  // namespace
+
+namespace example {
+SubmissionQueue::SubmissionQueue() : m_head{nullptr}, m_free{nullptr} {}
+
+SubmissionQueue::~SubmissionQueue() {
+  drain([](auto &) {});
+  auto submission = m_free.exchange(nullptr);
+  while (submission) {
+    destroy(std::exchange(submission, submission->next));
+  }
+}
+
+bool SubmissionQueue::push(uint64_t connectionId, const char *header,
+                           size_t headerSize, std::string &&payload,
+                           Priority priority) {
+  auto submission = acquire(connectionId, header, headerSize, priority);
+  submission->ownedPayload = std::move(payload);
+  return push(submission);
+}
+
+bool SubmissionQueue::push(uint64_t connectionId, const char *header,
+                           size_t headerSize,
+                           std::shared_ptr<const Buffer> payload,
+                           Priority priority) {
+  auto submission = acquire(connectionId, header, headerSize, priority);
+  submission->sharedPayload = std::move(payload);
+  return push(submission);
+}
+
+bool SubmissionQueue::push(uint64_t connectionId, const char *header,
+                           size_t headerSize,
+                           std::shared_ptr<const FileRegion> payload,
+                           Priority priority) {
+  auto submission = acquire(connectionId, header, headerSize, priority);
+  submission->filePayload = std::move(payload);
+  return push(submission);
+}
+
+SubmissionQueue::Submission *SubmissionQueue::acquire(uint64_t connectionId,
+                                                      const char *header,
+                                                      size_t headerSize,
+                                                      Priority priority) {
+  auto &local = f_threadSubmissions.submissions;
+  if (local.count == 0) {
+    // every free node is taken, so that each node is moved once per use;
+    // the cache shrinks back as the nodes are pushed and returned.
+    auto submission = m_free.exchange(nullptr, std::memory_order_acquire);
+    while (submission) {
+      local.push(std::exchange(submission, submission->next));
+    }
+  }
+  if (local.count == 0) {
+    auto &shared = sharedSubmissions();
+    std::lock_guard<std::mutex> guard{shared.mutex};
+    while (shared.submissions.count > 0 &&
+           local.count < f_threadSubmissionCount / 2) {
+      local.push(shared.submissions.pop());
+    }
+  }
+  auto submission =
+      local.count > 0
+          ? local.pop()
+          : new (SlabPool::allocate(sizeof(Submission))) Submission{};
+  submission->connectionId = connectionId;
+  std::copy_n(header, headerSize, submission->header.data());
+  submission->headerSize = headerSize;
+  submission->priority = priority;
+  submission->queuedAt = std::chrono::steady_clock::now();
+  return submission;
+}
+
+void SubmissionQueue::reset(Submission &submission) {
+  BufferPool::release(std::move(submission.ownedPayload));
+  submission.ownedPayload = {};
+  submission.sharedPayload.reset();
+  submission.filePayload.reset();
+}
+
+SubmissionQueue::Submission *SubmissionQueue::reverse(
+    Submission *submission) {
+  Submission *reversed{nullptr};
+  while (submission) {
+    auto next = submission->next;
+    submission->next = reversed;
+    reversed = submission;
+    submission = next;
+  }
+  return reversed;
+}
+
+bool SubmissionQueue::push(Submission *submission) {
+  auto head = m_head.load(std::memory_order_relaxed);
+  do {
+    submission->next = head;
+  } while (!m_head.compare_exchange_weak(head, submission));
+  return head == nullptr;
+}
+
+void SubmissionQueue::pushFree(Submission *head, Submission *tail) {
+  auto freeHead = m_free.load(std::memory_order_relaxed);
+  do {
+    tail->next = freeHead;
+  } while (!m_free.compare_exchange_weak(freeHead, head,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+}
+}  // namespace example
@@ -0,0 +1,166 @@
+#ifndef EXAMPLE_SUBMISSION_QUEUE_HPP
+#define EXAMPLE_SUBMISSION_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "FileRegion.hpp"
+#include "Framing.hpp"
+#include "Message.hpp"
+
+namespace example {
+/**
+ * SubmissionQueue class passes messages from any number of producer threads
+ * to the single thread that writes them. Producers push without locking, by
+ * a single compare and swap, and the consumer takes every pending message at
+ * once. Messages are held in nodes that the consumer returns to a free list
+ * of the queue, from which a producer takes them all at once into a cache of
+ * its thread, so that submitting neither locks nor allocates in steady
+ * state. Only while the queue warms up, with both the cache and the free list
+ * empty, are nodes taken from a locked pool shared by every thread.
+ */
+class SubmissionQueue {
+ public:
+  /**
+   * Submission struct holds a message pushed to a SubmissionQueue.
+   */
+  struct Submission {
+    /**
+     * identifier of the connection the message is sent to, if the queue is
+     * shared by several connections.
+     */
+    uint64_t connectionId;
+    /**
+     * header of the message, if already framed.
+     */
+    std::array<char, Framing::maxHeaderSize> header;
+    /**
+     * header size in bytes.
+     */
+    size_t headerSize;
+    /**
+     * payload of the message, if owned.
+     */
+    std::string ownedPayload;
+    /**
+     * payload of the message, if shared.
+     */
+    std::shared_ptr<const Buffer> sharedPayload;
+    /**
+     * payload of the message, if read from a file.
+     */
+    std::shared_ptr<const FileRegion> filePayload;
+    /**
+     * priority of the lane the message is sent on.
+     */
+    Priority priority;
+    /**
+     * time at which the message was pushed.
+     */
+    std::chrono::steady_clock::time_point queuedAt;
+    /**
+     * next submission.
+     */
+    Submission *next;
+  };
+  /**
+   * Constructs an empty SubmissionQueue object.
+   */
+  SubmissionQueue();
+  SubmissionQueue(const SubmissionQueue &) = delete;
+  SubmissionQueue &operator=(const SubmissionQueue &) = delete;
+  /**
+   * Destroys the SubmissionQueue object, discarding pending messages.
+   */
+  ~SubmissionQueue();
+  /**
+   * pushes a message, taking ownership of its payload. It can be called from
+   * any thread.
+   *
+   * @param connectionId of the message.
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is sent on.
+   * @return true if the queue was empty, so that the consumer has to be woken.
+   */
+  bool push(uint64_t connectionId, const char *header, size_t headerSize,
+            std::string &&payload, Priority priority = Priority::Normal);
+  /**
+   * pushes a message, sharing ownership of its payload. It can be called from
+   * any thread.
+   *
+   * @param connectionId of the message.
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is sent on.
+   * @return true if the queue was empty, so that the consumer has to be woken.
+   */
+  bool push(uint64_t connectionId, const char *header, size_t headerSize,
+            std::shared_ptr<const Buffer> payload,
+            Priority priority = Priority::Normal);
+  /**
+   * pushes a message whose payload is read from a file. It can be called
+   * from any thread.
+   *
+   * @param connectionId of the message.
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is sent on.
+   * @return true if the queue was empty, so that the consumer has to be woken.
+   */
+  bool push(uint64_t connectionId, const char *header, size_t headerSize,
+            std::shared_ptr<const FileRegion> payload,
+            Priority priority = Priority::Normal);
+  /**
+   * takes every pending message and calls specified handler with each one,
+   * in the order they were pushed by each producer. It must only be called
+   * from the consumer thread.
+   *
+   * @param handler called with a Submission reference, whose payload can be
+   * moved from.
+   * @return number of messages taken.
+   */
+  template <typename Handler>
+  size_t drain(Handler &&handler) {
+    auto submission = reverse(m_head.exchange(nullptr));
+    Submission *released{nullptr};
+    Submission *releasedTail{nullptr};
+    size_t count{0};
+    while (submission) {
+      auto next = submission->next;
+      handler(*submission);
+      reset(*submission);
+      submission->next = released;
+      released = submission;
+      releasedTail = releasedTail ? releasedTail : submission;
+      submission = next;
+      count++;
+    }
+    if (released) {
+      pushFree(released, releasedTail);
+    }
+    return count;
+  }
+
+ private:
+  Submission *acquire(uint64_t connectionId, const char *header,
+                      size_t headerSize, Priority priority);
+  static void reset(Submission &submission);
+  static Submission *reverse(Submission *submission);
+  bool push(Submission *submission);
+  void pushFree(Submission *head, Submission *tail);
+
+  std::atomic<Submission *> m_head;
+  // nodes are only ever pushed one chain at a time or taken all at once, so
+  // that neither side suffers from ABA.
+  std::atomic<Submission *> m_free;
+};
+}  // namespace example
+
+#endif
@@ -1,7 +1,6 @@
 #include "TcpClient.hpp"
 
-#include <iostream>
-
+#include "Logging.hpp"
 #include "TcpConnection.hpp"
 
 namespace example {
@@ -10,51 +9,171 @@ void TcpClient::Observer::onConnected() {}
 void TcpClient::Observer::onReceived(
     [[maybe_unused]] const std::string &message) {}
 
+void TcpClient::Observer::onReceivedView(const MessageView &message) {
+  onReceived(message.str());
+}
+
+void TcpClient::Observer::onReceivedBatch(const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    onReceivedView(message);
+  }
+}
+
+void TcpClient::Observer::onMessageBegin([[maybe_unused]] size_t size) {}
+
+void TcpClient::Observer::onMessageChunk(
+    [[maybe_unused]] std::string_view chunk) {}
+
+void TcpClient::Observer::onMessageEnd() {}
+
+void TcpClient::Observer::onSendQueueHigh() {}
+
+void TcpClient::Observer::onWritable() {}
+
+void TcpClient::Observer::onReceivePaused() {}
+
+void TcpClient::Observer::onReceiveResumed() {}
+
 void TcpClient::Observer::onDisconnected() {}
 
-TcpClient::TcpClient(boost::asio::io_context &ioContext, Observer &observer)
-    : m_ioContext{ioContext}, m_connection{}, m_observer{observer} {}
+TcpClient::TcpClient(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : m_ioContext{ioContext},
+      m_connection{},
+      m_observer{observer},
+      m_framing{framing},
+      m_options{options} {}
 
 void TcpClient::connect(const boost::asio::ip::tcp::endpoint &endpoint) {
-  if (m_connection) {
+  doConnect(endpoint);
+}
+
+void TcpClient::connect(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  doConnect(endpoint);
+}
+
+bool TcpClient::send(const std::string &message, Priority priority) {
+  return doSend(message, priority);
+}
+
+bool TcpClient::send(std::string &&message, Priority priority) {
+  return doSend(std::move(message), priority);
+}
+
+bool TcpClient::send(std::shared_ptr<const Buffer> message,
+                     Priority priority) {
+  return doSend(std::move(message), priority);
+}
+
+bool TcpClient::sendFile(const std::string &path, uint64_t offset,
+                         size_t size, Priority priority) {
+  auto connection = this->connection();
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("TCP Client Send error: no connection");
+    return false;
+  }
+  return connection->sendFile(path, offset, size, priority);
+}
+
+bool TcpClient::stats(ConnectionStats &stats) {
+  auto connection = this->connection();
+  if (!connection) {
+    return false;
+  }
+  stats = connection->stats();
+  return true;
+}
+
+void TcpClient::disconnect() {
+  auto connection = this->connection();
+  if (connection) {
+    connection->close();
+  }
+}
+
+void TcpClient::doConnect(
+    const boost::asio::generic::stream_protocol::endpoint &endpoint) {
+  if (connection()) {
     return;
   }
-  auto socket = std::make_shared<boost::asio::ip::tcp::socket>(m_ioContext);
+  auto socket = std::make_shared<TcpConnection::Socket>(m_ioContext);
+  boost::system::error_code error;
+  socket->open(endpoint.protocol(), error);
+  if (error) {
+    EXAMPLE_LOG_ERROR("TCP Client Connect error: ", error.message());
+    m_observer.onDisconnected();
+    return;
+  }
+  applySocketOptions(socket->native_handle(), m_options.socketOptions);
   socket->async_connect(endpoint, [this, socket](const auto &error) {
     if (error) {
-      std::cerr << "TCP Client Connect error: " << error.message() << std::endl;
+      EXAMPLE_LOG_ERROR("TCP Client Connect error: ", error.message());
+      m_observer.onDisconnected();
       return;
     }
-    m_connection = TcpConnection::create(std::move(*socket), *this);
-    m_connection->startReceiving();
-    std::cout << "TCP Client was connected" << std::endl;
+    auto connection = TcpConnection::create(std::move(*socket), *this,
+                                            m_framing, m_options);
+    std::atomic_store(&m_connection, connection);
+    connection->startReceiving();
+    EXAMPLE_LOG_INFO("TCP Client was connected");
     m_observer.onConnected();
   });
 }
 
-void TcpClient::send(const std::string &message) {
-  if (!m_connection) {
-    std::cerr << "TCP Client Send error: no connection" << std::endl;
-    return;
+template <typename Message>
+bool TcpClient::doSend(Message &&message, Priority priority) {
+  auto connection = this->connection();
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("TCP Client Send error: no connection");
+    return false;
   }
-  m_connection->send(message);
+  return connection->send(std::forward<Message>(message), priority);
 }
 
-void TcpClient::disconnect() {
-  if (m_connection) {
-    m_connection->close();
-  }
+std::shared_ptr<TcpConnection> TcpClient::connection() const {
+  return std::atomic_load(&m_connection);
+}
+
+void TcpClient::onReceivedBatch([[maybe_unused]] ConnectionId connectionId,
+                                const MessageBatch &messages) {
+  m_observer.onReceivedBatch(messages);
+}
+
+void TcpClient::onMessageBegin([[maybe_unused]] ConnectionId connectionId,
+                               size_t size) {
+  m_observer.onMessageBegin(size);
+}
+
+void TcpClient::onMessageChunk([[maybe_unused]] ConnectionId connectionId,
+                               std::string_view chunk) {
+  m_observer.onMessageChunk(chunk);
+}
+
+void TcpClient::onMessageEnd([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onMessageEnd();
+}
+
+void TcpClient::onSendQueueHigh([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onSendQueueHigh();
+}
+
+void TcpClient::onWritable([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onWritable();
+}
+
+void TcpClient::onReceivePaused([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onReceivePaused();
 }
 
-void TcpClient::onReceived([[maybe_unused]] int connectionId,
-                           const std::string &message) {
-  m_observer.onReceived(message);
+void TcpClient::onReceiveResumed([[maybe_unused]] ConnectionId connectionId) {
+  m_observer.onReceiveResumed();
 }
 
-void TcpClient::onConnectionClosed([[maybe_unused]] int connectionId) {
-  if (m_connection) {
-    m_connection.reset();
-    std::cout << "TCP Client was disconnected" << std::endl;
+void TcpClient::onConnectionClosed([[maybe_unused]] ConnectionId connectionId) {
+  if (std::atomic_exchange(&m_connection,
+                           std::shared_ptr<TcpConnection>{})) {
+    EXAMPLE_LOG_INFO("TCP Client was disconnected");
     m_observer.onDisconnected();
   }
 }
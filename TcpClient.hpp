@@ -8,8 +8,10 @@
 
 namespace example {
 /**
- * TcpClient class allows to connect to specified TCP endpoint, and use
- * associated connection to send and receive string messages.
+ * TcpClient class allows to connect to specified TCP or Unix domain socket
+ * endpoint, and use associated connection to send and receive string
+ * messages. Functions send(), sendFile() and stats() can be called from any
+ * thread.
  */
 class TcpClient : private TcpConnection::Observer {
  public:
@@ -27,6 +29,63 @@ class TcpClient : private TcpConnection::Observer {
      * @param message received.
      */
     virtual void onReceived(const std::string &message);
+    /**
+     * virtual function called by TcpClient after message is received, without
+     * copying the message out of the connection receive buffer. By default it
+     * calls onReceived() with a copy of the message.
+     *
+     * @param message received, valid only during the call.
+     * MessageView::retain() keeps it valid afterwards.
+     */
+    virtual void onReceivedView(const MessageView &message);
+    /**
+     * virtual function called by TcpClient after one or more messages are
+     * received by a single read operation. By default it calls
+     * onReceivedView() for each message.
+     *
+     * @param messages received, valid only during the call.
+     */
+    virtual void onReceivedBatch(const MessageBatch &messages);
+    /**
+     * virtual function called by TcpClient when the header of a message at
+     * least as large as the streaming threshold is received. Its payload is
+     * then delivered through onMessageChunk() as it arrives.
+     *
+     * @param size of the message in bytes.
+     */
+    virtual void onMessageBegin(size_t size);
+    /**
+     * virtual function called by TcpClient with the next bytes of a message
+     * being streamed.
+     *
+     * @param chunk of the message, valid only during the call.
+     */
+    virtual void onMessageChunk(std::string_view chunk);
+    /**
+     * virtual function called by TcpClient after the last chunk of a message
+     * being streamed.
+     */
+    virtual void onMessageEnd();
+    /**
+     * virtual function called by TcpClient when the connection send queue
+     * reaches its high watermark, from the thread calling send().
+     */
+    virtual void onSendQueueHigh();
+    /**
+     * virtual function called by TcpClient when the connection send queue
+     * drains to its low watermark after having reached its high watermark.
+     */
+    virtual void onWritable();
+    /**
+     * virtual function called by TcpClient when the connection stops reading
+     * because its receive rate limits have been exceeded.
+     */
+    virtual void onReceivePaused();
+    /**
+     * virtual function called by TcpClient when the connection reads again
+     * after having been paused.
+     */
+    virtual void onReceiveResumed();
     /**
      * virtual function called by TcpClient after connection is closed or
      * after an attempted connection fails.
@@ -38,33 +97,103 @@ class TcpClient : private TcpConnection::Observer {
    *
    * @param ioContext required for asynchronous input and ouput operations.
    * @param observer to monitor TcpClient events.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
    */
-  TcpClient(boost::asio::io_context &ioContext, Observer &observer);
+  TcpClient(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::text(),
+            const ConnectionOptions &options = {});
   /**
    * attempts to connect to specified endpoint.
    *
    * @param endpoint to connect to.
    */
   void connect(const boost::asio::ip::tcp::endpoint &endpoint);
+  /**
+   * attempts to connect to specified Unix domain socket endpoint.
+   *
+   * @param endpoint to connect to.
+   */
+  void connect(const boost::asio::local::stream_protocol::endpoint &endpoint);
   /**
    * Sends string message to peer associated to TcpClient connection if
    * exists.
    *
    * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(const std::string &message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends string message to peer associated to TcpClient connection if
+   * exists, taking ownership of the message instead of copying it.
+   *
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(std::string &&message, Priority priority = Priority::Normal);
+  /**
+   * Sends message to peer associated to TcpClient connection if exists,
+   * sharing ownership of the message payload instead of copying it.
+   *
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if there is no connection or its send queue is full.
+   */
+  bool send(std::shared_ptr<const Buffer> message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends a range of a file as a message to peer associated to TcpClient
+   * connection if exists, without copying it through user space.
+   *
+   * @param path of the file.
+   * @param offset of the first byte to send.
+   * @param size in bytes to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if there is no connection, the file cannot be opened or
+   * the send queue is full.
+   */
+  bool sendFile(const std::string &path, uint64_t offset, size_t size,
+                Priority priority = Priority::Normal);
+  /**
+   * gets a snapshot of the counters of the TcpClient connection.
+   *
+   * @param stats of the connection.
+   * @return false if there is no connection.
    */
-  void send(const std::string &message);
+  bool stats(ConnectionStats &stats);
   /**
    * Closes connection.
    */
   void disconnect();
 
  private:
-  void onReceived(int connectionId, const std::string &message) override;
-  void onConnectionClosed(int connectionId) override;
+  void doConnect(
+      const boost::asio::generic::stream_protocol::endpoint &endpoint);
+  template <typename Message>
+  bool doSend(Message &&message, Priority priority);
+  std::shared_ptr<TcpConnection> connection() const;
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+  void onMessageBegin(ConnectionId connectionId, size_t size) override;
+  void onMessageChunk(ConnectionId connectionId,
+                      std::string_view chunk) override;
+  void onMessageEnd(ConnectionId connectionId) override;
+  void onSendQueueHigh(ConnectionId connectionId) override;
+  void onWritable(ConnectionId connectionId) override;
+  void onReceivePaused(ConnectionId connectionId) override;
+  void onReceiveResumed(ConnectionId connectionId) override;
+  void onConnectionClosed(ConnectionId connectionId) override;
 
   boost::asio::io_context &m_ioContext;
+  // accessed atomically, since the io thread sets and resets it while other
+  // threads send.
   std::shared_ptr<TcpConnection> m_connection;
   Observer &m_observer;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
 };
 }  // namespace example
 
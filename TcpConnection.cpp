@@ -1,121 +1,773 @@
 #include "TcpConnection.hpp"
 
-#include <iostream>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+
+#include <cstring>
+
+#include "Logging.hpp"
 
 namespace {
-constexpr std::string_view f_messageHeaderSeparator{";"};
 constexpr size_t f_messageMaxSize{std::numeric_limits<uint32_t>::max()};
+constexpr size_t f_readChunkSize{65536};
+constexpr size_t f_decompressedMaxCapacity{1 << 20};
+// bytes of a file sent per wakeup, so that a large file does not hold the
+// io thread.
+constexpr size_t f_fileWriteSize{1 << 20};
+// the top bit of the pending bytes flags a send queue above the high
+// watermark, so that both change together.
+constexpr size_t f_sendQueueHighFlag{~(~size_t{0} >> 1)};
 }  // namespace
 
 namespace example {
 void TcpConnection::Observer::onReceived(
-    [[maybe_unused]] int connectionId,
-    [[maybe_unused]] const std::string &message) {}
+    [[maybe_unused]] ConnectionId connectionId,
+    [[maybe_unused]] const MessageView &message) {}
+
+void TcpConnection::Observer::onReceivedBatch(ConnectionId connectionId,
+                                              const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    onReceived(connectionId, message);
+  }
+}
+
+void TcpConnection::Observer::onMessageBegin(
+    [[maybe_unused]] ConnectionId connectionId, [[maybe_unused]] size_t size) {}
+
+void TcpConnection::Observer::onMessageChunk(
+    [[maybe_unused]] ConnectionId connectionId,
+    [[maybe_unused]] std::string_view chunk) {}
+
+void TcpConnection::Observer::onMessageEnd(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpConnection::Observer::onSendQueueHigh(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpConnection::Observer::onWritable(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpConnection::Observer::onReceivePaused(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpConnection::Observer::onReceiveResumed(
+    [[maybe_unused]] ConnectionId connectionId) {}
 
 void TcpConnection::Observer::onConnectionClosed(
-    [[maybe_unused]] int connectionId) {}
+    [[maybe_unused]] ConnectionId connectionId) {}
 
-TcpConnection::TcpConnection(boost::asio::ip::tcp::socket &&socket,
-                             Observer &observer, int id)
+TcpConnection::TcpConnection(ConstructionKey, Socket &&socket,
+                             Observer &observer, const Framing &framing,
+                             const ConnectionOptions &options,
+                             SendLimit *sendLimit,
+                             TrafficMetrics *parentMetrics, ConnectionId id)
     : m_socket{std::move(socket)},
+      m_ioContext{static_cast<boost::asio::io_context &>(
+          boost::asio::query(m_socket.get_executor(),
+                             boost::asio::execution::context))},
       m_readBuffer{},
-      m_writeBuffer{},
-      m_writeMutex{},
+      m_submissions{},
+      m_writeQueue{framing, options.writeChunkSize},
+      m_batch{},
+      m_chunks{},
+      m_decompressed{},
+      m_readHandlerMemory{},
+      m_writeHandlerMemory{},
+      m_submitHandlerMemory{},
+      m_zeroCopyHandlerMemory{},
+      m_pendingBytes{0},
       m_observer{observer},
+      m_framing{framing},
+      m_options{options},
+      m_sendLimit{sendLimit},
+      m_metrics{parentMetrics},
+      m_creationTime{std::chrono::steady_clock::now()},
+      m_readTime{m_creationTime},
+      m_writeTime{m_creationTime},
+      m_timeoutTimer{[this]() { checkTimeouts(); }},
+      m_timingWheel{nullptr},
+      m_receiveMessages{options.receiveMessageLimit},
+      m_receiveBytes{options.receiveByteLimit},
+      m_throttleTimer{[this]() { resumeReceiving(); }},
+      m_throttledBytesToRead{0},
+      m_writeSize{0},
+      m_zeroCopyThreshold{0},
+      m_zeroCopySequence{0},
+      m_streamedBytes{0},
+      m_bufferRingReceiveId{0},
       m_isWritting{false},
+      m_isWaitingZeroCopy{false},
       m_id{id} {}
 
-std::shared_ptr<TcpConnection> TcpConnection::create(
-    boost::asio::ip::tcp::socket &&socket, Observer &observer, int id) {
-  return std::shared_ptr<TcpConnection>(
-      new TcpConnection{std::move(socket), observer, id});
+TcpConnection::~TcpConnection() {
+  if (m_sendLimit) {
+    m_sendLimit->release(pendingBytes());
+  }
 }
 
-void TcpConnection::startReceiving() { readHeader(); }
+std::shared_ptr<TcpConnection> TcpConnection::create(
+    Socket &&socket, Observer &observer, const Framing &framing,
+    const ConnectionOptions &options, SendLimit *sendLimit,
+    TrafficMetrics *parentMetrics, ConnectionId id) {
+  return std::allocate_shared<TcpConnection>(
+      SlabAllocator<TcpConnection>{}, ConstructionKey{}, std::move(socket),
+      observer, framing, options, sendLimit, parentMetrics, id);
+}
 
-void TcpConnection::send(const std::string &message) {
+std::shared_ptr<const Buffer> TcpConnection::frame(const Framing &framing,
+                                                   std::string_view message) {
   if (message.size() > f_messageMaxSize) {
-    std::cerr << "TCP Connection Send error: message is too large" << std::endl;
+    EXAMPLE_LOG_ERROR("TCP Connection Frame error: message is too large");
+    return nullptr;
   }
-  std::lock_guard<std::mutex> guard{m_writeMutex};
-  std::ostream bufferStream{&m_writeBuffer};
-  bufferStream << message.size() << f_messageHeaderSeparator << message;
-  if (!m_isWritting) {
-    write();
+  auto frame = std::make_shared<Buffer>(Framing::maxHeaderSize, '\0');
+  frame->resize(framing.encode({message.size(), 0}, frame->data()));
+  frame->append(message);
+  return frame;
+}
+
+void TcpConnection::startReceiving() {
+  const auto &socketOptions = m_options.socketOptions;
+  applySocketOptions(m_socket.native_handle(), socketOptions);
+  boost::system::error_code error;
+  // files are sent from the native handle, which must not block.
+  m_socket.native_non_blocking(true, error);
+  auto endpoint = m_socket.local_endpoint(error);
+  if (socketOptions.zeroCopyThreshold > 0 && !error &&
+      endpoint.protocol().family() != AF_UNIX &&
+      enableZeroCopy(m_socket.native_handle())) {
+    // payloads held in place by a string are copied when moved, so they
+    // cannot be kept for the kernel.
+    m_zeroCopyThreshold = std::max(socketOptions.zeroCopyThreshold,
+                                   std::string{}.capacity() + 1);
+  }
+  bool isThrottled{m_receiveMessages.isLimited() ||
+                   m_receiveBytes.isLimited()};
+  if (isThrottled) {
+    m_timingWheel = &TimingWheel::of(m_ioContext);
+  }
+#ifdef EXAMPLE_IO_URING
+  // a multishot receive cannot be paused without losing the completions
+  // already in flight, so throttled connections use read operations.
+  if (m_options.bufferRing && !isThrottled) {
+    auto self = shared_from_this();
+    m_bufferRingReceiveId = BufferRing::of(m_ioContext)
+                                .receive(m_socket.native_handle(),
+                                         [this, self](auto result, auto data) {
+                                           receive(result, data);
+                                         });
+  }
+#endif
+  if (m_bufferRingReceiveId == 0) {
+    read(0);
+  }
+  if (m_options.idleTimeout.count() > 0 || m_options.readTimeout.count() > 0 ||
+      m_options.writeTimeout.count() > 0) {
+    m_timingWheel = &TimingWheel::of(m_ioContext);
+    checkTimeouts();
   }
 }
 
+bool TcpConnection::send(const std::string &message, Priority priority) {
+  bool isQueued;
+  if (sendCompressed(message, priority, isQueued)) {
+    return isQueued;
+  }
+  auto buffer = BufferPool::acquire();
+  buffer.assign(message);
+  auto size = buffer.size();
+  return enqueueMessage(std::move(buffer), size, priority);
+}
+
+bool TcpConnection::send(std::string &&message, Priority priority) {
+  bool isQueued;
+  if (sendCompressed(message, priority, isQueued)) {
+    return isQueued;
+  }
+  auto size = message.size();
+  return enqueueMessage(std::move(message), size, priority);
+}
+
+bool TcpConnection::send(std::shared_ptr<const Buffer> message,
+                         Priority priority) {
+  if (!message) {
+    return false;
+  }
+  bool isQueued;
+  if (sendCompressed(*message, priority, isQueued)) {
+    return isQueued;
+  }
+  auto size = message->size();
+  return enqueueMessage(std::move(message), size, priority);
+}
+
+bool TcpConnection::sendFile(const std::string &path, uint64_t offset,
+                             size_t size, Priority priority) {
+  auto file = FileRegion::open(path, offset, size);
+  return file && sendFile(std::move(file), priority);
+}
+
+bool TcpConnection::sendFile(std::shared_ptr<const FileRegion> file,
+                             Priority priority) {
+  if (!file) {
+    return false;
+  }
+  auto size = file->size();
+  return enqueueMessage(std::move(file), size, priority);
+}
+
+bool TcpConnection::sendFrame(std::shared_ptr<const Buffer> frame) {
+  if (!frame) {
+    return false;
+  }
+  auto size = frame->size();
+  return enqueue(nullptr, 0, std::move(frame), size, Priority::Normal);
+}
+
+size_t TcpConnection::pendingBytes() {
+  return m_pendingBytes.load() & ~f_sendQueueHighFlag;
+}
+
+ConnectionStats TcpConnection::stats() {
+  ConnectionStats stats;
+  static_cast<TrafficStats &>(stats) = m_metrics.stats();
+  stats.pendingBytes = pendingBytes();
+  stats.lifetime = std::chrono::steady_clock::now() - m_creationTime;
+  return stats;
+}
+
 void TcpConnection::close() {
+  // the timers are cancelled on the io thread, so that destroying them from
+  // another thread does not touch the wheel.
+  if (m_timingWheel) {
+    m_timingWheel->cancel(m_timeoutTimer);
+    m_timingWheel->cancel(m_throttleTimer);
+  }
+#ifdef EXAMPLE_IO_URING
+  if (m_bufferRingReceiveId != 0) {
+    BufferRing::of(m_ioContext).cancel(m_bufferRingReceiveId);
+    m_bufferRingReceiveId = 0;
+  }
+#endif
   try {
     m_socket.cancel();
     m_socket.close();
   } catch (const std::exception &e) {
-    std::cerr << "TCP Connection Close exception: " << e.what() << std::endl;
+    EXAMPLE_LOG_ERROR("TCP Connection Close exception: ", e.what());
     return;
   }
   m_observer.onConnectionClosed(m_id);
 }
 
-void TcpConnection::write() {
+bool TcpConnection::sendCompressed(std::string_view message,
+                                   Priority priority, bool &isQueued) {
+  if (!m_options.codec || !m_framing.hasFlags() ||
+      message.size() < m_options.compressionThreshold) {
+    return false;
+  }
+  // the buffer is recycled once written, so that compressing does not
+  // allocate in steady state.
+  auto buffer = BufferPool::acquire();
+  if (!m_options.codec->compress(message, buffer)) {
+    BufferPool::release(std::move(buffer));
+    return false;
+  }
+  auto size = buffer.size();
+  isQueued = enqueueMessage(std::move(buffer), size, priority,
+                            FrameHeader::compressedFlag);
+  return true;
+}
+
+template <typename Payload>
+bool TcpConnection::enqueueMessage(Payload &&payload, size_t payloadSize,
+                                   Priority priority, uint8_t flags) {
+  if (payloadSize > f_messageMaxSize) {
+    EXAMPLE_LOG_ERROR("TCP Connection Send error: message is too large");
+    return false;
+  }
+  char header[Framing::maxHeaderSize];
+  auto headerSize = m_framing.encode({payloadSize, flags}, header);
+  return enqueue(header, headerSize, std::forward<Payload>(payload),
+                 payloadSize, priority);
+}
+
+template <typename Payload>
+bool TcpConnection::enqueue(const char *header, size_t headerSize,
+                            Payload &&payload, size_t payloadSize,
+                            Priority priority) {
+  auto size = m_writeQueue.frameSize(headerSize, payloadSize);
+  if (m_sendLimit && !m_sendLimit->tryAcquire(size)) {
+    return false;
+  }
+  bool isSendQueueHigh;
+  if (!reservePendingBytes(size, isSendQueueHigh)) {
+    if (m_sendLimit) {
+      m_sendLimit->release(size);
+    }
+    return false;
+  }
+  if (m_submissions.push(m_id, header, headerSize,
+                         std::forward<Payload>(payload), priority)) {
+    // posted rather than dispatched, so that sends made by an observer
+    // callback on the io thread are batched into a single write.
+    auto self = shared_from_this();
+    boost::asio::post(
+        m_ioContext, makeAllocatingHandler(m_submitHandlerMemory,
+                                           [this, self]() { submit(); }));
+  }
+  if (isSendQueueHigh) {
+    m_observer.onSendQueueHigh(m_id);
+  }
+  return true;
+}
+
+bool TcpConnection::reservePendingBytes(size_t size, bool &isSendQueueHigh) {
+  auto pendingBytes = m_pendingBytes.load();
+  size_t newPendingBytes;
+  do {
+    if ((pendingBytes & ~f_sendQueueHighFlag) >=
+        m_options.sendQueueHighWatermark) {
+      return false;
+    }
+    newPendingBytes = pendingBytes + size;
+    if ((newPendingBytes & ~f_sendQueueHighFlag) >=
+        m_options.sendQueueHighWatermark) {
+      newPendingBytes |= f_sendQueueHighFlag;
+    }
+  } while (!m_pendingBytes.compare_exchange_weak(pendingBytes,
+                                                 newPendingBytes));
+  isSendQueueHigh = !(pendingBytes & f_sendQueueHighFlag) &&
+                    (newPendingBytes & f_sendQueueHighFlag);
+  return true;
+}
+
+bool TcpConnection::releasePendingBytes(size_t size) {
+  auto pendingBytes = m_pendingBytes.load();
+  size_t newPendingBytes;
+  do {
+    newPendingBytes = pendingBytes - size;
+    if ((newPendingBytes & ~f_sendQueueHighFlag) <=
+        m_options.sendQueueLowWatermark) {
+      newPendingBytes &= ~f_sendQueueHighFlag;
+    }
+  } while (!m_pendingBytes.compare_exchange_weak(pendingBytes,
+                                                 newPendingBytes));
+  return (pendingBytes & f_sendQueueHighFlag) &&
+         !(newPendingBytes & f_sendQueueHighFlag);
+}
+
+void TcpConnection::submit() {
+  takeSubmissions();
+  if (!m_isWritting && !m_writeQueue.empty()) {
+    m_writeTime = std::chrono::steady_clock::now();
+    write();
+  }
+}
+
+void TcpConnection::takeSubmissions() {
+  m_submissions.drain(
+      [this](auto &submission) { m_writeQueue.push(submission); });
+}
+
+void TcpConnection::write(bool isZeroCopyAllowed) {
   m_isWritting = true;
+  auto zeroCopyThreshold = isZeroCopyAllowed ? m_zeroCopyThreshold : 0;
+  const FileRegion *file;
+  uint64_t fileOffset;
+  size_t fileSize;
+  if (m_writeQueue.filePayload(file, fileOffset, fileSize)) {
+    return writeFile();
+  }
+  boost::asio::const_buffer payload;
+  if (m_writeQueue.zeroCopyPayload(zeroCopyThreshold, payload)) {
+    return writeZeroCopy(payload);
+  }
+  auto buffers = m_writeQueue.buffers(zeroCopyThreshold);
+  m_writeSize = boost::asio::buffer_size(buffers);
   auto self = shared_from_this();
   m_socket.async_write_some(
-      m_writeBuffer.data(),
-      [this, self](const auto &error, auto bytesTransferred) {
+      buffers,
+      makeAllocatingHandler(
+          m_writeHandlerMemory,
+          [this, self](const auto &error, auto bytesTransferred) {
+            if (error) {
+              EXAMPLE_LOG_ERROR("TCP Connection Write error: ",
+                                error.message());
+              return close();
+            }
+            m_writeQueue.consume(bytesTransferred, m_metrics);
+            written(bytesTransferred);
+          }));
+}
+
+void TcpConnection::writeFile() {
+  auto self = shared_from_this();
+  m_socket.async_wait(
+      boost::asio::socket_base::wait_write,
+      makeAllocatingHandler(m_writeHandlerMemory, [this,
+                                                   self](const auto &error) {
         if (error) {
-          std::cerr << "TCP Connection Write error: " << error.message()
-                    << std::endl;
+          EXAMPLE_LOG_ERROR("TCP Connection Write error: ", error.message());
           return close();
         }
-        std::lock_guard<std::mutex> guard{m_writeMutex};
-        m_writeBuffer.consume(bytesTransferred);
-        if (m_writeBuffer.size() == 0) {
-          m_isWritting = false;
-          return;
+        const FileRegion *file;
+        uint64_t offset;
+        size_t size;
+        m_writeQueue.filePayload(file, offset, size);
+        m_writeSize = size;
+        size = std::min(size, f_fileWriteSize);
+        auto fileOffset = static_cast<off_t>(offset);
+        size_t bytesTransferred{0};
+        while (bytesTransferred < size) {
+          auto result = ::sendfile(m_socket.native_handle(), file->file(),
+                                   &fileOffset, size - bytesTransferred);
+          if (result > 0) {
+            bytesTransferred += static_cast<size_t>(result);
+          } else if (result < 0 && errno == EINTR) {
+            continue;
+          } else if (result < 0 && errno == EAGAIN) {
+            break;
+          } else {
+            EXAMPLE_LOG_ERROR("TCP Connection Write error: ",
+                              result < 0 ? std::strerror(errno)
+                                         : "file was truncated");
+            return close();
+          }
         }
-        write();
-      });
+        m_writeQueue.consume(bytesTransferred, m_metrics);
+        written(bytesTransferred);
+      }));
 }
 
-void TcpConnection::readHeader() {
+void TcpConnection::writeZeroCopy(boost::asio::const_buffer payload) {
+  m_writeSize = payload.size();
   auto self = shared_from_this();
-  boost::asio::async_read_until(
-      m_socket, m_readBuffer, f_messageHeaderSeparator,
-      [this, self](const auto &error, [[maybe_unused]] auto bytesTransferred) {
-        if (error) {
-          std::cerr << "TCP Connection Read error: " << error.message()
-                    << std::endl;
-          return close();
-        }
-        std::istream bufferStream{&m_readBuffer};
-        size_t header;
-        bufferStream >> header;
-        bufferStream.ignore(f_messageHeaderSeparator.size());
-        readBody(header);
-      });
+  m_socket.async_send(
+      payload, MSG_ZEROCOPY,
+      makeAllocatingHandler(
+          m_writeHandlerMemory,
+          [this, self](const auto &error, auto bytesTransferred) {
+            if (error == boost::asio::error::no_buffer_space) {
+              // the kernel could not pin more pages for this socket.
+              return write(false);
+            }
+            if (error) {
+              EXAMPLE_LOG_ERROR("TCP Connection Write error: ",
+                                error.message());
+              return close();
+            }
+            m_writeQueue.consumeZeroCopy(bytesTransferred, m_metrics,
+                                         m_zeroCopySequence++);
+            readZeroCopyCompletions();
+            written(bytesTransferred);
+          }));
+}
+
+void TcpConnection::written(size_t bytesTransferred) {
+  m_writeTime = std::chrono::steady_clock::now();
+  m_metrics.recordWritten(bytesTransferred, m_writeSize);
+  if (m_sendLimit) {
+    m_sendLimit->release(bytesTransferred);
+  }
+  auto isWritable = releasePendingBytes(bytesTransferred);
+  takeSubmissions();
+  if (m_writeQueue.empty()) {
+    m_isWritting = false;
+  } else {
+    write();
+  }
+  if (isWritable) {
+    m_observer.onWritable(m_id);
+  }
 }
 
-void TcpConnection::readBody(size_t bytesToRead) {
-  int pendingBytesToRead = bytesToRead - m_readBuffer.size();
-  auto buffers = m_readBuffer.prepare(std::max(pendingBytesToRead, 0));
+void TcpConnection::readZeroCopyCompletions() {
+  char control[CMSG_SPACE(sizeof(sock_extended_err)) * 4];
+  while (true) {
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(m_socket.native_handle(), &message,
+                MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      break;
+    }
+    for (auto header = CMSG_FIRSTHDR(&message); header;
+         header = CMSG_NXTHDR(&message, header)) {
+      if (!(header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) &&
+          !(header->cmsg_level == SOL_IPV6 &&
+            header->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      auto error = reinterpret_cast<const sock_extended_err *>(
+          CMSG_DATA(header));
+      if (error->ee_errno != 0 || error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      m_writeQueue.releaseZeroCopy(error->ee_data);
+      if ((error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) &&
+          m_zeroCopyThreshold > 0) {
+        m_zeroCopyThreshold = 0;
+        EXAMPLE_LOG_INFO("TCP Connection zero copy disabled: payload copied");
+      }
+    }
+  }
+  if (!m_writeQueue.hasZeroCopyPayloads() || m_isWaitingZeroCopy) {
+    return;
+  }
+  m_isWaitingZeroCopy = true;
+  auto self = shared_from_this();
+  m_socket.async_wait(
+      boost::asio::socket_base::wait_error,
+      makeAllocatingHandler(m_zeroCopyHandlerMemory,
+                            [this, self](const auto &error) {
+                              m_isWaitingZeroCopy = false;
+                              if (!error) {
+                                readZeroCopyCompletions();
+                              }
+                            }));
+}
+
+void TcpConnection::read(size_t minBytesToRead) {
   auto self = shared_from_this();
   m_socket.async_read_some(
-      buffers,
-      [this, self, bytesToRead](const auto &error, auto bytesTransferred) {
-        if (error) {
-          std::cerr << "TCP Connection Read error: " << error.message()
-                    << std::endl;
-          return close();
+      m_readBuffer.prepare(std::max(minBytesToRead, f_readChunkSize)),
+      makeAllocatingHandler(
+          m_readHandlerMemory,
+          [this, self](const auto &error, auto bytesTransferred) {
+            if (error) {
+              EXAMPLE_LOG_ERROR("TCP Connection Read error: ",
+                                error.message());
+              return close();
+            }
+            m_readBuffer.commit(bytesTransferred);
+            size_t missingBytes;
+            if (!received(bytesTransferred, missingBytes)) {
+              return close();
+            }
+            readNext(missingBytes);
+          }));
+}
+
+void TcpConnection::readNext(size_t minBytesToRead) {
+  if (!m_receiveMessages.isLimited() && !m_receiveBytes.isLimited()) {
+    return read(minBytesToRead);
+  }
+  auto now = std::chrono::steady_clock::now();
+  auto delay = std::max(m_receiveMessages.delay(0, now),
+                        m_receiveBytes.delay(0, now));
+  // a connection closed while delivering is not throttled, so that its
+  // timer stays cancelled.
+  if (delay.count() == 0 || !m_socket.is_open()) {
+    return read(minBytesToRead);
+  }
+  // unread bytes stay in the socket receive buffer, so that the kernel
+  // shrinks the window advertised to the peer instead of dropping them.
+  m_throttledBytesToRead = minBytesToRead;
+  m_timingWheel->arm(m_throttleTimer, delay);
+  m_observer.onReceivePaused(m_id);
+}
+
+void TcpConnection::resumeReceiving() {
+  if (!m_socket.is_open()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  auto delay = std::max(m_receiveMessages.delay(0, now),
+                        m_receiveBytes.delay(0, now));
+  if (delay.count() > 0) {
+    m_timingWheel->arm(m_throttleTimer, delay);
+    return;
+  }
+  // the peer was not idle while paused, so the read timeout restarts.
+  m_readTime = now;
+  auto self = shared_from_this();
+  m_observer.onReceiveResumed(m_id);
+  if (m_socket.is_open()) {
+    read(m_throttledBytesToRead);
+  }
+}
+
+void TcpConnection::receive(int result, const char *data) {
+  if (result <= 0) {
+    auto error = result == 0 ? make_error_code(boost::asio::error::eof)
+                             : boost::system::error_code{
+                                   -result, boost::system::system_category()};
+    EXAMPLE_LOG_ERROR("TCP Connection Read error: ", error.message());
+    m_bufferRingReceiveId = 0;
+    return close();
+  }
+  auto bytesTransferred = static_cast<size_t>(result);
+  std::memcpy(m_readBuffer.prepare(bytesTransferred).data(), data,
+              bytesTransferred);
+  m_readBuffer.commit(bytesTransferred);
+  size_t missingBytes;
+  if (!received(bytesTransferred, missingBytes)) {
+    close();
+  }
+}
+
+bool TcpConnection::received(size_t bytesTransferred, size_t &missingBytes) {
+  m_readTime = std::chrono::steady_clock::now();
+  if (m_options.socketOptions.quickAck) {
+    setQuickAck(m_socket.native_handle());
+  }
+  size_t messageCount;
+  if (!deliver(missingBytes, messageCount)) {
+    EXAMPLE_LOG_ERROR("TCP Connection Read error: invalid frame");
+    return false;
+  }
+  m_metrics.recordReceived(bytesTransferred, messageCount);
+  m_receiveMessages.take(static_cast<double>(messageCount), m_readTime);
+  m_receiveBytes.take(static_cast<double>(bytesTransferred), m_readTime);
+  return true;
+}
+
+bool TcpConnection::deliver(size_t &missingBytes, size_t &messageCount) {
+  auto data = m_readBuffer.data();
+  auto size = m_readBuffer.size();
+  size_t offset{0};
+  missingBytes = 0;
+  messageCount = 0;
+  m_batch.clear();
+  auto deliverBatch = [this, &messageCount]() {
+    if (!m_batch.empty()) {
+      m_observer.onReceivedBatch(
+          m_id, {m_batch.data(), m_batch.data() + m_batch.size()});
+      messageCount += m_batch.size();
+      m_batch.clear();
+    }
+  };
+  auto deliverCompressed = [this, &deliverBatch](std::string_view message) {
+    auto codec = Codec::of(message, m_options.codec);
+    if (!codec ||
+        !codec->decompress(message, m_options.maxDecompressedSize,
+                           m_decompressed)) {
+      return false;
+    }
+    // the next compressed message reuses the buffer, so the message is
+    // delivered at once.
+    m_batch.emplace_back(std::string_view{m_decompressed});
+    deliverBatch();
+    // the buffer is kept across messages up to a bound, so that a large
+    // message does not pin its memory for the lifetime of the connection.
+    if (m_decompressed.capacity() > f_decompressedMaxCapacity) {
+      m_decompressed = {};
+    }
+    return true;
+  };
+  while (offset < size) {
+    if (m_streamedBytes > 0) {
+      auto chunkSize = std::min(m_streamedBytes, size - offset);
+      m_observer.onMessageChunk(m_id, {data + offset, chunkSize});
+      offset += chunkSize;
+      m_streamedBytes -= chunkSize;
+      if (m_streamedBytes == 0) {
+        m_observer.onMessageEnd(m_id);
+        messageCount++;
+      }
+      continue;
+    }
+    FrameHeader header;
+    size_t headerSize;
+    if (!m_framing.decode(data + offset, size - offset, header, headerSize)) {
+      return false;
+    }
+    if (headerSize == 0) {
+      break;
+    }
+    if (header.flags & FrameHeader::chunkFlag) {
+      auto frameSize = headerSize + header.size;
+      if (size - offset < frameSize) {
+        missingBytes = frameSize - (size - offset);
+        break;
+      }
+      auto &chunks = m_chunks[header.flags & FrameHeader::laneMask];
+      if (chunks.size() + header.size > f_messageMaxSize) {
+        return false;
+      }
+      chunks.append(data + offset + headerSize, header.size);
+      offset += frameSize;
+      if (header.flags & FrameHeader::lastChunkFlag) {
+        if (header.flags & FrameHeader::compressedFlag) {
+          if (!deliverCompressed(chunks)) {
+            return false;
+          }
+        } else {
+          // the next message of the lane reuses the buffer, so the message
+          // is delivered at once.
+          m_batch.emplace_back(std::string_view{chunks});
+          deliverBatch();
         }
-        m_readBuffer.commit(bytesTransferred);
-        if (m_readBuffer.size() >= bytesToRead) {
-          auto bufferBegin = boost::asio::buffers_begin(m_readBuffer.data());
-          std::string message{bufferBegin, bufferBegin + bytesToRead};
-          m_readBuffer.consume(bytesToRead);
-          m_observer.onReceived(m_id, message);
-          return readHeader();
+        if (chunks.capacity() > f_readChunkSize) {
+          chunks = {};
+        } else {
+          chunks.clear();
         }
-        readBody(bytesToRead);
-      });
+      }
+      continue;
+    }
+    if (header.flags & FrameHeader::compressedFlag) {
+      auto frameSize = headerSize + header.size;
+      if (size - offset < frameSize) {
+        missingBytes = frameSize - (size - offset);
+        break;
+      }
+      if (!deliverCompressed({data + offset + headerSize, header.size})) {
+        return false;
+      }
+      offset += frameSize;
+      continue;
+    }
+    if (m_options.streamingThreshold > 0 &&
+        header.size >= m_options.streamingThreshold) {
+      deliverBatch();
+      offset += headerSize;
+      m_streamedBytes = header.size;
+      m_observer.onMessageBegin(m_id, header.size);
+      continue;
+    }
+    auto frameSize = headerSize + header.size;
+    if (size - offset < frameSize) {
+      missingBytes = frameSize - (size - offset);
+      break;
+    }
+    m_batch.emplace_back(
+        std::string_view{data + offset + headerSize, header.size},
+        &m_readBuffer.storage());
+    offset += frameSize;
+  }
+  deliverBatch();
+  m_readBuffer.consume(offset);
+  return true;
+}
+
+void TcpConnection::checkTimeouts() {
+  if (!m_socket.is_open()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  const char *reason{nullptr};
+  auto check = [&](std::chrono::nanoseconds timeout,
+                   std::chrono::steady_clock::time_point since,
+                   const char *name) {
+    if (timeout.count() > 0 && since + timeout < deadline) {
+      deadline = since + timeout;
+      reason = name;
+    }
+  };
+  check(m_options.idleTimeout, std::max(m_readTime, m_writeTime), "idle");
+  check(m_options.readTimeout, m_readTime, "read");
+  // without pending bytes, the write timeout is checked again after a whole
+  // timeout, so that a write started meanwhile is not missed.
+  check(m_options.writeTimeout, m_isWritting ? m_writeTime : now, "write");
+  if (deadline <= now) {
+    EXAMPLE_LOG_ERROR("TCP Connection Timeout error: ", reason, " timeout");
+    auto self = shared_from_this();
+    return close();
+  }
+  m_timingWheel->arm(m_timeoutTimer, deadline - now);
 }
 }  // namespace example
@@ -2,15 +2,50 @@
 #define EXAMPLE_TCP_CONNECTION_HPP
 
 #include <boost/asio.hpp>
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "Allocation.hpp"
+#ifdef EXAMPLE_IO_URING
+#include "BufferRing.hpp"
+#endif
+#include "ConnectionOptions.hpp"
+#include "FileRegion.hpp"
+#include "Framing.hpp"
+#include "Message.hpp"
+#include "Metrics.hpp"
+#include "ReceiveBuffer.hpp"
+#include "SendLimit.hpp"
+#include "SubmissionQueue.hpp"
+#include "TimingWheel.hpp"
+#include "TokenBucket.hpp"
+#include "WriteQueue.hpp"
 
 namespace example {
+/**
+ * ConnectionId type identifies a connection of a server. It is a
+ * generational handle, so the identifier of a closed connection is never
+ * given to another connection.
+ */
+using ConnectionId = uint64_t;
 /**
  * TcpConnection class controls asynchronous operations of a connected TCP
- * socket.
+ * or Unix domain stream socket. Connections are allocated from slabs, and
+ * completion handlers of read and write operations reuse per-connection
+ * memory. Idle, read and write timeouts are checked by a single timer of the
+ * TimingWheel of the io_context, which is only armed again when it expires.
+ * Messages can be sent from any thread: they are pushed to a lock-free
+ * SubmissionQueue, and the io thread is woken once to move every pending
+ * message into a single gather write.
  */
 class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
  public:
+  /**
+   * Socket type able to hold TCP and Unix domain stream sockets.
+   */
+  using Socket = boost::asio::generic::stream_protocol::socket;
   /**
    * Observer class allows monitoring of TcpConnection events.
    */
@@ -19,55 +54,252 @@ class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
      * virtual function called by TcpConnection after message is received.
      *
      * @param connectionId unique identifier of the TcpConnection.
-     * @param message received.
+     * @param message received, valid only during the call.
+     */
+    virtual void onReceived(ConnectionId connectionId,
+                            const MessageView &message);
+    /**
+     * virtual function called by TcpConnection after one or more messages
+     * are received by a single read operation. By default it calls
+     * onReceived() for each message.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     * @param messages received, valid only during the call.
+     */
+    virtual void onReceivedBatch(ConnectionId connectionId,
+                                 const MessageBatch &messages);
+    /**
+     * virtual function called by TcpConnection when the header of a message
+     * at least as large as the streaming threshold is received. Its payload
+     * is then delivered through onMessageChunk() as it arrives.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     * @param size of the message in bytes.
+     */
+    virtual void onMessageBegin(ConnectionId connectionId, size_t size);
+    /**
+     * virtual function called by TcpConnection with the next bytes of a
+     * message being streamed.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     * @param chunk of the message, valid only during the call.
+     */
+    virtual void onMessageChunk(ConnectionId connectionId,
+                                std::string_view chunk);
+    /**
+     * virtual function called by TcpConnection after the last chunk of a
+     * message being streamed.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     */
+    virtual void onMessageEnd(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpConnection when its send queue reaches
+     * the high watermark, from the thread calling send().
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     */
+    virtual void onSendQueueHigh(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpConnection when its send queue drains to
+     * the low watermark after having reached the high watermark.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     */
+    virtual void onWritable(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpConnection when it stops reading because
+     * its receive rate limits have been exceeded.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
+     */
+    virtual void onReceivePaused(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpConnection when it reads again after
+     * having been paused.
+     *
+     * @param connectionId unique identifier of the TcpConnection.
      */
-    virtual void onReceived(int connectionId, const std::string &message);
+    virtual void onReceiveResumed(ConnectionId connectionId);
     /**
      * virtual function called by TcpConnection after socket has been closed.
      *
      * @param connectionId unique identifier of the TcpConnection.
      */
-    virtual void onConnectionClosed(int connectionId);
+    virtual void onConnectionClosed(ConnectionId connectionId);
   };
   /**
    * Creates a TcpConnection instance.
    *
    * @param socket associated to the TcpConnection.
    * @param observer to monitor TcpConnection events.
+   * @param framing used to delimit messages.
+   * @param options configuring the TcpConnection.
+   * @param sendLimit shared with other connections, or nullptr.
+   * @param parentMetrics where traffic counters are also added, or nullptr.
    * @param id unique identifier the TcpConnection.
    */
   static std::shared_ptr<TcpConnection> create(
-      boost::asio::ip::tcp::socket &&socket, Observer &observer, int id = 0);
+      Socket &&socket, Observer &observer, const Framing &framing,
+      const ConnectionOptions &options, SendLimit *sendLimit = nullptr,
+      TrafficMetrics *parentMetrics = nullptr, ConnectionId id = 0);
   /**
-   * starts asynchronous read operations.
+   * Frames a message into a buffer that can be sent to several connections.
+   *
+   * @param framing used to delimit the message.
+   * @param message to frame.
+   * @return framed message, or nullptr if the message is too large.
+   */
+  static std::shared_ptr<const Buffer> frame(const Framing &framing,
+                                             std::string_view message);
+  /**
+   * starts asynchronous read operations, and timeouts if configured.
    */
   void startReceiving();
   /**
    * sends string message to peer connected to socket.
    *
    * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the send queue is full.
    */
-  void send(const std::string &message);
+  bool send(const std::string &message,
+            Priority priority = Priority::Normal);
+  /**
+   * sends string message to peer connected to socket, taking ownership of
+   * the message instead of copying it.
+   *
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the send queue is full.
+   */
+  bool send(std::string &&message, Priority priority = Priority::Normal);
+  /**
+   * sends message to peer connected to socket, sharing ownership of the
+   * message payload instead of copying it.
+   *
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the message is null or the send queue is full.
+   */
+  bool send(std::shared_ptr<const Buffer> message,
+            Priority priority = Priority::Normal);
+  /**
+   * sends a range of a file as a message, from the page cache to the socket
+   * without copying it through user space.
+   *
+   * @param path of the file.
+   * @param offset of the first byte to send.
+   * @param size in bytes to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the file cannot be opened or the send queue is full.
+   */
+  bool sendFile(const std::string &path, uint64_t offset, size_t size,
+                Priority priority = Priority::Normal);
+  /**
+   * sends a range of an open file as a message, sharing ownership of the
+   * file.
+   *
+   * @param file range to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the file is null or the send queue is full.
+   */
+  bool sendFile(std::shared_ptr<const FileRegion> file,
+                Priority priority = Priority::Normal);
+  /**
+   * sends a message already framed with the TcpConnection framing, sharing
+   * ownership of the frame.
+   *
+   * @param frame to send, as returned by frame().
+   * @return false if the frame is null or the send queue is full.
+   */
+  bool sendFrame(std::shared_ptr<const Buffer> frame);
+  /**
+   * returns number of bytes queued and not yet written to socket.
+   */
+  size_t pendingBytes();
+  /**
+   * returns a snapshot of the TcpConnection counters. It can be called from
+   * any thread.
+   */
+  ConnectionStats stats();
   /**
    * closes socket.
    */
   void close();
 
  private:
-  TcpConnection(boost::asio::ip::tcp::socket &&socket, Observer &observer,
-                int id);
+  struct ConstructionKey {};
+
+ public:
+  TcpConnection(ConstructionKey, Socket &&socket, Observer &observer,
+                const Framing &framing,
+                const ConnectionOptions &options, SendLimit *sendLimit,
+                TrafficMetrics *parentMetrics, ConnectionId id);
+  ~TcpConnection();
+
+ private:
 
-  void write();
-  void readHeader();
-  void readBody(size_t bytesToRead);
+  bool sendCompressed(std::string_view message, Priority priority,
+                      bool &isQueued);
+  template <typename Payload>
+  bool enqueueMessage(Payload &&payload, size_t payloadSize,
+                      Priority priority, uint8_t flags = 0);
+  template <typename Payload>
+  bool enqueue(const char *header, size_t headerSize, Payload &&payload,
+               size_t payloadSize, Priority priority);
+  bool reservePendingBytes(size_t size, bool &isSendQueueHigh);
+  bool releasePendingBytes(size_t size);
+  void submit();
+  void takeSubmissions();
+  void write(bool isZeroCopyAllowed = true);
+  void writeFile();
+  void writeZeroCopy(boost::asio::const_buffer payload);
+  void written(size_t bytesTransferred);
+  void readZeroCopyCompletions();
+  void read(size_t minBytesToRead);
+  void readNext(size_t minBytesToRead);
+  void resumeReceiving();
+  void receive(int result, const char *data);
+  bool received(size_t bytesTransferred, size_t &missingBytes);
+  bool deliver(size_t &missingBytes, size_t &messageCount);
+  void checkTimeouts();
 
-  boost::asio::ip::tcp::socket m_socket;
-  boost::asio::streambuf m_readBuffer;
-  boost::asio::streambuf m_writeBuffer;
-  std::mutex m_writeMutex;
+  Socket m_socket;
+  boost::asio::io_context &m_ioContext;
+  ReceiveBuffer m_readBuffer;
+  SubmissionQueue m_submissions;
+  WriteQueue m_writeQueue;
+  std::vector<MessageView> m_batch;
+  std::array<Buffer, FrameHeader::laneMask + 1> m_chunks;
+  Buffer m_decompressed;
+  HandlerMemory m_readHandlerMemory;
+  HandlerMemory m_writeHandlerMemory;
+  HandlerMemory m_submitHandlerMemory;
+  HandlerMemory m_zeroCopyHandlerMemory;
+  std::atomic<size_t> m_pendingBytes;
   Observer &m_observer;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+  SendLimit *m_sendLimit;
+  TrafficMetrics m_metrics;
+  const std::chrono::steady_clock::time_point m_creationTime;
+  std::chrono::steady_clock::time_point m_readTime;
+  std::chrono::steady_clock::time_point m_writeTime;
+  TimingWheel::Timer m_timeoutTimer;
+  TimingWheel *m_timingWheel;
+  TokenBucket m_receiveMessages;
+  TokenBucket m_receiveBytes;
+  TimingWheel::Timer m_throttleTimer;
+  size_t m_throttledBytesToRead;
+  size_t m_writeSize;
+  size_t m_zeroCopyThreshold;
+  uint32_t m_zeroCopySequence;
+  size_t m_streamedBytes;
+  uint64_t m_bufferRingReceiveId;
   bool m_isWritting;
-  int m_id;
+  bool m_isWaitingZeroCopy;
+  ConnectionId m_id;
 };
 }  // namespace example
 
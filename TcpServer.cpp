@@ -1,98 +1,416 @@
 #include "TcpServer.hpp"
 
-#include <iostream>
+#include <filesystem>
+#include <limits>
 
+#include "Logging.hpp"
 #include "TcpConnection.hpp"
 
+namespace {
+using ReusePort =
+    boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+}  // namespace
+
 namespace example {
 void TcpServer::Observer::onConnectionAccepted(
-    [[maybe_unused]] int connectionId) {}
+    [[maybe_unused]] ConnectionId connectionId) {}
 
 void TcpServer::Observer::onReceived(
-    [[maybe_unused]] int connectionId,
+    [[maybe_unused]] ConnectionId connectionId,
     [[maybe_unused]] const std::string &message) {}
 
+void TcpServer::Observer::onReceivedView(ConnectionId connectionId,
+                                         const MessageView &message) {
+  onReceived(connectionId, message.str());
+}
+
+void TcpServer::Observer::onReceivedBatch(ConnectionId connectionId,
+                                          const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    onReceivedView(connectionId, message);
+  }
+}
+
+void TcpServer::Observer::onMessageBegin(
+    [[maybe_unused]] ConnectionId connectionId, [[maybe_unused]] size_t size) {}
+
+void TcpServer::Observer::onMessageChunk(
+    [[maybe_unused]] ConnectionId connectionId,
+    [[maybe_unused]] std::string_view chunk) {}
+
+void TcpServer::Observer::onMessageEnd(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpServer::Observer::onSendQueueHigh(
+    [[maybe_unused]] ConnectionId connectionId) {
+}
+
+void TcpServer::Observer::onWritable(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpServer::Observer::onReceivePaused(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpServer::Observer::onReceiveResumed(
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+void TcpServer::Observer::onAcceptPaused() {}
+
+void TcpServer::Observer::onAcceptResumed() {}
+
 void TcpServer::Observer::onConnectionClosed(
-    [[maybe_unused]] int connectionId) {}
+    [[maybe_unused]] ConnectionId connectionId) {}
+
+TcpServer::TcpServer(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options)
+    : TcpServer{ioContext, observer, framing, options, 0, 1} {}
 
-TcpServer::TcpServer(boost::asio::io_context &ioContext, Observer &observer)
+TcpServer::TcpServer(boost::asio::io_context &ioContext, Observer &observer,
+                     const Framing &framing, const ConnectionOptions &options,
+                     int shardIndex, int shardCount)
     : m_ioContext{ioContext},
       m_acceptor{ioContext},
-      m_connections{},
+      m_connections{static_cast<uint32_t>(shardIndex),
+                    static_cast<uint32_t>(shardCount)},
+      m_submissions{},
+      m_submitHandlerMemory{},
       m_observer{observer},
-      m_connectionCount{0},
+      m_framing{framing},
+      m_options{options},
+      m_sendLimit{},
+      m_metrics{},
+      m_shardCount{shardCount},
+      m_slowReceiverPolicy{SlowReceiverPolicy::Enqueue},
+      m_slowReceiverPendingBytes{0},
+      m_maxConnections{std::numeric_limits<size_t>::max()},
+      m_acceptLimit{},
+      m_acceptTimer{[this]() { acceptNext(); }},
       m_isAccepting{false},
+      m_isAcceptPaused{false},
       m_isClosing{false} {}
 
 bool TcpServer::listen(const boost::asio::ip::tcp &protocol, uint16_t port) {
-  try {
-    m_acceptor.open(protocol);
-    m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-    m_acceptor.bind({protocol, port});
-    m_acceptor.listen(boost::asio::socket_base::max_connections);
-  } catch (const std::exception &e) {
-    std::cerr << "TCP Server Listen exception: " << e.what() << std::endl;
-    return false;
+  return doListen(boost::asio::ip::tcp::endpoint{protocol, port});
+}
+
+bool TcpServer::listen(
+    const boost::asio::local::stream_protocol::endpoint &endpoint) {
+  std::error_code error;
+  if (std::filesystem::is_socket(endpoint.path(), error)) {
+    std::filesystem::remove(endpoint.path(), error);
   }
-  return true;
+  return doListen(endpoint);
 }
 
 void TcpServer::startAcceptingConnections() {
   if (!m_isAccepting) {
-    doAccept();
+    acceptNext();
   }
 }
 
-void TcpServer::send(int connectionId, const std::string &message) {
-  if (m_connections.count(connectionId) == 0) {
-    std::cerr << "TCP Server Send error: connection not found" << std::endl;
-    return;
+bool TcpServer::send(ConnectionId connectionId, const std::string &message,
+                     Priority priority) {
+  return doSend(connectionId, message, priority);
+}
+
+bool TcpServer::send(ConnectionId connectionId, std::string &&message,
+                     Priority priority) {
+  return doSend(connectionId, std::move(message), priority);
+}
+
+bool TcpServer::send(ConnectionId connectionId,
+                     std::shared_ptr<const Buffer> message,
+                     Priority priority) {
+  return doSend(connectionId, std::move(message), priority);
+}
+
+bool TcpServer::sendFile(ConnectionId connectionId, const std::string &path,
+                         uint64_t offset, size_t size, Priority priority) {
+  auto connection = m_connections.find(connectionId);
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("TCP Server Send error: connection not found");
+    return false;
   }
-  m_connections.at(connectionId)->send(message);
+  return (*connection)->sendFile(path, offset, size, priority);
+}
+
+void TcpServer::submit(ConnectionId connectionId, const std::string &message,
+                       Priority priority) {
+  auto buffer = BufferPool::acquire();
+  buffer.assign(message);
+  doSubmit(connectionId, std::move(buffer), priority);
+}
+
+void TcpServer::submit(ConnectionId connectionId, std::string &&message,
+                       Priority priority) {
+  doSubmit(connectionId, std::move(message), priority);
+}
+
+void TcpServer::submit(ConnectionId connectionId,
+                       std::shared_ptr<const Buffer> message,
+                       Priority priority) {
+  if (message) {
+    doSubmit(connectionId, std::move(message), priority);
+  }
+}
+
+size_t TcpServer::broadcast(const std::string &message) {
+  auto frame = TcpConnection::frame(m_framing, message);
+  return frame ? broadcastFrame(frame) : 0;
+}
+
+size_t TcpServer::multicast(const std::vector<ConnectionId> &connectionIds,
+                            const std::string &message) {
+  auto frame = TcpConnection::frame(m_framing, message);
+  return frame ? multicastFrame(connectionIds, frame) : 0;
+}
+
+void TcpServer::setSlowReceiverPolicy(SlowReceiverPolicy policy,
+                                      size_t maxPendingBytes) {
+  m_slowReceiverPolicy = policy;
+  m_slowReceiverPendingBytes = maxPendingBytes;
+}
+
+void TcpServer::setMaxBufferedBytes(size_t maxBytes) {
+  m_sendLimit.setMaxBytes(maxBytes);
+}
+
+void TcpServer::setMaxConnections(size_t maxConnections) {
+  m_maxConnections = maxConnections;
+}
+
+void TcpServer::setAcceptRateLimit(const RateLimit &limit) {
+  m_acceptLimit = TokenBucket{limit};
+}
+
+ServerStats TcpServer::stats() const {
+  auto stats = m_metrics.stats();
+  stats.pendingBytes = m_sendLimit.bytes();
+  return stats;
+}
+
+bool TcpServer::stats(ConnectionId connectionId, ConnectionStats &stats) {
+  auto connection = m_connections.find(connectionId);
+  if (!connection) {
+    return false;
+  }
+  stats = (*connection)->stats();
+  return true;
 }
 
 void TcpServer::close() {
   m_isClosing = true;
   m_acceptor.cancel();
+  if (m_isAcceptPaused) {
+    // no accept operation is pending to reset the flags once aborted.
+    if (m_acceptTimer.isArmed()) {
+      TimingWheel::of(m_ioContext).cancel(m_acceptTimer);
+    }
+    m_isAcceptPaused = false;
+    m_isAccepting = false;
+  }
   for (const auto &connection : m_connections) {
-    connection.second->close();
+    connection->close();
+    m_metrics.recordClosed(connection->stats().lifetime);
   }
   m_connections.clear();
   m_isClosing = false;
-  std::cout << "TCP Server was closed" << std::endl;
+  EXAMPLE_LOG_INFO("TCP Server was closed");
+}
+
+bool TcpServer::doListen(
+    const boost::asio::generic::stream_protocol::endpoint &endpoint) {
+  try {
+    m_acceptor.open(endpoint.protocol());
+    m_acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    if (m_shardCount > 1) {
+      m_acceptor.set_option(ReusePort(true));
+    }
+    applySocketOptions(m_acceptor.native_handle(), m_options.socketOptions);
+    m_acceptor.bind(endpoint);
+    m_acceptor.listen(boost::asio::socket_base::max_connections);
+  } catch (const std::exception &e) {
+    EXAMPLE_LOG_ERROR("TCP Server Listen exception: ", e.what());
+    return false;
+  }
+  return true;
+}
+
+template <typename Message>
+bool TcpServer::doSend(ConnectionId connectionId, Message &&message,
+                       Priority priority) {
+  auto connection = m_connections.find(connectionId);
+  if (!connection) {
+    EXAMPLE_LOG_ERROR("TCP Server Send error: connection not found");
+    return false;
+  }
+  return (*connection)->send(std::forward<Message>(message), priority);
+}
+
+template <typename Message>
+void TcpServer::doSubmit(ConnectionId connectionId, Message &&message,
+                         Priority priority) {
+  if (m_submissions.push(connectionId, nullptr, 0,
+                         std::forward<Message>(message), priority)) {
+    boost::asio::post(m_ioContext,
+                      makeAllocatingHandler(m_submitHandlerMemory,
+                                            [this]() { takeSubmissions(); }));
+  }
+}
+
+void TcpServer::takeSubmissions() {
+  m_submissions.drain([this](auto &submission) {
+    if (submission.sharedPayload) {
+      doSend(submission.connectionId, std::move(submission.sharedPayload),
+             submission.priority);
+    } else {
+      doSend(submission.connectionId, std::move(submission.ownedPayload),
+             submission.priority);
+    }
+  });
+}
+
+bool TcpServer::sendFrame(
+    const std::shared_ptr<TcpConnection> &connection,
+    const std::shared_ptr<const Buffer> &frame,
+    std::vector<std::shared_ptr<TcpConnection>> &slowConnections) {
+  if (m_slowReceiverPolicy != SlowReceiverPolicy::Enqueue &&
+      connection->pendingBytes() > m_slowReceiverPendingBytes) {
+    if (m_slowReceiverPolicy == SlowReceiverPolicy::Disconnect) {
+      slowConnections.push_back(connection);
+    }
+    return false;
+  }
+  return connection->sendFrame(frame);
+}
+
+size_t TcpServer::broadcastFrame(const std::shared_ptr<const Buffer> &frame) {
+  size_t count{0};
+  std::vector<std::shared_ptr<TcpConnection>> slowConnections;
+  for (const auto &connection : m_connections) {
+    count += sendFrame(connection, frame, slowConnections);
+  }
+  for (const auto &connection : slowConnections) {
+    EXAMPLE_LOG_ERROR("TCP Server Broadcast error: slow receiver");
+    connection->close();
+  }
+  return count;
+}
+
+size_t TcpServer::multicastFrame(const std::vector<ConnectionId> &connectionIds,
+                                 const std::shared_ptr<const Buffer> &frame) {
+  size_t count{0};
+  std::vector<std::shared_ptr<TcpConnection>> slowConnections;
+  for (auto connectionId : connectionIds) {
+    auto connection = m_connections.find(connectionId);
+    if (connection) {
+      count += sendFrame(*connection, frame, slowConnections);
+    }
+  }
+  for (const auto &connection : slowConnections) {
+    EXAMPLE_LOG_ERROR("TCP Server Multicast error: slow receiver");
+    connection->close();
+  }
+  return count;
+}
+
+void TcpServer::acceptNext() {
+  bool isBelowMaxConnections{m_connections.size() < m_maxConnections};
+  auto now = std::chrono::steady_clock::now();
+  if (isBelowMaxConnections && m_acceptLimit.tryTake(1, now)) {
+    if (m_isAcceptPaused) {
+      m_isAcceptPaused = false;
+      EXAMPLE_LOG_INFO("TCP Server resumed accepting connections");
+      m_observer.onAcceptResumed();
+    }
+    return doAccept();
+  }
+  // a closed connection resumes accepting below the connection limit, and
+  // the timer once the accept rate allows it.
+  if (isBelowMaxConnections) {
+    TimingWheel::of(m_ioContext)
+        .arm(m_acceptTimer, m_acceptLimit.delay(1, now));
+  }
+  m_isAccepting = true;
+  if (!m_isAcceptPaused) {
+    m_isAcceptPaused = true;
+    EXAMPLE_LOG_INFO("TCP Server paused accepting connections");
+    m_observer.onAcceptPaused();
+  }
 }
 
 void TcpServer::doAccept() {
   m_isAccepting = true;
   m_acceptor.async_accept([this](const auto &error, auto socket) {
     if (error) {
-      std::cerr << "TCP Server Accept error: " << error.message() << std::endl;
+      EXAMPLE_LOG_ERROR("TCP Server Accept error: ", error.message());
+      if (error != boost::asio::error::operation_aborted) {
+        m_metrics.recordAcceptError();
+      }
       m_isAccepting = false;
       return;
     } else {
-      auto connection{
-          TcpConnection::create(std::move(socket), *this, m_connectionCount)};
+      auto connectionId = m_connections.insert(nullptr);
+      auto connection{TcpConnection::create(
+          std::move(socket), *this, m_framing, m_options, &m_sendLimit,
+          &m_metrics.traffic(), connectionId)};
+      *m_connections.find(connectionId) = connection;
       connection->startReceiving();
-      m_connections.insert({m_connectionCount, std::move(connection)});
-      std::cout << "TCP Server accepted connection" << std::endl;
-      m_observer.onConnectionAccepted(m_connectionCount);
-      m_connectionCount++;
+      m_metrics.recordAccepted();
+      EXAMPLE_LOG_INFO("TCP Server accepted connection");
+      m_observer.onConnectionAccepted(connectionId);
     }
-    doAccept();
+    acceptNext();
   });
 }
 
-void TcpServer::onReceived(int connectionId, const std::string &message) {
-  m_observer.onReceived(connectionId, message);
+void TcpServer::onReceivedBatch(ConnectionId connectionId,
+                                const MessageBatch &messages) {
+  m_observer.onReceivedBatch(connectionId, messages);
 }
 
-void TcpServer::onConnectionClosed(int connectionId) {
+void TcpServer::onMessageBegin(ConnectionId connectionId, size_t size) {
+  m_observer.onMessageBegin(connectionId, size);
+}
+
+void TcpServer::onMessageChunk(ConnectionId connectionId,
+                               std::string_view chunk) {
+  m_observer.onMessageChunk(connectionId, chunk);
+}
+
+void TcpServer::onMessageEnd(ConnectionId connectionId) {
+  m_observer.onMessageEnd(connectionId);
+}
+
+void TcpServer::onSendQueueHigh(ConnectionId connectionId) {
+  m_observer.onSendQueueHigh(connectionId);
+}
+
+void TcpServer::onWritable(ConnectionId connectionId) {
+  m_observer.onWritable(connectionId);
+}
+
+void TcpServer::onReceivePaused(ConnectionId connectionId) {
+  m_observer.onReceivePaused(connectionId);
+}
+
+void TcpServer::onReceiveResumed(ConnectionId connectionId) {
+  m_observer.onReceiveResumed(connectionId);
+}
+
+void TcpServer::onConnectionClosed(ConnectionId connectionId) {
   if (m_isClosing) {
     return;
   }
-  if (m_connections.erase(connectionId) > 0) {
-    std::cout << "TCP Server removed connection" << std::endl;
+  auto connection = m_connections.find(connectionId);
+  if (connection) {
+    m_metrics.recordClosed((*connection)->stats().lifetime);
+    m_connections.erase(connectionId);
+    EXAMPLE_LOG_INFO("TCP Server removed connection");
     m_observer.onConnectionClosed(connectionId);
+    if (m_isAcceptPaused && !m_acceptTimer.isArmed()) {
+      acceptNext();
+    }
   }
 }
 }  // namespace example
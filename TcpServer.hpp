@@ -3,17 +3,32 @@
 
 #include <boost/asio.hpp>
 #include <map>
+#include <vector>
 
+#include "SlotMap.hpp"
 #include "TcpConnection.hpp"
 
 namespace example {
 /**
  * TcpServer class allows to accept TCP connections at any network interface,
- * with specified protocol, and specified port, and use associated connections
- * to send and receive string messages.
+ * with specified protocol, and specified port, or Unix domain socket
+ * connections at specified path, and use associated connections to send and
+ * receive string messages.
  */
 class TcpServer : private TcpConnection::Observer {
  public:
+  /**
+   * SlowReceiverPolicy enum specifies how broadcast() and multicast() treat
+   * connections whose pending bytes exceed the configured limit.
+   */
+  enum class SlowReceiverPolicy {
+    /** message is queued regardless of pending bytes. */
+    Enqueue,
+    /** message is not sent to the slow connection. */
+    Skip,
+    /** slow connection is closed. */
+    Disconnect
+  };
   /**
    * Observer class allows monitoring of TcpServer events.
    */
@@ -24,28 +39,120 @@ class TcpServer : private TcpConnection::Observer {
      *
      * @param connectionId unique identifier of the accepted connection.
      */
-    virtual void onConnectionAccepted(int connectionId);
+    virtual void onConnectionAccepted(ConnectionId connectionId);
     /**
      * virtual function called by TcpServer after message has been received.
      *
      * @param connectionId unique identifier of the receiving connection.
      * @param message received at associated connection.
      */
-    virtual void onReceived(int connectionId, const std::string &message);
+    virtual void onReceived(ConnectionId connectionId,
+                            const std::string &message);
+    /**
+     * virtual function called by TcpServer after message has been received,
+     * without copying the message out of the connection receive buffer. By
+     * default it calls onReceived() with a copy of the message.
+     *
+     * @param connectionId unique identifier of the receiving connection.
+     * @param message received at associated connection, valid only during
+     * the call. MessageView::retain() keeps it valid afterwards.
+     */
+    virtual void onReceivedView(ConnectionId connectionId,
+                                const MessageView &message);
+    /**
+     * virtual function called by TcpServer after one or more messages have
+     * been received by a single read operation of a connection. By default
+     * it calls onReceivedView() for each message.
+     *
+     * @param connectionId unique identifier of the receiving connection.
+     * @param messages received at associated connection, valid only during
+     * the call.
+     */
+    virtual void onReceivedBatch(ConnectionId connectionId,
+                                 const MessageBatch &messages);
+    /**
+     * virtual function called by TcpServer when a connection receives the
+     * header of a message at least as large as the streaming threshold. Its
+     * payload is then delivered through onMessageChunk() as it arrives.
+     *
+     * @param connectionId unique identifier of the receiving connection.
+     * @param size of the message in bytes.
+     */
+    virtual void onMessageBegin(ConnectionId connectionId, size_t size);
+    /**
+     * virtual function called by TcpServer with the next bytes of a message
+     * being streamed.
+     *
+     * @param connectionId unique identifier of the receiving connection.
+     * @param chunk of the message, valid only during the call.
+     */
+    virtual void onMessageChunk(ConnectionId connectionId,
+                                std::string_view chunk);
+    /**
+     * virtual function called by TcpServer after the last chunk of a message
+     * being streamed.
+     *
+     * @param connectionId unique identifier of the receiving connection.
+     */
+    virtual void onMessageEnd(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpServer when the send queue of a
+     * connection reaches its high watermark, from the thread calling send().
+     *
+     * @param connectionId unique identifier of the connection.
+     */
+    virtual void onSendQueueHigh(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpServer when the send queue of a
+     * connection drains to its low watermark after having reached its high
+     * watermark.
+     *
+     * @param connectionId unique identifier of the connection.
+     */
+    virtual void onWritable(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpServer when a connection stops reading
+     * because its receive rate limits have been exceeded.
+     *
+     * @param connectionId unique identifier of the connection.
+     */
+    virtual void onReceivePaused(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpServer when a connection reads again
+     * after having been paused.
+     *
+     * @param connectionId unique identifier of the connection.
+     */
+    virtual void onReceiveResumed(ConnectionId connectionId);
+    /**
+     * virtual function called by TcpServer when it stops accepting
+     * connections because the connection limit or the accept rate limit has
+     * been reached. Pending connections wait in the listen backlog.
+     */
+    virtual void onAcceptPaused();
+    /**
+     * virtual function called by TcpServer when it accepts connections again
+     * after having been paused.
+     */
+    virtual void onAcceptResumed();
     /**
      * virtual function called by TcpServer after a connection has been closed.
      *
      * @param connectionId unique identifier of the closed connection.
      */
-    virtual void onConnectionClosed(int connectionId);
+    virtual void onConnectionClosed(ConnectionId connectionId);
   };
   /**
    * Constructs a TcpServer object.
    *
    * @param ioContext required for asynchronous input and output operations.
    * @param observer to monitor TcpServer events.
+   * @param framing used to delimit messages on every connection.
+   * @param options configuring every connection.
    */
-  TcpServer(boost::asio::io_context &ioContext, Observer &observer);
+  TcpServer(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing = Framing::text(),
+            const ConnectionOptions &options = {});
   /**
    * listen for connections at any interface with specified
    * protocol to specified port.
@@ -54,18 +161,166 @@ class TcpServer : private TcpConnection::Observer {
    * @param port to listen to.
    */
   bool listen(const boost::asio::ip::tcp &protocol, uint16_t port);
+  /**
+   * listen for connections at specified Unix domain socket path, replacing
+   * any socket file left at the path.
+   *
+   * @param endpoint to listen at.
+   */
+  bool listen(const boost::asio::local::stream_protocol::endpoint &endpoint);
   /**
    * starts accepting connections and associated asynchronous read and
    * write operations.
    */
   void startAcceptingConnections();
   /**
-   * Sends string message to peer associated to specified connection.
+   * Sends string message to peer associated to specified connection. It
+   * must be called from the thread running the io_context; submit() sends
+   * from any other thread.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, const std::string &message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends string message to peer associated to specified connection, taking
+   * ownership of the message instead of copying it. It must be called from
+   * the thread running the io_context.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, std::string &&message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends message to peer associated to specified connection, sharing
+   * ownership of the message payload instead of copying it. It must be called
+   * from the thread running the io_context.
    *
    * @param connectionId unique identifier associated to receiving peer.
    * @param message to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the connection does not exist or its send queue is full.
+   */
+  bool send(ConnectionId connectionId, std::shared_ptr<const Buffer> message,
+            Priority priority = Priority::Normal);
+  /**
+   * Sends a range of a file as a message to peer associated to specified
+   * connection, without copying it through user space. It must be called from
+   * the thread running the io_context.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param path of the file.
+   * @param offset of the first byte to send.
+   * @param size in bytes to send.
+   * @param priority of the lane the message is sent on.
+   * @return false if the connection does not exist, the file cannot be
+   * opened or the send queue is full.
    */
-  void send(int connectionId, const std::string &message);
+  bool sendFile(ConnectionId connectionId, const std::string &path,
+                uint64_t offset, size_t size,
+                Priority priority = Priority::Normal);
+  /**
+   * Submits string message to peer associated to specified connection. It
+   * can be called from any thread: messages are pushed to a lock-free
+   * SubmissionQueue, which the thread running the io_context drains in
+   * batches after a single wakeup. Messages to connections that do not
+   * exist or whose send queue is full are discarded.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void submit(ConnectionId connectionId, const std::string &message,
+              Priority priority = Priority::Normal);
+  /**
+   * Submits string message to peer associated to specified connection,
+   * taking ownership of the message instead of copying it. It can be called
+   * from any thread.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void submit(ConnectionId connectionId, std::string &&message,
+              Priority priority = Priority::Normal);
+  /**
+   * Submits message to peer associated to specified connection, sharing
+   * ownership of the message payload instead of copying it. It can be called
+   * from any thread.
+   *
+   * @param connectionId unique identifier associated to receiving peer.
+   * @param message to send.
+   * @param priority of the lane the message is sent on.
+   */
+  void submit(ConnectionId connectionId, std::shared_ptr<const Buffer> message,
+              Priority priority = Priority::Normal);
+  /**
+   * Sends string message to peers associated to every connection. The
+   * message is framed once and the frame is shared by every connection.
+   *
+   * @param message to send.
+   * @return number of connections the message was queued at.
+   */
+  size_t broadcast(const std::string &message);
+  /**
+   * Sends string message to peers associated to specified connections. The
+   * message is framed once and the frame is shared by every connection.
+   *
+   * @param connectionIds unique identifiers associated to receiving peers.
+   * @param message to send.
+   * @return number of connections the message was queued at.
+   */
+  size_t multicast(const std::vector<ConnectionId> &connectionIds,
+                   const std::string &message);
+  /**
+   * Sets how broadcast() and multicast() treat slow receivers. By default
+   * messages are queued regardless of pending bytes.
+   *
+   * @param policy applied to slow receivers.
+   * @param maxPendingBytes above which a connection is a slow receiver.
+   */
+  void setSlowReceiverPolicy(SlowReceiverPolicy policy,
+                             size_t maxPendingBytes);
+  /**
+   * Sets number of bytes pending to be sent by all connections at which
+   * further sends are rejected. By default it is unbounded.
+   *
+   * @param maxBytes pending.
+   */
+  void setMaxBufferedBytes(size_t maxBytes);
+  /**
+   * Sets number of connections at which accepting pauses until one of them
+   * is closed. By default it is unbounded.
+   *
+   * @param maxConnections open at once.
+   */
+  void setMaxConnections(size_t maxConnections);
+  /**
+   * Sets rate at which connections are accepted, pausing accepting while it
+   * is exceeded. By default it is unlimited.
+   *
+   * @param limit of accepted connections per second.
+   */
+  void setAcceptRateLimit(const RateLimit &limit);
+  /**
+   * returns a snapshot of the counters of the TcpServer and its connections,
+   * including connections already closed. It can be called from any thread.
+   */
+  ServerStats stats() const;
+  /**
+   * gets a snapshot of the counters of specified connection.
+   *
+   * @param connectionId unique identifier of the connection.
+   * @param stats of the connection.
+   * @return false if the connection does not exist.
+   */
+  bool stats(ConnectionId connectionId, ConnectionStats &stats);
   /**
    * Close active connections and stops accepting new connections. In order to
    * restart operation, a call to functions listen() and
@@ -74,16 +329,61 @@ class TcpServer : private TcpConnection::Observer {
   void close();
 
  private:
+  friend class ShardedTcpServer;
+  using ConnectionMap = SlotMap<std::shared_ptr<TcpConnection>>;
+
+  TcpServer(boost::asio::io_context &ioContext, Observer &observer,
+            const Framing &framing, const ConnectionOptions &options,
+            int shardIndex, int shardCount);
+
+  bool doListen(
+      const boost::asio::generic::stream_protocol::endpoint &endpoint);
+  template <typename Message>
+  bool doSend(ConnectionId connectionId, Message &&message,
+              Priority priority);
+  template <typename Message>
+  void doSubmit(ConnectionId connectionId, Message &&message,
+                Priority priority);
+  void takeSubmissions();
+  bool sendFrame(const std::shared_ptr<TcpConnection> &connection,
+                 const std::shared_ptr<const Buffer> &frame,
+                 std::vector<std::shared_ptr<TcpConnection>> &slowConnections);
+  size_t broadcastFrame(const std::shared_ptr<const Buffer> &frame);
+  size_t multicastFrame(const std::vector<ConnectionId> &connectionIds,
+                        const std::shared_ptr<const Buffer> &frame);
+  void acceptNext();
   void doAccept();
-  void onReceived(int connectionId, const std::string &message) override;
-  void onConnectionClosed(int connectionId) override;
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+  void onMessageBegin(ConnectionId connectionId, size_t size) override;
+  void onMessageChunk(ConnectionId connectionId,
+                      std::string_view chunk) override;
+  void onMessageEnd(ConnectionId connectionId) override;
+  void onSendQueueHigh(ConnectionId connectionId) override;
+  void onWritable(ConnectionId connectionId) override;
+  void onReceivePaused(ConnectionId connectionId) override;
+  void onReceiveResumed(ConnectionId connectionId) override;
+  void onConnectionClosed(ConnectionId connectionId) override;
 
   boost::asio::io_context &m_ioContext;
-  boost::asio::ip::tcp::acceptor m_acceptor;
-  std::unordered_map<int, std::shared_ptr<TcpConnection>> m_connections;
+  boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol>
+      m_acceptor;
+  ConnectionMap m_connections;
+  SubmissionQueue m_submissions;
+  HandlerMemory m_submitHandlerMemory;
   Observer &m_observer;
-  int m_connectionCount;
+  const Framing &m_framing;
+  const ConnectionOptions m_options;
+  SendLimit m_sendLimit;
+  ServerMetrics m_metrics;
+  int m_shardCount;
+  SlowReceiverPolicy m_slowReceiverPolicy;
+  size_t m_slowReceiverPendingBytes;
+  size_t m_maxConnections;
+  TokenBucket m_acceptLimit;
+  TimingWheel::Timer m_acceptTimer;
   bool m_isAccepting;
+  bool m_isAcceptPaused;
   bool m_isClosing;
 };
 }  // namespace example
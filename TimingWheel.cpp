@@ -0,0 +1,194 @@
+#include "TimingWheel.hpp"
+
+namespace {
+constexpr size_t f_slotBits{6};
+static_assert(example::TimingWheel::slotCount == size_t{1} << f_slotBits);
+constexpr uint64_t f_slotMask{example::TimingWheel::slotCount - 1};
+constexpr uint64_t f_maxDelta{
+    (uint64_t{1} << (f_slotBits * example::TimingWheel::levelCount)) - 1};
+
+uint64_t slotIndex(uint64_t tick, size_t level) {
+  return (tick >> (f_slotBits * level)) & f_slotMask;
+}
+}  // namespace
+
+namespace example {
+boost::asio::io_context::id TimingWheel::id;
+
+TimingWheel::Timer::Timer(std::function<void()> callback)
+    : m_callback{std::move(callback)},
+      m_wheel{nullptr},
+      m_slot{nullptr},
+      m_previous{nullptr},
+      m_next{nullptr},
+      m_expiryTick{0},
+      m_level{0} {}
+
+TimingWheel::Timer::~Timer() {
+  if (m_wheel) {
+    m_wheel->cancel(*this);
+  }
+}
+
+bool TimingWheel::Timer::isArmed() const { return m_wheel != nullptr; }
+
+TimingWheel &TimingWheel::of(boost::asio::io_context &ioContext) {
+  return boost::asio::use_service<TimingWheel>(ioContext);
+}
+
+TimingWheel::TimingWheel(boost::asio::io_context &ioContext)
+    : boost::asio::io_context::service{ioContext},
+      m_timer{ioContext},
+      m_startTime{std::chrono::steady_clock::now()},
+      m_slots{},
+      m_levelSizes{},
+      m_tick{0},
+      m_scheduledTick{0},
+      m_size{0},
+      m_isScheduled{false} {}
+
+void TimingWheel::arm(Timer &timer, std::chrono::nanoseconds delay) {
+  cancel(timer);
+  auto now = currentTick();
+  if (m_size == 0) {
+    m_tick = now;
+  }
+  auto ticks = (std::max<int64_t>(delay.count(), 1) +
+                std::chrono::nanoseconds{resolution}.count() - 1) /
+               std::chrono::nanoseconds{resolution}.count();
+  timer.m_expiryTick = now + static_cast<uint64_t>(ticks);
+  timer.m_wheel = this;
+  insert(timer);
+  m_size++;
+  schedule();
+}
+
+void TimingWheel::cancel(Timer &timer) {
+  if (timer.m_wheel != this) {
+    return;
+  }
+  unlink(timer);
+  timer.m_wheel = nullptr;
+  m_size--;
+}
+
+size_t TimingWheel::size() const { return m_size; }
+
+void TimingWheel::shutdown() {
+  for (auto &level : m_slots) {
+    for (auto &slot : level) {
+      while (slot) {
+        auto &timer = *slot;
+        unlink(timer);
+        timer.m_wheel = nullptr;
+      }
+    }
+  }
+  m_size = 0;
+  boost::system::error_code error;
+  m_timer.cancel(error);
+}
+
+uint64_t TimingWheel::currentTick() const {
+  return static_cast<uint64_t>((std::chrono::steady_clock::now() -
+                                m_startTime) /
+                               resolution);
+}
+
+void TimingWheel::insert(Timer &timer) {
+  auto delta = std::min(timer.m_expiryTick - std::min(timer.m_expiryTick,
+                                                      m_tick),
+                        f_maxDelta);
+  size_t level{0};
+  while (level < levelCount - 1 &&
+         delta >> (f_slotBits * (level + 1)) != 0) {
+    level++;
+  }
+  auto &slot = m_slots[level][slotIndex(m_tick + delta, level)];
+  timer.m_slot = &slot;
+  timer.m_level = level;
+  timer.m_previous = nullptr;
+  timer.m_next = slot;
+  if (slot) {
+    slot->m_previous = &timer;
+  }
+  slot = &timer;
+  m_levelSizes[level]++;
+}
+
+void TimingWheel::unlink(Timer &timer) {
+  if (timer.m_previous) {
+    timer.m_previous->m_next = timer.m_next;
+  } else {
+    *timer.m_slot = timer.m_next;
+  }
+  if (timer.m_next) {
+    timer.m_next->m_previous = timer.m_previous;
+  }
+  m_levelSizes[timer.m_level]--;
+  timer.m_slot = nullptr;
+  timer.m_previous = nullptr;
+  timer.m_next = nullptr;
+}
+
+void TimingWheel::schedule() {
+  if (m_size == 0) {
+    return;
+  }
+  // with no timer in the lowest wheel, nothing can expire before timers of
+  // the next wheel are moved down at the next boundary.
+  auto tick = m_levelSizes[0] > 0
+                  ? m_tick + 1
+                  : ((m_tick >> f_slotBits) + 1) << f_slotBits;
+  if (m_isScheduled && m_scheduledTick <= tick) {
+    return;
+  }
+  m_isScheduled = true;
+  m_scheduledTick = tick;
+  m_timer.expires_at(m_startTime + tick * resolution);
+  m_timer.async_wait([this](const auto &error) {
+    if (error) {
+      return;
+    }
+    m_isScheduled = false;
+    advance(currentTick());
+    schedule();
+  });
+}
+
+void TimingWheel::advance(uint64_t tick) {
+  while (m_tick < tick && m_size > 0) {
+    if (m_levelSizes[0] == 0) {
+      auto boundary = ((m_tick >> f_slotBits) + 1) << f_slotBits;
+      if (boundary > tick) {
+        m_tick = tick;
+        break;
+      }
+      m_tick = boundary - 1;
+    }
+    m_tick++;
+    for (size_t level = 1;
+         level < levelCount && slotIndex(m_tick, level - 1) == 0; level++) {
+      cascade(level);
+    }
+    expire(m_slots[0][slotIndex(m_tick, 0)]);
+  }
+}
+
+void TimingWheel::cascade(size_t level) {
+  auto &slot = m_slots[level][slotIndex(m_tick, level)];
+  while (slot) {
+    auto &timer = *slot;
+    unlink(timer);
+    insert(timer);
+  }
+}
+
+void TimingWheel::expire(Timer *&slot) {
+  while (slot) {
+    auto &timer = *slot;
+    cancel(timer);
+    timer.m_callback();
+  }
+}
+}  // namespace example
@@ -0,0 +1,120 @@
+#ifndef EXAMPLE_TIMING_WHEEL_HPP
+#define EXAMPLE_TIMING_WHEEL_HPP
+
+#include <array>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace example {
+/**
+ * TimingWheel class schedules a large number of timers on an io_context with
+ * a single steady_timer. Timers are kept in intrusive lists in a hierarchy
+ * of wheels, so that arming and cancelling a timer takes constant time and
+ * timers far in the future are only moved down a level once in a while. It
+ * is an io_context service, and must only be used from the threads running
+ * that io_context.
+ */
+class TimingWheel : public boost::asio::io_context::service {
+ public:
+  /**
+   * duration of a tick, the precision of the timers.
+   */
+  static constexpr std::chrono::milliseconds resolution{1};
+  /**
+   * number of slots of each wheel.
+   */
+  static constexpr size_t slotCount{64};
+  /**
+   * number of wheels, each one spanning slotCount times the previous one.
+   */
+  static constexpr size_t levelCount{4};
+  /**
+   * Timer class holds a callback called by TimingWheel when the timer
+   * expires. It is cancelled when destroyed.
+   */
+  class Timer {
+   public:
+    /**
+     * Constructs a Timer object.
+     *
+     * @param callback called when the timer expires.
+     */
+    explicit Timer(std::function<void()> callback);
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+    ~Timer();
+    /**
+     * returns true if the timer is armed.
+     */
+    bool isArmed() const;
+
+   private:
+    friend class TimingWheel;
+
+    std::function<void()> m_callback;
+    TimingWheel *m_wheel;
+    Timer **m_slot;
+    Timer *m_previous;
+    Timer *m_next;
+    uint64_t m_expiryTick;
+    size_t m_level;
+  };
+  /**
+   * identifier of the service.
+   */
+  static boost::asio::io_context::id id;
+  /**
+   * returns the TimingWheel of specified io_context, creating it if needed.
+   *
+   * @param ioContext running the timers.
+   */
+  static TimingWheel &of(boost::asio::io_context &ioContext);
+  /**
+   * Constructs a TimingWheel object. Use of() instead.
+   *
+   * @param ioContext running the timers.
+   */
+  explicit TimingWheel(boost::asio::io_context &ioContext);
+  /**
+   * arms a timer, replacing any previous expiry.
+   *
+   * @param timer to arm.
+   * @param delay after which the timer expires, rounded up to the
+   * resolution.
+   */
+  void arm(Timer &timer, std::chrono::nanoseconds delay);
+  /**
+   * cancels a timer if it is armed.
+   *
+   * @param timer to cancel.
+   */
+  void cancel(Timer &timer);
+  /**
+   * returns number of armed timers.
+   */
+  size_t size() const;
+
+ private:
+  void shutdown() override;
+  uint64_t currentTick() const;
+  void insert(Timer &timer);
+  void unlink(Timer &timer);
+  void schedule();
+  void advance(uint64_t tick);
+  void cascade(size_t level);
+  void expire(Timer *&slot);
+
+  boost::asio::steady_timer m_timer;
+  const std::chrono::steady_clock::time_point m_startTime;
+  std::array<std::array<Timer *, slotCount>, levelCount> m_slots;
+  std::array<size_t, levelCount> m_levelSizes;
+  uint64_t m_tick;
+  uint64_t m_scheduledTick;
+  size_t m_size;
+  bool m_isScheduled;
+};
+}  // namespace example
+
+#endif
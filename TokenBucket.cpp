@@ -0,0 +1,61 @@
+#include "TokenBucket.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace example {
+TokenBucket::TokenBucket() : TokenBucket{RateLimit{}} {}
+
+TokenBucket::TokenBucket(const RateLimit &limit)
+    : m_rate{std::max(limit.rate, 0.0)},
+      // a burst below one token would never allow a single event.
+      m_burst{std::max(limit.burst > 0 ? limit.burst : m_rate, 1.0)},
+      m_tokens{m_burst},
+      m_refillTime{std::chrono::steady_clock::now()} {}
+
+bool TokenBucket::isLimited() const { return m_rate > 0; }
+
+bool TokenBucket::tryTake(double tokens,
+                          std::chrono::steady_clock::time_point now) {
+  if (!isLimited()) {
+    return true;
+  }
+  refill(now);
+  if (m_tokens < tokens) {
+    return false;
+  }
+  m_tokens -= tokens;
+  return true;
+}
+
+void TokenBucket::take(double tokens,
+                       std::chrono::steady_clock::time_point now) {
+  if (isLimited()) {
+    refill(now);
+    m_tokens -= tokens;
+  }
+}
+
+std::chrono::nanoseconds TokenBucket::delay(
+    double tokens, std::chrono::steady_clock::time_point now) {
+  if (!isLimited()) {
+    return std::chrono::nanoseconds{0};
+  }
+  refill(now);
+  if (m_tokens >= tokens) {
+    return std::chrono::nanoseconds{0};
+  }
+  // rounded up, so that the bucket holds the tokens once the delay elapses.
+  return std::chrono::nanoseconds{
+      static_cast<int64_t>(std::ceil((tokens - m_tokens) / m_rate * 1e9))};
+}
+
+void TokenBucket::refill(std::chrono::steady_clock::time_point now) {
+  if (now <= m_refillTime) {
+    return;
+  }
+  auto elapsed = std::chrono::duration<double>(now - m_refillTime).count();
+  m_tokens = std::min(m_tokens + elapsed * m_rate, m_burst);
+  m_refillTime = now;
+}
+}  // namespace example
@@ -0,0 +1,78 @@
+#ifndef EXAMPLE_TOKEN_BUCKET_HPP
+#define EXAMPLE_TOKEN_BUCKET_HPP
+
+#include <chrono>
+
+namespace example {
+/**
+ * RateLimit struct configures a TokenBucket.
+ */
+struct RateLimit {
+  /**
+   * number of tokens added per second, or zero for no limit.
+   */
+  double rate{0};
+  /**
+   * number of tokens the bucket holds when full, which is the largest burst
+   * allowed, or zero for a second worth of tokens. It is at least one.
+   */
+  double burst{0};
+};
+/**
+ * TokenBucket class limits the average rate of events, such as accepted
+ * connections or received bytes, while allowing bursts up to its capacity.
+ * It is not thread safe: it is used by the thread running the io_context.
+ */
+class TokenBucket {
+ public:
+  /**
+   * Constructs an unlimited TokenBucket object.
+   */
+  TokenBucket();
+  /**
+   * Constructs a full TokenBucket object.
+   *
+   * @param limit configuring the bucket.
+   */
+  explicit TokenBucket(const RateLimit &limit);
+  /**
+   * returns false if the bucket never runs out of tokens.
+   */
+  bool isLimited() const;
+  /**
+   * takes specified tokens if the bucket holds them.
+   *
+   * @param tokens to take.
+   * @param now current time.
+   * @return false if the bucket does not hold enough tokens.
+   */
+  bool tryTake(double tokens, std::chrono::steady_clock::time_point now);
+  /**
+   * takes specified tokens for events that already happened, leaving the
+   * bucket in debt if it does not hold enough of them.
+   *
+   * @param tokens to take.
+   * @param now current time.
+   */
+  void take(double tokens, std::chrono::steady_clock::time_point now);
+  /**
+   * returns time until the bucket holds specified tokens, zero if it
+   * already does.
+   *
+   * @param tokens required.
+   * @param now current time.
+   */
+  std::chrono::nanoseconds delay(double tokens,
+                                 std::chrono::steady_clock::time_point now);
+
+ private:
+  void refill(std::chrono::steady_clock::time_point now);
+
+  double m_rate;
+  double m_burst;
+  double m_tokens;
+  std::chrono::steady_clock::time_point m_refillTime;
+};
+}  // namespace example
+
+#endif
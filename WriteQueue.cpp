@@ -0,0 +1,305 @@
+#include "WriteQueue.hpp"
+
+#include <algorithm>
+
+#include "Allocation.hpp"
+
+namespace example {
+WriteQueue::BufferSequence::BufferSequence(
+    const boost::asio::const_buffer *begin,
+    const boost::asio::const_buffer *end)
+    : m_begin{begin}, m_end{end} {}
+
+const boost::asio::const_buffer *WriteQueue::BufferSequence::begin() const {
+  return m_begin;
+}
+
+const boost::asio::const_buffer *WriteQueue::BufferSequence::end() const {
+  return m_end;
+}
+
+WriteQueue::WriteQueue()
+    : m_framing{nullptr},
+      m_chunkSize{0},
+      m_lanes{},
+      m_buffers{},
+      m_zeroCopyPayloads{},
+      m_size{0} {}
+
+WriteQueue::WriteQueue(const Framing &framing, size_t chunkSize)
+    : m_framing{&framing},
+      m_chunkSize{framing.hasFlags() ? chunkSize : 0},
+      m_lanes{},
+      m_buffers{},
+      m_zeroCopyPayloads{},
+      m_size{0} {}
+
+size_t WriteQueue::frameSize(size_t headerSize, size_t payloadSize) const {
+  if (!isChunked(headerSize, payloadSize)) {
+    return headerSize + payloadSize;
+  }
+  // headers of framings carrying flags have a fixed size.
+  auto chunkCount = (payloadSize + m_chunkSize - 1) / m_chunkSize;
+  return chunkCount * headerSize + payloadSize;
+}
+
+void WriteQueue::push(const char *header, size_t headerSize,
+                      std::string &&payload, Priority priority) {
+  auto &entry = pushEntry(header, headerSize, payload.size(), priority);
+  entry.ownedPayload = std::move(payload);
+  entry.payload = entry.ownedPayload;
+}
+
+void WriteQueue::push(const char *header, size_t headerSize,
+                      std::shared_ptr<const Buffer> payload,
+                      Priority priority) {
+  auto &entry = pushEntry(header, headerSize, payload->size(), priority);
+  entry.sharedPayload = std::move(payload);
+  entry.payload = *entry.sharedPayload;
+}
+
+void WriteQueue::push(const char *header, size_t headerSize,
+                      std::shared_ptr<const FileRegion> payload,
+                      Priority priority) {
+  auto &entry = pushEntry(header, headerSize, payload->size(), priority);
+  entry.filePayload = std::move(payload);
+}
+
+void WriteQueue::push(SubmissionQueue::Submission &submission) {
+  if (submission.sharedPayload) {
+    push(submission.header.data(), submission.headerSize,
+         std::move(submission.sharedPayload), submission.priority);
+  } else if (submission.filePayload) {
+    push(submission.header.data(), submission.headerSize,
+         std::move(submission.filePayload), submission.priority);
+  } else {
+    push(submission.header.data(), submission.headerSize,
+         std::move(submission.ownedPayload), submission.priority);
+  }
+  const auto &lane = m_lanes[static_cast<size_t>(submission.priority)];
+  entry(static_cast<size_t>(submission.priority), lane.count - 1).queuedAt =
+      submission.queuedAt;
+}
+
+bool WriteQueue::empty() const { return m_size == 0; }
+
+size_t WriteQueue::size() const { return m_size; }
+
+WriteQueue::BufferSequence WriteQueue::buffers(size_t zeroCopyThreshold) {
+  size_t count{0};
+  // returns false if no frame can follow the one of the entry.
+  auto append = [this, &count, zeroCopyThreshold](const Entry &entry) {
+    if (entry.offset < entry.headerSize) {
+      m_buffers[count++] = {entry.header.data() + entry.offset,
+                            entry.headerSize - entry.offset};
+    }
+    if (entry.filePayload ||
+        (zeroCopyThreshold > 0 && entry.frameSize >= zeroCopyThreshold)) {
+      return false;
+    }
+    auto payloadOffset =
+        entry.offset - std::min(entry.offset, entry.headerSize);
+    if (payloadOffset < entry.frameSize) {
+      m_buffers[count++] = {
+          entry.payload.data() + entry.frameOffset + payloadOffset,
+          entry.frameSize - payloadOffset};
+    }
+    // the next chunk has to wait for its header, and for messages of higher
+    // priority queued in the meantime.
+    return !entry.isChunked;
+  };
+  auto firstLane = nextLane();
+  if (firstLane == laneCount) {
+    return {m_buffers.data(), m_buffers.data()};
+  }
+  // a frame partially written is completed before any other.
+  auto isPartial = entry(firstLane, 0).offset > 0;
+  if (isPartial && !append(entry(firstLane, 0))) {
+    return {m_buffers.data(), m_buffers.data() + count};
+  }
+  for (size_t lane = 0; lane < laneCount; lane++) {
+    for (size_t i = isPartial && lane == firstLane ? 1 : 0;
+         i < m_lanes[lane].count; i++) {
+      if (count + 2 > maxBufferCount || !append(entry(lane, i))) {
+        return {m_buffers.data(), m_buffers.data() + count};
+      }
+    }
+  }
+  return {m_buffers.data(), m_buffers.data() + count};
+}
+
+bool WriteQueue::zeroCopyPayload(size_t zeroCopyThreshold,
+                                 boost::asio::const_buffer &payload) const {
+  auto lane = nextLane();
+  if (zeroCopyThreshold == 0 || lane == laneCount) {
+    return false;
+  }
+  const auto &entry = this->entry(lane, 0);
+  if (entry.filePayload || entry.frameSize < zeroCopyThreshold ||
+      entry.offset < entry.headerSize) {
+    return false;
+  }
+  auto payloadOffset = entry.offset - entry.headerSize;
+  payload = {entry.payload.data() + entry.frameOffset + payloadOffset,
+             entry.frameSize - payloadOffset};
+  return true;
+}
+
+bool WriteQueue::filePayload(const FileRegion *&file, uint64_t &offset,
+                             size_t &size) const {
+  auto lane = nextLane();
+  if (lane == laneCount) {
+    return false;
+  }
+  const auto &entry = this->entry(lane, 0);
+  if (!entry.filePayload || entry.offset < entry.headerSize) {
+    return false;
+  }
+  auto payloadOffset = entry.offset - entry.headerSize;
+  file = entry.filePayload.get();
+  offset = file->offset() + entry.frameOffset + payloadOffset;
+  size = entry.frameSize - payloadOffset;
+  return true;
+}
+
+void WriteQueue::consumeZeroCopy(size_t size, TrafficMetrics &metrics,
+                                 uint32_t sequence) {
+  auto &entry = this->entry(nextLane(), 0);
+  entry.isZeroCopy = true;
+  entry.zeroCopySequence = sequence;
+  consume(size, metrics);
+}
+
+void WriteQueue::releaseZeroCopy(uint32_t sequence) {
+  // sequence numbers wrap around, and TCP completes sends in order.
+  while (!m_zeroCopyPayloads.empty() &&
+         static_cast<int32_t>(m_zeroCopyPayloads.front().sequence -
+                              sequence) <= 0) {
+    BufferPool::release(std::move(m_zeroCopyPayloads.front().ownedPayload));
+    m_zeroCopyPayloads.pop_front();
+  }
+}
+
+bool WriteQueue::hasZeroCopyPayloads() const {
+  return !m_zeroCopyPayloads.empty();
+}
+
+void WriteQueue::consume(size_t size, TrafficMetrics &metrics) {
+  m_size -= size;
+  auto now = std::chrono::steady_clock::now();
+  while (size > 0) {
+    auto lane = nextLane();
+    auto &entry = this->entry(lane, 0);
+    auto frameSize = entry.headerSize + entry.frameSize - entry.offset;
+    if (size < frameSize) {
+      entry.offset += size;
+      return;
+    }
+    size -= frameSize;
+    entry.frameOffset += entry.frameSize;
+    if (entry.frameOffset < entry.payloadSize) {
+      startFrame(entry);
+      continue;
+    }
+    metrics.recordSent(now - entry.queuedAt);
+    popEntry(lane);
+  }
+}
+
+bool WriteQueue::isChunked(size_t headerSize, size_t payloadSize) const {
+  return m_chunkSize > 0 && headerSize > 0 && payloadSize > m_chunkSize;
+}
+
+WriteQueue::Entry &WriteQueue::pushEntry(const char *header,
+                                         size_t headerSize,
+                                         size_t payloadSize,
+                                         Priority priority) {
+  auto &lane = m_lanes[static_cast<size_t>(priority)];
+  if (lane.count == lane.entries.size()) {
+    std::vector<std::unique_ptr<Entry>> entries;
+    entries.reserve(std::max<size_t>(2 * lane.entries.size(), 16));
+    for (size_t i = 0; i < lane.entries.size(); i++) {
+      entries.push_back(
+          std::move(lane.entries[(lane.head + i) % lane.entries.size()]));
+    }
+    while (entries.size() < entries.capacity()) {
+      entries.push_back(std::make_unique<Entry>());
+    }
+    lane.entries = std::move(entries);
+    lane.head = 0;
+  }
+  auto &entry =
+      *lane.entries[(lane.head + lane.count++) % lane.entries.size()];
+  std::copy_n(header, headerSize, entry.header.data());
+  entry.headerSize = headerSize;
+  entry.payloadSize = payloadSize;
+  entry.frameOffset = 0;
+  entry.frameSize = payloadSize;
+  entry.offset = 0;
+  entry.queuedAt = std::chrono::steady_clock::now();
+  entry.lane = static_cast<uint8_t>(priority);
+  entry.isChunked = isChunked(headerSize, payloadSize);
+  entry.flags = 0;
+  entry.isZeroCopy = false;
+  if (entry.isChunked) {
+    // flags of the message, such as compression, are kept by every chunk.
+    FrameHeader messageHeader;
+    size_t messageHeaderSize;
+    if (m_framing->decode(header, headerSize, messageHeader,
+                          messageHeaderSize)) {
+      entry.flags = messageHeader.flags;
+    }
+    startFrame(entry);
+  }
+  m_size += frameSize(headerSize, payloadSize);
+  return entry;
+}
+
+void WriteQueue::startFrame(Entry &entry) {
+  entry.frameSize =
+      std::min(m_chunkSize, entry.payloadSize - entry.frameOffset);
+  uint8_t flags = entry.flags | FrameHeader::chunkFlag | entry.lane;
+  if (entry.frameOffset + entry.frameSize == entry.payloadSize) {
+    flags |= FrameHeader::lastChunkFlag;
+  }
+  entry.headerSize =
+      m_framing->encode({entry.frameSize, flags}, entry.header.data());
+  entry.offset = 0;
+}
+
+size_t WriteQueue::nextLane() const {
+  for (size_t lane = 0; lane < laneCount; lane++) {
+    if (m_lanes[lane].count > 0 && entry(lane, 0).offset > 0) {
+      return lane;
+    }
+  }
+  for (size_t lane = 0; lane < laneCount; lane++) {
+    if (m_lanes[lane].count > 0) {
+      return lane;
+    }
+  }
+  return laneCount;
+}
+
+WriteQueue::Entry &WriteQueue::entry(size_t lane, size_t index) const {
+  const auto &entries = m_lanes[lane].entries;
+  return *entries[(m_lanes[lane].head + index) % entries.size()];
+}
+
+void WriteQueue::popEntry(size_t lane) {
+  auto &entry = this->entry(lane, 0);
+  if (entry.isZeroCopy) {
+    m_zeroCopyPayloads.push_back({entry.zeroCopySequence,
+                                  std::move(entry.ownedPayload),
+                                  std::move(entry.sharedPayload)});
+  }
+  BufferPool::release(std::move(entry.ownedPayload));
+  entry.ownedPayload = {};
+  entry.sharedPayload.reset();
+  entry.filePayload.reset();
+  entry.payload = {};
+  auto &ring = m_lanes[lane];
+  ring.head = (ring.head + 1) % ring.entries.size();
+  ring.count--;
+}
+}  // namespace example
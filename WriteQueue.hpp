@@ -0,0 +1,231 @@
+#ifndef EXAMPLE_WRITE_QUEUE_HPP
+#define EXAMPLE_WRITE_QUEUE_HPP
+
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "FileRegion.hpp"
+#include "Framing.hpp"
+#include "Message.hpp"
+#include "Metrics.hpp"
+#include "SubmissionQueue.hpp"
+
+namespace example {
+/**
+ * WriteQueue class holds framed messages pending to be written, and exposes
+ * them as a buffer sequence so that several messages can be written with a
+ * single gather operation without copying their payloads. Entries are kept
+ * in a ring and reused, so that queuing does not allocate in steady state.
+ * Messages are queued in a lane per Priority, and the next frame written is
+ * always taken from the highest priority lane that is not empty. When
+ * configured with a chunk size, payloads larger than it are written as a
+ * sequence of chunk frames, so that messages of higher priority lanes can be
+ * written between two chunks instead of after the whole payload.
+ */
+class WriteQueue {
+ public:
+  /**
+   * BufferSequence class references the buffers of the pending messages.
+   */
+  class BufferSequence {
+   public:
+    BufferSequence(const boost::asio::const_buffer *begin,
+                   const boost::asio::const_buffer *end);
+    const boost::asio::const_buffer *begin() const;
+    const boost::asio::const_buffer *end() const;
+
+   private:
+    const boost::asio::const_buffer *m_begin;
+    const boost::asio::const_buffer *m_end;
+  };
+  /**
+   * number of lanes, one per Priority.
+   */
+  static constexpr size_t laneCount{3};
+  /**
+   * Constructs an empty WriteQueue object that does not split payloads.
+   */
+  WriteQueue();
+  /**
+   * Constructs an empty WriteQueue object.
+   *
+   * @param framing used to encode the headers of chunk frames.
+   * @param chunkSize in bytes of the chunks payloads are split into, or zero
+   * to disable it. Payloads are not split if framing does not carry flags.
+   */
+  WriteQueue(const Framing &framing, size_t chunkSize);
+  /**
+   * returns number of bytes written for a message, including the headers of
+   * its chunk frames. It can be called from any thread.
+   *
+   * @param headerSize of the message header, or zero if the payload is
+   * already framed.
+   * @param payloadSize in bytes.
+   */
+  size_t frameSize(size_t headerSize, size_t payloadSize) const;
+  /**
+   * appends a message, taking ownership of its payload.
+   *
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is queued in.
+   */
+  void push(const char *header, size_t headerSize, std::string &&payload,
+            Priority priority = Priority::Normal);
+  /**
+   * appends a message, sharing ownership of its payload.
+   *
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is queued in.
+   */
+  void push(const char *header, size_t headerSize,
+            std::shared_ptr<const Buffer> payload,
+            Priority priority = Priority::Normal);
+  /**
+   * appends a message whose payload is read from a file.
+   *
+   * @param header of the message.
+   * @param headerSize in bytes.
+   * @param payload of the message.
+   * @param priority of the lane the message is queued in.
+   */
+  void push(const char *header, size_t headerSize,
+            std::shared_ptr<const FileRegion> payload,
+            Priority priority = Priority::Normal);
+  /**
+   * appends a message taken from a SubmissionQueue, moving its payload and
+   * keeping the time it was submitted at.
+   *
+   * @param submission holding the message.
+   */
+  void push(SubmissionQueue::Submission &submission);
+  /**
+   * returns true if no bytes are pending.
+   */
+  bool empty() const;
+  /**
+   * returns number of bytes pending.
+   */
+  size_t size() const;
+  /**
+   * returns the buffers pending to be written, which remain valid until the
+   * next call to consume(). They end before the payload of a file, and
+   * after the first chunk frame.
+   *
+   * @param zeroCopyThreshold payload size from which buffers end before the
+   * payload, so that it is sent with zero copy, or zero to disable it.
+   */
+  BufferSequence buffers(size_t zeroCopyThreshold = 0);
+  /**
+   * gets the rest of the payload of the next frame if it is to be sent
+   * with zero copy, which happens once its header has been written.
+   *
+   * @param zeroCopyThreshold payload size from which payloads are sent with
+   * zero copy, or zero to disable it.
+   * @param payload rest of the payload.
+   * @return false if the next frame is not to be sent with zero copy.
+   */
+  bool zeroCopyPayload(size_t zeroCopyThreshold,
+                       boost::asio::const_buffer &payload) const;
+  /**
+   * gets the rest of the payload of the next frame if it is read from a
+   * file, once its header has been written.
+   *
+   * @param file holding the payload.
+   * @param offset in the file of the rest of the payload.
+   * @param size of the rest of the payload in bytes.
+   * @return false if the next frame is not to be sent from a file.
+   */
+  bool filePayload(const FileRegion *&file, uint64_t &offset,
+                   size_t &size) const;
+  /**
+   * removes bytes written from the beginning of the queue, recording the
+   * latency of every message completely written.
+   *
+   * @param size in bytes written.
+   * @param metrics to record messages sent at.
+   */
+  void consume(size_t size, TrafficMetrics &metrics);
+  /**
+   * removes bytes of a payload written with zero copy from the beginning of
+   * the queue. The payload is kept after being completely written, until
+   * releaseZeroCopy() is called with the sequence number of its last send.
+   *
+   * @param size in bytes written.
+   * @param metrics to record messages sent at.
+   * @param sequence number of the zero copy send, as counted by the kernel.
+   */
+  void consumeZeroCopy(size_t size, TrafficMetrics &metrics,
+                       uint32_t sequence);
+  /**
+   * releases payloads whose zero copy sends have been completed.
+   *
+   * @param sequence number of the last zero copy send completed.
+   */
+  void releaseZeroCopy(uint32_t sequence);
+  /**
+   * returns true if payloads written with zero copy are waiting to be
+   * released.
+   */
+  bool hasZeroCopyPayloads() const;
+
+ private:
+  struct Entry {
+    std::array<char, Framing::maxHeaderSize> header;
+    size_t headerSize;
+    std::string ownedPayload;
+    std::shared_ptr<const Buffer> sharedPayload;
+    std::shared_ptr<const FileRegion> filePayload;
+    std::string_view payload;
+    size_t payloadSize;
+    size_t frameOffset;
+    size_t frameSize;
+    size_t offset;
+    std::chrono::steady_clock::time_point queuedAt;
+    uint8_t lane;
+    uint8_t flags;
+    bool isChunked;
+    bool isZeroCopy;
+    uint32_t zeroCopySequence;
+  };
+
+  struct Lane {
+    std::vector<std::unique_ptr<Entry>> entries;
+    size_t head;
+    size_t count;
+  };
+
+  struct ZeroCopyPayload {
+    uint32_t sequence;
+    std::string ownedPayload;
+    std::shared_ptr<const Buffer> sharedPayload;
+  };
+
+  static constexpr size_t maxBufferCount{64};
+
+  bool isChunked(size_t headerSize, size_t payloadSize) const;
+  Entry &pushEntry(const char *header, size_t headerSize, size_t payloadSize,
+                   Priority priority);
+  void startFrame(Entry &entry);
+  size_t nextLane() const;
+  Entry &entry(size_t lane, size_t index) const;
+  void popEntry(size_t lane);
+
+  const Framing *m_framing;
+  size_t m_chunkSize;
+  std::array<Lane, laneCount> m_lanes;
+  std::array<boost::asio::const_buffer, maxBufferCount> m_buffers;
+  std::deque<ZeroCopyPayload> m_zeroCopyPayloads;
+  size_t m_size;
+};
+}  // namespace example
+
+#endif
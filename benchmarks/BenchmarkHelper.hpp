@@ -0,0 +1,61 @@
+#ifndef EXAMPLE_BENCHMARKS_BENCHMARK_HELPER_HPP
+#define EXAMPLE_BENCHMARKS_BENCHMARK_HELPER_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <example/Metrics.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace example::benchmarks {
+inline void setLatencyCounters(
+    benchmark::State &state,
+    std::vector<std::chrono::nanoseconds> &latencies) {
+  if (latencies.empty()) {
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    auto index = static_cast<size_t>(p * (latencies.size() - 1));
+    return static_cast<double>(latencies[index].count()) / 1000;
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["p99.9_us"] = percentile(0.999);
+}
+
+inline void setOperationCounters(benchmark::State &state,
+                                 const TrafficStats &stats) {
+  if (stats.messagesReceived > 0) {
+    state.counters["reads_per_message"] =
+        static_cast<double>(stats.reads) / stats.messagesReceived;
+  }
+  if (stats.messagesSent > 0) {
+    state.counters["writes_per_message"] =
+        static_cast<double>(stats.writes) / stats.messagesSent;
+  }
+}
+
+inline void addIoBackendContext() {
+  static const bool isAdded = []() {
+#ifdef EXAMPLE_IO_URING
+    benchmark::AddCustomContext("io_backend", "io_uring");
+#else
+    benchmark::AddCustomContext("io_backend", "epoll");
+#endif
+    return true;
+  }();
+  static_cast<void>(isAdded);
+}
+
+template <typename Condition>
+inline void waitUntil(Condition condition) {
+  while (!condition()) {
+    std::this_thread::yield();
+  }
+}
+}  // namespace example::benchmarks
+
+#endif
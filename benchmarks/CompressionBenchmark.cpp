@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <ctime>
+#include <example/Codec.hpp>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <thread>
+
+#include "BenchmarkHelper.hpp"
+
+namespace {
+constexpr uint16_t f_port{1240};
+constexpr size_t f_bytesPerIteration{1 << 20};
+
+using CodecGetter = const example::Codec *(*)();
+
+const example::Codec *uncompressed() { return nullptr; }
+
+std::string generateRecords(size_t size) {
+  std::string records;
+  for (size_t i = 0; records.size() < size; i++) {
+    records += "{\"id\": " + std::to_string(i * 7919 % 100003) +
+               ", \"status\": \"" + (i % 3 ? "active" : "idle") +
+               "\", \"score\": " + std::to_string(i * 31 % 1000) + "}\n";
+  }
+  records.resize(size);
+  return records;
+}
+
+void messageSizeArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("message_size");
+  for (auto size : {256, 4096, 65536}) {
+    benchmark->Arg(size);
+  }
+}
+
+void BM_CodecRoundTrip(benchmark::State &state, CodecGetter getCodec) {
+  const auto *codec = getCodec();
+  if (!codec) {
+    state.SkipWithError("codec not built");
+    return;
+  }
+  const auto message = generateRecords(static_cast<size_t>(state.range(0)));
+  std::string compressed;
+  std::string decompressed;
+  for (auto _ : state) {
+    codec->compress(message, compressed);
+    codec->decompress(compressed, message.size(), decompressed);
+    benchmark::DoNotOptimize(decompressed.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * message.size());
+  state.counters["compression_ratio"] =
+      static_cast<double>(compressed.size()) / message.size();
+}
+
+void BM_CompressedLoopback(benchmark::State &state, CodecGetter getCodec) {
+  const auto *codec = getCodec();
+  if (!codec && getCodec != &uncompressed) {
+    state.SkipWithError("codec not built");
+    return;
+  }
+  example::ConnectionOptions options;
+  options.codec = codec;
+  options.compressionThreshold = 0;
+  boost::asio::io_context context;
+  struct : example::TcpServer::Observer {
+    std::atomic<size_t> messageCount{0};
+    void onReceivedView(example::ConnectionId,
+                        const example::MessageView &) override {
+      messageCount++;
+    };
+  } serverObserver;
+  example::TcpServer server{context, serverObserver,
+                            example::Framing::binary()};
+  server.listen(boost::asio::ip::tcp::v4(), f_port);
+  server.startAcceptingConnections();
+  struct : example::TcpClient::Observer {
+    std::atomic<bool> isConnected{false};
+    void onConnected() override { isConnected = true; };
+  } clientObserver;
+  example::TcpClient client{context, clientObserver,
+                            example::Framing::binary(), options};
+  client.connect({boost::asio::ip::address_v4::loopback(), f_port});
+  std::thread thread{[&context]() { context.run(); }};
+  example::benchmarks::waitUntil(
+      [&clientObserver]() { return clientObserver.isConnected.load(); });
+  const auto message = generateRecords(static_cast<size_t>(state.range(0)));
+  const auto batchSize = std::max<size_t>(1, f_bytesPerIteration /
+                                                 message.size());
+  size_t messageCount{0};
+  auto cpuStart = std::clock();
+  for (auto _ : state) {
+    for (size_t i = 0; i < batchSize; i++) {
+      client.send(message);
+    }
+    messageCount += batchSize;
+    example::benchmarks::waitUntil([&serverObserver, messageCount]() {
+      return serverObserver.messageCount >= messageCount;
+    });
+  }
+  auto cpuTime = static_cast<double>(std::clock() - cpuStart) /
+                 CLOCKS_PER_SEC;
+  state.SetItemsProcessed(messageCount);
+  state.SetBytesProcessed(messageCount * message.size());
+  // process time covers both compression by this thread and decompression
+  // by the io thread.
+  state.counters["cpu_us_per_message"] = cpuTime * 1e6 / messageCount;
+  example::ConnectionStats stats;
+  if (client.stats(stats)) {
+    state.counters["wire_ratio"] =
+        static_cast<double>(stats.bytesSent) / (messageCount * message.size());
+  }
+  server.close();
+  context.stop();
+  thread.join();
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_CodecRoundTrip, zlib, &example::Codec::zlib)
+    ->Apply(messageSizeArguments);
+BENCHMARK_CAPTURE(BM_CodecRoundTrip, lz4, &example::Codec::lz4)
+    ->Apply(messageSizeArguments);
+BENCHMARK_CAPTURE(BM_CompressedLoopback, none, &uncompressed)
+    ->Apply(messageSizeArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CompressedLoopback, zlib, &example::Codec::zlib)
+    ->Apply(messageSizeArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CompressedLoopback, lz4, &example::Codec::lz4)
+    ->Apply(messageSizeArguments)
+    ->UseRealTime();
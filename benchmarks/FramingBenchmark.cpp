@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <thread>
+
+namespace {
+constexpr uint16_t f_port{1235};
+constexpr size_t f_messageSize{64};
+constexpr size_t f_messageBatchSize{1000};
+
+void BM_FramingEncodeDecode(benchmark::State &state,
+                            const example::Framing &framing) {
+  char buffer[example::Framing::maxHeaderSize];
+  size_t messageSize{0};
+  for (auto _ : state) {
+    auto size = framing.encode({messageSize++ & 0xffffff, 0}, buffer);
+    example::FrameHeader header;
+    size_t headerSize;
+    framing.decode(buffer, size, header, headerSize);
+    benchmark::DoNotOptimize(header);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_FramingLoopback(benchmark::State &state,
+                        const example::Framing &framing) {
+  boost::asio::io_context context;
+  struct : example::TcpServer::Observer {
+    std::atomic<size_t> messageCount{0};
+    void onReceivedView(example::ConnectionId,
+                        const example::MessageView &) override {
+      messageCount++;
+    };
+  } serverObserver;
+  example::TcpServer server{context, serverObserver, framing};
+  server.listen(boost::asio::ip::tcp::v4(), f_port);
+  server.startAcceptingConnections();
+  struct : example::TcpClient::Observer {
+    std::atomic<bool> isConnected{false};
+    void onConnected() override { isConnected = true; };
+  } clientObserver;
+  example::TcpClient client{context, clientObserver, framing};
+  client.connect({boost::asio::ip::address_v4::loopback(), f_port});
+  std::thread thread{[&context]() { context.run(); }};
+  while (!clientObserver.isConnected) {
+    std::this_thread::yield();
+  }
+  const std::string message(f_messageSize, 'x');
+  size_t messageCount{0};
+  for (auto _ : state) {
+    for (size_t i = 0; i < f_messageBatchSize; i++) {
+      client.send(message);
+    }
+    messageCount += f_messageBatchSize;
+    while (serverObserver.messageCount < messageCount) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(messageCount);
+  state.SetBytesProcessed(messageCount * f_messageSize);
+  server.close();
+  context.stop();
+  thread.join();
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_FramingEncodeDecode, text, example::Framing::text());
+BENCHMARK_CAPTURE(BM_FramingEncodeDecode, binary, example::Framing::binary());
+BENCHMARK_CAPTURE(BM_FramingLoopback, text, example::Framing::text())
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_FramingLoopback, binary, example::Framing::binary())
+    ->UseRealTime();
@@ -0,0 +1,223 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <thread>
+
+#include "BenchmarkHelper.hpp"
+
+namespace {
+constexpr uint16_t f_port{1236};
+constexpr const char *f_socketPath{"/tmp/example_benchmarks.sock"};
+constexpr int64_t f_maxBytesInFlight{256 << 20};
+
+struct ServerObserver : example::TcpServer::Observer {
+  example::TcpServer *server{nullptr};
+  bool isEchoing{false};
+  std::atomic<size_t> connectionCount{0};
+  std::atomic<size_t> messageCount{0};
+  std::vector<example::ConnectionId> connectionIds;
+  void onConnectionAccepted(example::ConnectionId id) override {
+    connectionIds.push_back(id);
+    connectionCount++;
+  };
+  void onReceivedBatch(example::ConnectionId id,
+                       const example::MessageBatch &messages) override {
+    if (isEchoing) {
+      for (const auto &message : messages) {
+        server->send(id, message.str());
+      }
+    }
+    messageCount += messages.size();
+  };
+};
+
+struct ClientObserver : example::TcpClient::Observer {
+  std::atomic<bool> isConnected{false};
+  std::atomic<size_t> messageCount{0};
+  std::chrono::steady_clock::time_point sendTime;
+  std::vector<std::chrono::nanoseconds> *latencies{nullptr};
+  void onConnected() override { isConnected = true; };
+  void onReceivedBatch(const example::MessageBatch &messages) override {
+    if (latencies) {
+      latencies->push_back(std::chrono::steady_clock::now() - sendTime);
+    }
+    messageCount += messages.size();
+  };
+};
+
+example::ConnectionOptions connectionOptions() {
+  example::ConnectionOptions options;
+  options.bufferRing = true;
+  return options;
+}
+
+class Loopback {
+ public:
+  Loopback(size_t connectionCount, bool isEchoing, bool isLocal)
+      : m_serverContext{},
+        m_clientContext{},
+        m_serverObserver{},
+        m_server{m_serverContext, m_serverObserver,
+                 example::Framing::binary(), connectionOptions()},
+        m_clientObservers(connectionCount),
+        m_clients{} {
+    m_serverObserver.server = &m_server;
+    m_serverObserver.isEchoing = isEchoing;
+    if (isLocal) {
+      m_server.listen(boost::asio::local::stream_protocol::endpoint{
+          f_socketPath});
+    } else {
+      m_server.listen(boost::asio::ip::tcp::v4(), f_port);
+    }
+    m_server.startAcceptingConnections();
+    for (auto &observer : m_clientObservers) {
+      m_clients.push_back(std::make_unique<example::TcpClient>(
+          m_clientContext, observer, example::Framing::binary(),
+          connectionOptions()));
+      if (isLocal) {
+        m_clients.back()->connect(
+            boost::asio::local::stream_protocol::endpoint{f_socketPath});
+      } else {
+        m_clients.back()->connect(
+            {boost::asio::ip::address_v4::loopback(), f_port});
+      }
+    }
+    m_serverThread = std::thread{[this]() { m_serverContext.run(); }};
+    m_clientThread = std::thread{[this]() { m_clientContext.run(); }};
+    example::benchmarks::waitUntil([this, connectionCount]() {
+      return m_serverObserver.connectionCount == connectionCount &&
+             std::all_of(m_clientObservers.begin(), m_clientObservers.end(),
+                         [](const auto &o) { return o.isConnected.load(); });
+    });
+  }
+
+  ~Loopback() {
+    boost::asio::post(m_serverContext, [this]() { m_server.close(); });
+    m_serverContext.stop();
+    m_clientContext.stop();
+    m_serverThread.join();
+    m_clientThread.join();
+  }
+
+  boost::asio::io_context &serverContext() { return m_serverContext; }
+  example::TcpServer &server() { return m_server; }
+  ServerObserver &serverObserver() { return m_serverObserver; }
+  std::vector<std::unique_ptr<example::TcpClient>> &clients() {
+    return m_clients;
+  }
+  std::vector<ClientObserver> &clientObservers() { return m_clientObservers; }
+
+ private:
+  boost::asio::io_context m_serverContext;
+  boost::asio::io_context m_clientContext;
+  ServerObserver m_serverObserver;
+  example::TcpServer m_server;
+  std::vector<ClientObserver> m_clientObservers;
+  std::vector<std::unique_ptr<example::TcpClient>> m_clients;
+  std::thread m_serverThread;
+  std::thread m_clientThread;
+};
+
+void loopbackArguments(benchmark::internal::Benchmark *benchmark) {
+  example::benchmarks::addIoBackendContext();
+  benchmark->ArgNames({"size", "connections", "uds"});
+  for (int64_t uds = 0; uds <= 1; uds++) {
+    for (int64_t size = 16; size <= (4 << 20); size *= 16) {
+      for (int64_t connections = 1; connections <= 1024; connections *= 4) {
+        if (size * connections <= f_maxBytesInFlight) {
+          benchmark->Args({size, connections, uds});
+        }
+      }
+    }
+    benchmark->Args({4 << 20, 1, uds});
+    benchmark->Args({4 << 20, 16, uds});
+  }
+  benchmark->UseRealTime();
+}
+
+void BM_ClientToServer(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  auto connections = static_cast<size_t>(state.range(1));
+  Loopback loopback{connections, false, state.range(2) != 0};
+  auto message = std::make_shared<const example::Buffer>(size, 'x');
+  size_t messageCount{0};
+  for (auto _ : state) {
+    for (auto &client : loopback.clients()) {
+      client->send(message);
+    }
+    messageCount += connections;
+    example::benchmarks::waitUntil([&]() {
+      return loopback.serverObserver().messageCount >= messageCount;
+    });
+  }
+  state.SetItemsProcessed(messageCount);
+  state.SetBytesProcessed(messageCount * size);
+  example::benchmarks::setOperationCounters(state, loopback.server().stats());
+}
+
+void BM_ServerToClient(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  auto connections = static_cast<size_t>(state.range(1));
+  Loopback loopback{connections, false, state.range(2) != 0};
+  auto message = std::make_shared<const example::Buffer>(size, 'x');
+  auto receivedCount = [&loopback]() {
+    size_t count{0};
+    for (const auto &observer : loopback.clientObservers()) {
+      count += observer.messageCount;
+    }
+    return count;
+  };
+  size_t sentCount{0};
+  for (auto _ : state) {
+    std::atomic<bool> isSent{false};
+    boost::asio::post(loopback.serverContext(), [&]() {
+      for (auto id : loopback.serverObserver().connectionIds) {
+        loopback.server().send(id, message);
+      }
+      isSent = true;
+    });
+    sentCount += connections;
+    example::benchmarks::waitUntil(
+        [&]() { return isSent && receivedCount() >= sentCount; });
+  }
+  state.SetItemsProcessed(sentCount);
+  state.SetBytesProcessed(sentCount * size);
+  example::benchmarks::setOperationCounters(state, loopback.server().stats());
+}
+
+void BM_EchoRoundTrip(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  auto connections = static_cast<size_t>(state.range(1));
+  Loopback loopback{connections, true, state.range(2) != 0};
+  std::vector<std::chrono::nanoseconds> latencies;
+  auto message = std::make_shared<const example::Buffer>(size, 'x');
+  for (auto &observer : loopback.clientObservers()) {
+    observer.latencies = &latencies;
+  }
+  size_t messageCount{0};
+  for (auto _ : state) {
+    latencies.reserve(latencies.size() + connections);
+    auto &observers = loopback.clientObservers();
+    for (size_t i = 0; i < connections; i++) {
+      observers[i].sendTime = std::chrono::steady_clock::now();
+      loopback.clients()[i]->send(message);
+    }
+    messageCount++;
+    example::benchmarks::waitUntil([&]() {
+      return std::all_of(observers.begin(), observers.end(),
+                         [messageCount](const auto &o) {
+                           return o.messageCount >= messageCount;
+                         });
+    });
+  }
+  state.SetItemsProcessed(messageCount * connections);
+  state.SetBytesProcessed(2 * messageCount * connections * size);
+  example::benchmarks::setLatencyCounters(state, latencies);
+}
+}  // namespace
+
+BENCHMARK(BM_ClientToServer)->Apply(loopbackArguments);
+BENCHMARK(BM_ServerToClient)->Apply(loopbackArguments);
+BENCHMARK(BM_EchoRoundTrip)->Apply(loopbackArguments);
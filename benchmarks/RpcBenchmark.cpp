@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <example/RpcClient.hpp>
+#include <example/RpcServer.hpp>
+#include <thread>
+
+#include "BenchmarkHelper.hpp"
+
+namespace {
+constexpr uint16_t f_port{1237};
+constexpr size_t f_callsPerIteration{1024};
+constexpr std::chrono::seconds f_timeout{10};
+
+struct ServerObserver : example::RpcServer::Observer {
+  example::RpcServer *server{nullptr};
+  void onRequest(example::ConnectionId connectionId, uint64_t requestId,
+                 const example::MessageView &request) override {
+    server->respond(connectionId, requestId, request.view());
+  };
+};
+
+struct ClientObserver : example::RpcClient::Observer {
+  std::atomic<bool> isConnected{false};
+  void onConnected() override { isConnected = true; };
+};
+
+class Pipeline {
+ public:
+  Pipeline(example::RpcClient &client, size_t size, size_t depth)
+      : m_client{client},
+        m_request(size, 'x'),
+        m_depth{depth},
+        m_latencies{},
+        m_issuedCount{0},
+        m_callCount{0},
+        m_completedCount{0} {}
+
+  void run(size_t callCount) {
+    m_issuedCount = 0;
+    m_completedCount = 0;
+    m_callCount = callCount;
+    for (size_t i = 0; i < m_depth; i++) {
+      issue();
+    }
+    example::benchmarks::waitUntil(
+        [this]() { return m_completedCount.load() == m_callCount; });
+  }
+
+  std::vector<std::chrono::nanoseconds> &latencies() { return m_latencies; }
+
+ private:
+  void issue() {
+    if (m_issuedCount++ >= m_callCount) {
+      return;
+    }
+    auto sendTime = std::chrono::steady_clock::now();
+    m_client.call(m_request, f_timeout,
+                  [this, sendTime](auto status, const auto &) {
+                    if (status == example::RpcStatus::Ok) {
+                      m_latencies.push_back(std::chrono::steady_clock::now() -
+                                            sendTime);
+                    }
+                    issue();
+                    m_completedCount++;
+                  });
+  }
+
+  example::RpcClient &m_client;
+  const std::string m_request;
+  const size_t m_depth;
+  std::vector<std::chrono::nanoseconds> m_latencies;
+  std::atomic<size_t> m_issuedCount;
+  size_t m_callCount;
+  std::atomic<size_t> m_completedCount;
+};
+
+void BM_RpcCall(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  auto depth = static_cast<size_t>(state.range(1));
+  boost::asio::io_context serverContext;
+  boost::asio::io_context clientContext;
+  ServerObserver serverObserver;
+  example::RpcServer server{serverContext, serverObserver,
+                            example::Framing::binary()};
+  serverObserver.server = &server;
+  server.listen(boost::asio::ip::tcp::v4(), f_port);
+  server.startAcceptingConnections();
+  ClientObserver clientObserver;
+  example::RpcClient client{clientContext, clientObserver,
+                            example::Framing::binary()};
+  client.connect({boost::asio::ip::address_v4::loopback(), f_port});
+  std::thread serverThread{[&serverContext]() { serverContext.run(); }};
+  std::thread clientThread{[&clientContext]() { clientContext.run(); }};
+  example::benchmarks::waitUntil(
+      [&clientObserver]() { return clientObserver.isConnected.load(); });
+  Pipeline pipeline{client, size, depth};
+  size_t callCount{0};
+  for (auto _ : state) {
+    pipeline.run(f_callsPerIteration);
+    callCount += f_callsPerIteration;
+  }
+  state.SetItemsProcessed(callCount);
+  state.SetBytesProcessed(2 * callCount * size);
+  example::benchmarks::setLatencyCounters(state, pipeline.latencies());
+  boost::asio::post(serverContext, [&server]() { server.close(); });
+  serverContext.stop();
+  clientContext.stop();
+  serverThread.join();
+  clientThread.join();
+}
+}  // namespace
+
+BENCHMARK(BM_RpcCall)
+    ->ArgNames({"size", "depth"})
+    ->ArgsProduct({{16, 1024, 65536}, {1, 4, 16, 64, 256}})
+    ->UseRealTime();
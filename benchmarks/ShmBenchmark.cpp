@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <example/ShmClient.hpp>
+#include <example/ShmServer.hpp>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <thread>
+
+#include "BenchmarkHelper.hpp"
+
+namespace {
+constexpr uint16_t f_port{1238};
+constexpr const char *f_socketPath{"/tmp/example_shm_benchmarks.sock"};
+constexpr int64_t f_streamMessageCount{1024};
+
+bool listen(example::TcpServer &server) {
+  return server.listen(boost::asio::ip::tcp::v4(), f_port);
+}
+
+bool listen(example::ShmServer &server) {
+  return server.listen(
+      boost::asio::local::stream_protocol::endpoint{f_socketPath});
+}
+
+void connect(example::TcpClient &client) {
+  client.connect({boost::asio::ip::address_v4::loopback(), f_port});
+}
+
+void connect(example::ShmClient &client) {
+  client.connect(boost::asio::local::stream_protocol::endpoint{f_socketPath});
+}
+
+template <typename Server>
+struct ServerObserver : example::TcpServer::Observer {
+  Server *server{nullptr};
+  bool isEchoing{false};
+  std::atomic<bool> isConnected{false};
+  std::atomic<size_t> messageCount{0};
+  void onConnectionAccepted(example::ConnectionId) override {
+    isConnected = true;
+  };
+  void onReceivedBatch(example::ConnectionId id,
+                       const example::MessageBatch &messages) override {
+    if (isEchoing) {
+      for (const auto &message : messages) {
+        server->send(id, message.str());
+      }
+    }
+    messageCount += messages.size();
+  };
+};
+
+struct ClientObserver : example::TcpClient::Observer {
+  std::atomic<bool> isConnected{false};
+  std::atomic<size_t> messageCount{0};
+  void onConnected() override { isConnected = true; };
+  void onReceivedBatch(const example::MessageBatch &messages) override {
+    messageCount += messages.size();
+  };
+};
+
+template <typename Server, typename Client>
+class Pair {
+ public:
+  Pair(bool isEchoing, std::chrono::nanoseconds busyPollDuration)
+      : m_serverContext{},
+        m_clientContext{},
+        m_options{},
+        m_serverObserver{},
+        m_server{m_serverContext, m_serverObserver, example::Framing::binary(),
+                 options(busyPollDuration)},
+        m_clientObserver{},
+        m_client{m_clientContext, m_clientObserver,
+                 example::Framing::binary(), options(busyPollDuration)} {
+    m_serverObserver.server = &m_server;
+    m_serverObserver.isEchoing = isEchoing;
+    listen(m_server);
+    m_server.startAcceptingConnections();
+    connect(m_client);
+    m_serverThread = std::thread{[this]() { m_serverContext.run(); }};
+    m_clientThread = std::thread{[this]() { m_clientContext.run(); }};
+    example::benchmarks::waitUntil([this]() {
+      return m_serverObserver.isConnected && m_clientObserver.isConnected;
+    });
+  }
+
+  ~Pair() {
+    boost::asio::post(m_serverContext, [this]() { m_server.close(); });
+    m_serverContext.stop();
+    m_clientContext.stop();
+    m_serverThread.join();
+    m_clientThread.join();
+  }
+
+  ServerObserver<Server> &serverObserver() { return m_serverObserver; }
+  Client &client() { return m_client; }
+  ClientObserver &clientObserver() { return m_clientObserver; }
+
+ private:
+  const example::ConnectionOptions &options(
+      std::chrono::nanoseconds busyPollDuration) {
+    m_options.busyPollDuration = busyPollDuration;
+    return m_options;
+  }
+
+  boost::asio::io_context m_serverContext;
+  boost::asio::io_context m_clientContext;
+  example::ConnectionOptions m_options;
+  ServerObserver<Server> m_serverObserver;
+  Server m_server;
+  ClientObserver m_clientObserver;
+  Client m_client;
+  std::thread m_serverThread;
+  std::thread m_clientThread;
+};
+
+void tcpArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"size", "busy_poll_us"});
+  for (int64_t size = 16; size <= 65536; size *= 64) {
+    benchmark->Args({size, 0});
+  }
+  benchmark->UseRealTime();
+}
+
+void shmArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"size", "busy_poll_us"});
+  for (int64_t busyPoll : {0, 100}) {
+    for (int64_t size = 16; size <= 65536; size *= 64) {
+      benchmark->Args({size, busyPoll});
+    }
+  }
+  benchmark->UseRealTime();
+}
+
+template <typename Server, typename Client>
+void BM_TransportRoundTrip(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  Pair<Server, Client> pair{true, std::chrono::microseconds(state.range(1))};
+  auto message = std::make_shared<const example::Buffer>(size, 'x');
+  std::vector<std::chrono::nanoseconds> latencies;
+  size_t messageCount{0};
+  for (auto _ : state) {
+    auto sendTime = std::chrono::steady_clock::now();
+    pair.client().send(message);
+    messageCount++;
+    example::benchmarks::waitUntil([&]() {
+      return pair.clientObserver().messageCount >= messageCount;
+    });
+    latencies.push_back(std::chrono::steady_clock::now() - sendTime);
+  }
+  state.SetItemsProcessed(messageCount);
+  state.SetBytesProcessed(2 * messageCount * size);
+  example::benchmarks::setLatencyCounters(state, latencies);
+}
+
+template <typename Server, typename Client>
+void BM_TransportStream(benchmark::State &state) {
+  auto size = static_cast<size_t>(state.range(0));
+  Pair<Server, Client> pair{false, std::chrono::microseconds(state.range(1))};
+  auto message = std::make_shared<const example::Buffer>(size, 'x');
+  size_t messageCount{0};
+  for (auto _ : state) {
+    for (int64_t i = 0; i < f_streamMessageCount; i++) {
+      pair.client().send(message);
+    }
+    messageCount += f_streamMessageCount;
+    example::benchmarks::waitUntil([&]() {
+      return pair.serverObserver().messageCount >= messageCount;
+    });
+  }
+  state.SetItemsProcessed(messageCount);
+  state.SetBytesProcessed(messageCount * size);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_TransportRoundTrip, example::TcpServer,
+                   example::TcpClient)
+    ->Apply(tcpArguments);
+BENCHMARK_TEMPLATE(BM_TransportRoundTrip, example::ShmServer,
+                   example::ShmClient)
+    ->Apply(shmArguments);
+BENCHMARK_TEMPLATE(BM_TransportStream, example::TcpServer, example::TcpClient)
+    ->Apply(tcpArguments);
+BENCHMARK_TEMPLATE(BM_TransportStream, example::ShmServer, example::ShmClient)
+    ->Apply(shmArguments);
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <thread>
+
+#include "BenchmarkHelper.hpp"
+
+namespace {
+constexpr uint16_t f_port{1239};
+constexpr size_t f_messageSize{64};
+constexpr size_t f_messagesPerProducer{10000};
+
+struct ServerObserver : example::TcpServer::Observer {
+  std::atomic<example::ConnectionId> connectionId{0};
+  std::atomic<size_t> messageCount{0};
+  void onConnectionAccepted(example::ConnectionId id) override {
+    connectionId = id;
+  };
+  void onReceivedBatch(example::ConnectionId,
+                       const example::MessageBatch &messages) override {
+    messageCount += messages.size();
+  };
+};
+
+struct ClientObserver : example::TcpClient::Observer {
+  std::atomic<bool> isConnected{false};
+  std::atomic<size_t> messageCount{0};
+  void onConnected() override { isConnected = true; };
+  void onReceivedBatch(const example::MessageBatch &messages) override {
+    messageCount += messages.size();
+  };
+};
+
+class Connection {
+ public:
+  Connection()
+      : m_serverContext{},
+        m_clientContext{},
+        m_serverObserver{},
+        m_server{m_serverContext, m_serverObserver,
+                 example::Framing::binary()},
+        m_clientObserver{},
+        m_client{m_clientContext, m_clientObserver,
+                 example::Framing::binary()} {
+    m_server.listen(boost::asio::ip::tcp::v4(), f_port);
+    m_server.startAcceptingConnections();
+    m_client.connect({boost::asio::ip::address_v4::loopback(), f_port});
+    m_serverThread = std::thread{[this]() { m_serverContext.run(); }};
+    m_clientThread = std::thread{[this]() { m_clientContext.run(); }};
+    example::benchmarks::waitUntil([this]() {
+      return m_serverObserver.connectionId != 0 &&
+             m_clientObserver.isConnected;
+    });
+  }
+
+  ~Connection() {
+    boost::asio::post(m_serverContext, [this]() { m_server.close(); });
+    m_serverContext.stop();
+    m_clientContext.stop();
+    m_serverThread.join();
+    m_clientThread.join();
+  }
+
+  boost::asio::io_context &serverContext() { return m_serverContext; }
+  example::TcpServer &server() { return m_server; }
+  ServerObserver &serverObserver() { return m_serverObserver; }
+  example::TcpClient &client() { return m_client; }
+  ClientObserver &clientObserver() { return m_clientObserver; }
+
+ private:
+  boost::asio::io_context m_serverContext;
+  boost::asio::io_context m_clientContext;
+  ServerObserver m_serverObserver;
+  example::TcpServer m_server;
+  ClientObserver m_clientObserver;
+  example::TcpClient m_client;
+  std::thread m_serverThread;
+  std::thread m_clientThread;
+};
+
+void producerArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"producers"});
+  benchmark->RangeMultiplier(2)->Range(1, 8);
+  benchmark->UseRealTime();
+}
+
+template <typename Send, typename Received>
+void runProducers(benchmark::State &state, Send send, Received received) {
+  auto producers = static_cast<size_t>(state.range(0));
+  size_t messageCount{0};
+  for (auto _ : state) {
+    messageCount += producers * f_messagesPerProducer;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < producers; i++) {
+      threads.emplace_back([&send]() {
+        for (size_t j = 0; j < f_messagesPerProducer; j++) {
+          send();
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    example::benchmarks::waitUntil(
+        [&]() { return received() >= messageCount; });
+  }
+  state.SetItemsProcessed(messageCount);
+}
+
+void BM_ConnectionSendFromThreads(benchmark::State &state) {
+  Connection connection;
+  auto message = std::make_shared<const example::Buffer>(f_messageSize, 'x');
+  runProducers(
+      state, [&]() { connection.client().send(message); },
+      [&]() { return connection.serverObserver().messageCount.load(); });
+}
+
+void BM_ServerSubmitFromThreads(benchmark::State &state) {
+  Connection connection;
+  auto &server = connection.server();
+  auto connectionId = connection.serverObserver().connectionId.load();
+  auto message = std::make_shared<const example::Buffer>(f_messageSize, 'x');
+  runProducers(
+      state, [&]() { server.submit(connectionId, message); },
+      [&]() { return connection.clientObserver().messageCount.load(); });
+}
+
+void BM_ServerPostFromThreads(benchmark::State &state) {
+  Connection connection;
+  auto &server = connection.server();
+  auto connectionId = connection.serverObserver().connectionId.load();
+  auto message = std::make_shared<const example::Buffer>(f_messageSize, 'x');
+  runProducers(
+      state,
+      [&]() {
+        boost::asio::post(connection.serverContext(),
+                          [&server, connectionId, message]() {
+                            server.send(connectionId, message);
+                          });
+      },
+      [&]() { return connection.clientObserver().messageCount.load(); });
+}
+}  // namespace
+
+BENCHMARK(BM_ConnectionSendFromThreads)->Apply(producerArguments);
+BENCHMARK(BM_ServerSubmitFromThreads)->Apply(producerArguments);
+BENCHMARK(BM_ServerPostFromThreads)->Apply(producerArguments);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <example/TimingWheel.hpp>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr auto f_timeout{std::chrono::seconds(30)};
+
+void timerArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"timers"});
+  benchmark->RangeMultiplier(10)->Range(1000, 100000);
+}
+
+void BM_TimingWheelRearm(benchmark::State &state) {
+  auto count = static_cast<size_t>(state.range(0));
+  boost::asio::io_context context;
+  auto &wheel = example::TimingWheel::of(context);
+  std::vector<std::unique_ptr<example::TimingWheel::Timer>> timers;
+  for (size_t i = 0; i < count; i++) {
+    timers.push_back(std::make_unique<example::TimingWheel::Timer>([]() {}));
+  }
+  for (auto _ : state) {
+    for (auto &timer : timers) {
+      wheel.arm(*timer, f_timeout);
+    }
+    context.poll();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_SteadyTimerRearm(benchmark::State &state) {
+  auto count = static_cast<size_t>(state.range(0));
+  boost::asio::io_context context;
+  std::vector<std::unique_ptr<boost::asio::steady_timer>> timers;
+  for (size_t i = 0; i < count; i++) {
+    timers.push_back(std::make_unique<boost::asio::steady_timer>(context));
+  }
+  for (auto _ : state) {
+    for (auto &timer : timers) {
+      timer->expires_after(f_timeout);
+      timer->async_wait([](const auto &) {});
+    }
+    context.poll();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+}  // namespace
+
+BENCHMARK(BM_TimingWheelRearm)->Apply(timerArguments);
+BENCHMARK(BM_SteadyTimerRearm)->Apply(timerArguments);
@@ -0,0 +1,43 @@
+#include "EchoServer.hpp"
+
+#include <boost/asio.hpp>
+#include <example/Allocation.hpp>
+
+namespace example::loadgen {
+EchoServer::EchoServer(size_t threadCount, const ConnectionOptions &options)
+    : m_server{*this, std::max<size_t>(1, threadCount), Framing::binary(),
+               options} {}
+
+bool EchoServer::run(uint16_t port, std::chrono::nanoseconds duration) {
+  if (!m_server.listen(boost::asio::ip::tcp::v4(), port)) {
+    return false;
+  }
+  m_server.startAcceptingConnections();
+  boost::asio::io_context context;
+  boost::asio::signal_set signals{context, SIGINT, SIGTERM};
+  signals.async_wait([&context](const auto &, int) { context.stop(); });
+  boost::asio::steady_timer timer{context};
+  if (duration.count() > 0) {
+    timer.expires_after(duration);
+    timer.async_wait([&context](const auto &error) {
+      if (!error) {
+        context.stop();
+      }
+    });
+  }
+  context.run();
+  m_server.close();
+  return true;
+}
+
+ServerStats EchoServer::stats() const { return m_server.stats(); }
+
+void EchoServer::onReceivedBatch(ConnectionId connectionId,
+                                 const MessageBatch &messages) {
+  for (const auto &message : messages) {
+    auto echo = BufferPool::acquire();
+    echo.assign(message.view());
+    m_server.send(connectionId, std::move(echo));
+  }
+}
+}  // namespace example::loadgen
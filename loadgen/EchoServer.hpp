@@ -0,0 +1,45 @@
+#ifndef EXAMPLE_LOADGEN_ECHO_SERVER_HPP
+#define EXAMPLE_LOADGEN_ECHO_SERVER_HPP
+
+#include <chrono>
+#include <example/ShardedTcpServer.hpp>
+
+namespace example::loadgen {
+/**
+ * EchoServer class sends every message it receives back to its sender, over
+ * a ShardedTcpServer with a worker thread per shard. It is the peer of a
+ * LoadGenerator.
+ */
+class EchoServer : public TcpServer::Observer {
+ public:
+  /**
+   * Constructs an EchoServer object.
+   *
+   * @param threadCount number of shards and worker threads.
+   * @param options configuring every connection.
+   */
+  EchoServer(size_t threadCount, const ConnectionOptions &options);
+  /**
+   * listens at specified port and echoes messages until interrupted by
+   * SIGINT or SIGTERM, or until specified duration has elapsed.
+   *
+   * @param port to listen to.
+   * @param duration after which the server stops, or zero to run until
+   * interrupted.
+   * @return false if the server cannot listen.
+   */
+  bool run(uint16_t port, std::chrono::nanoseconds duration);
+  /**
+   * returns the counters of every shard.
+   */
+  ServerStats stats() const;
+
+ private:
+  void onReceivedBatch(ConnectionId connectionId,
+                       const MessageBatch &messages) override;
+
+  ShardedTcpServer m_server;
+};
+}  // namespace example::loadgen
+
+#endif
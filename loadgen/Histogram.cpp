@@ -0,0 +1,107 @@
+#include "Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace {
+constexpr unsigned f_subBucketBits{11};
+constexpr uint64_t f_subBucketCount{uint64_t{1} << f_subBucketBits};
+constexpr uint64_t f_subBucketHalfCount{f_subBucketCount / 2};
+constexpr size_t f_countsSize{f_subBucketCount +
+                              (64 - f_subBucketBits) * f_subBucketHalfCount};
+}  // namespace
+
+namespace example::loadgen {
+Histogram::Histogram()
+    : m_counts(f_countsSize, 0),
+      m_count{0},
+      m_min{std::numeric_limits<uint64_t>::max()},
+      m_max{0},
+      m_sum{0} {}
+
+void Histogram::record(uint64_t value, uint64_t count) {
+  m_counts[indexOf(value)] += count;
+  m_count += count;
+  m_min = std::min(m_min, value);
+  m_max = std::max(m_max, value);
+  m_sum += static_cast<double>(value) * count;
+}
+
+Histogram &Histogram::operator+=(const Histogram &other) {
+  for (size_t i = 0; i < m_counts.size(); i++) {
+    m_counts[i] += other.m_counts[i];
+  }
+  m_count += other.m_count;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+  m_sum += other.m_sum;
+  return *this;
+}
+
+uint64_t Histogram::count() const { return m_count; }
+
+uint64_t Histogram::min() const { return m_count > 0 ? m_min : 0; }
+
+uint64_t Histogram::max() const { return m_max; }
+
+double Histogram::mean() const { return m_count > 0 ? m_sum / m_count : 0; }
+
+uint64_t Histogram::percentile(double percentile) const {
+  if (m_count == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(
+      std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * m_count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t accumulated{0};
+  for (size_t i = 0; i < m_counts.size(); i++) {
+    accumulated += m_counts[i];
+    if (accumulated >= rank) {
+      return std::min(highestEquivalentValue(i), m_max);
+    }
+  }
+  return m_max;
+}
+
+void Histogram::print(std::ostream &stream, double scale) const {
+  stream << std::setw(14) << "Value" << std::setw(14) << "Percentile"
+         << std::setw(14) << "TotalCount" << '\n';
+  for (auto percentile : {0.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 99.999,
+                          100.0}) {
+    auto value = this->percentile(percentile);
+    uint64_t totalCount{0};
+    for (size_t i = 0; i <= indexOf(value) && i < m_counts.size(); i++) {
+      totalCount += m_counts[i];
+    }
+    stream << std::fixed << std::setprecision(3) << std::setw(14)
+           << value / scale << std::setw(14) << std::setprecision(5)
+           << percentile / 100 << std::setw(14) << totalCount << '\n';
+  }
+  stream << std::setprecision(3) << "#[Mean = " << mean() / scale
+         << ", Max = " << max() / scale << ", Count = " << count() << "]\n";
+}
+
+size_t Histogram::indexOf(uint64_t value) {
+  if (value < f_subBucketCount) {
+    return value;
+  }
+  // values of the power of two range [2^m, 2^(m+1)) are counted in half a
+  // bucket of sub-buckets, dropping their bits below the top ones.
+  auto magnitude = 63 - static_cast<unsigned>(__builtin_clzll(value));
+  auto shift = magnitude - f_subBucketBits + 1;
+  return (shift - 1) * f_subBucketHalfCount + f_subBucketHalfCount +
+         (value >> shift);
+}
+
+uint64_t Histogram::highestEquivalentValue(size_t index) {
+  if (index < f_subBucketCount) {
+    return index;
+  }
+  auto offset = index - f_subBucketCount;
+  auto shift = 1 + offset / f_subBucketHalfCount;
+  auto subBucket = f_subBucketHalfCount + offset % f_subBucketHalfCount;
+  return ((subBucket + 1) << shift) - 1;
+}
+}  // namespace example::loadgen
@@ -0,0 +1,79 @@
+#ifndef EXAMPLE_LOADGEN_HISTOGRAM_HPP
+#define EXAMPLE_LOADGEN_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace example::loadgen {
+/**
+ * Histogram class records values in log-linear buckets, in the manner of
+ * HdrHistogram: every power of two range is split into the same number of
+ * linear sub-buckets, so that any value is counted with a relative error
+ * below 0.1% whatever its magnitude. It is not thread safe; each thread
+ * records into its own Histogram and they are added at the end.
+ */
+class Histogram {
+ public:
+  /**
+   * Constructs an empty Histogram object.
+   */
+  Histogram();
+  /**
+   * records a value.
+   *
+   * @param value to record.
+   * @param count of occurrences of the value.
+   */
+  void record(uint64_t value, uint64_t count = 1);
+  /**
+   * adds values recorded by another histogram.
+   *
+   * @param other histogram to add.
+   */
+  Histogram &operator+=(const Histogram &other);
+  /**
+   * returns number of values recorded.
+   */
+  uint64_t count() const;
+  /**
+   * returns smallest value recorded, or zero if none.
+   */
+  uint64_t min() const;
+  /**
+   * returns largest value recorded, or zero if none.
+   */
+  uint64_t max() const;
+  /**
+   * returns mean of values recorded, or zero if none.
+   */
+  double mean() const;
+  /**
+   * returns highest value equivalent to the value at specified percentile,
+   * or zero if no value has been recorded.
+   *
+   * @param percentile between 0 and 100.
+   */
+  uint64_t percentile(double percentile) const;
+  /**
+   * writes the percentile distribution, with values divided by a scale.
+   *
+   * @param stream to write to.
+   * @param scale dividing values, such as 1000 to print nanoseconds as
+   * microseconds.
+   */
+  void print(std::ostream &stream, double scale) const;
+
+ private:
+  static size_t indexOf(uint64_t value);
+  static uint64_t highestEquivalentValue(size_t index);
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_min;
+  uint64_t m_max;
+  double m_sum;
+};
+}  // namespace example::loadgen
+
+#endif
@@ -0,0 +1,314 @@
+#include "LoadGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <example/Allocation.hpp>
+#include <example/TcpClient.hpp>
+#include <random>
+#include <string_view>
+#include <thread>
+
+namespace {
+constexpr size_t f_timestampSize{sizeof(int64_t)};
+constexpr auto f_connectTimeout{std::chrono::seconds(10)};
+constexpr auto f_drainTimeout{std::chrono::seconds(5)};
+constexpr auto f_pollInterval{std::chrono::milliseconds(10)};
+
+template <typename Condition>
+void waitUntil(Condition condition, std::chrono::nanoseconds timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(f_pollInterval);
+  }
+}
+}  // namespace
+
+namespace example::loadgen {
+class LoadGenerator::Worker {
+ public:
+  Worker(const LoadOptions &options, size_t connectionCount, double rate,
+         uint32_t seed)
+      : m_options{options},
+        m_ioContext{},
+        m_workGuard{m_ioContext.get_executor()},
+        m_timer{m_ioContext},
+        m_connections{},
+        m_payload(std::max(options.messageSize, options.maxMessageSize),
+                  'x'),
+        m_random{seed},
+        m_latency{},
+        m_intervalNs{rate > 0 ? 1e9 / rate : 0},
+        m_startTime{},
+        m_endTime{},
+        m_scheduledCount{0},
+        m_nextConnection{0},
+        m_isStopping{false},
+        m_connectedCount{0},
+        m_failureCount{0},
+        m_sentCount{0},
+        m_receivedCount{0},
+        m_rejectedCount{0},
+        m_thread{} {
+    for (size_t i = 0; i < connectionCount; i++) {
+      m_connections.push_back(std::make_unique<Connection>(*this));
+    }
+    m_thread = std::thread{[this]() { m_ioContext.run(); }};
+  }
+
+  ~Worker() {
+    m_ioContext.stop();
+    join();
+  }
+
+  void connect() {
+    boost::asio::post(m_ioContext, [this]() {
+      for (auto &connection : m_connections) {
+        connection->client.connect(m_options.endpoint);
+      }
+    });
+  }
+
+  void start(std::chrono::steady_clock::time_point startTime,
+             std::chrono::steady_clock::time_point endTime) {
+    boost::asio::post(m_ioContext, [this, startTime, endTime]() {
+      m_startTime = startTime;
+      m_endTime = endTime;
+      if (m_intervalNs > 0) {
+        tick();
+      }
+    });
+  }
+
+  void disconnect() {
+    boost::asio::post(m_ioContext, [this]() {
+      m_isStopping = true;
+      m_timer.cancel();
+      for (auto &connection : m_connections) {
+        connection->client.disconnect();
+      }
+      m_workGuard.reset();
+    });
+  }
+
+  void join() {
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  size_t connectedCount() const { return m_connectedCount; }
+  size_t failureCount() const { return m_failureCount; }
+  uint64_t sentCount() const { return m_sentCount; }
+  uint64_t receivedCount() const { return m_receivedCount; }
+  uint64_t rejectedCount() const { return m_rejectedCount; }
+  /**
+   * returns latencies recorded, once the worker thread has been joined.
+   */
+  const Histogram &latency() const { return m_latency; }
+
+ private:
+  struct Connection : TcpClient::Observer {
+    explicit Connection(Worker &worker)
+        : worker{worker},
+          client{worker.m_ioContext, *this, Framing::binary(),
+                 worker.m_options.connectionOptions},
+          isConnected{false} {}
+
+    void onConnected() override {
+      isConnected = true;
+      worker.m_connectedCount++;
+    }
+
+    void onReceivedView(const MessageView &message) override {
+      worker.received(message.view());
+    }
+
+    void onDisconnected() override {
+      if (isConnected) {
+        isConnected = false;
+        worker.m_connectedCount--;
+      }
+      if (!worker.m_isStopping) {
+        worker.m_failureCount++;
+      }
+    }
+
+    Worker &worker;
+    TcpClient client;
+    bool isConnected;
+  };
+
+  void tick() {
+    auto now = std::chrono::steady_clock::now();
+    auto scheduledTime = nextScheduledTime();
+    // every message due is sent at once, even after a stall, so that the
+    // rate does not depend on how fast messages are echoed.
+    while (scheduledTime <= now && scheduledTime < m_endTime) {
+      send(scheduledTime);
+      m_scheduledCount++;
+      scheduledTime = nextScheduledTime();
+    }
+    if (scheduledTime >= m_endTime || m_isStopping) {
+      return;
+    }
+    m_timer.expires_at(scheduledTime);
+    m_timer.async_wait([this](const auto &error) {
+      if (!error) {
+        tick();
+      }
+    });
+  }
+
+  std::chrono::steady_clock::time_point nextScheduledTime() const {
+    return m_startTime +
+           std::chrono::nanoseconds(static_cast<int64_t>(
+               static_cast<double>(m_scheduledCount) * m_intervalNs));
+  }
+
+  void send(std::chrono::steady_clock::time_point scheduledTime) {
+    Connection *connection{nullptr};
+    for (size_t i = 0; i < m_connections.size() && !connection; i++) {
+      auto &candidate = m_connections[m_nextConnection++];
+      m_nextConnection %= m_connections.size();
+      if (candidate->isConnected) {
+        connection = candidate.get();
+      }
+    }
+    if (!connection) {
+      m_rejectedCount++;
+      return;
+    }
+    auto message = BufferPool::acquire();
+    message.assign(m_payload, 0, drawSize());
+    int64_t timestamp = scheduledTime.time_since_epoch().count();
+    std::memcpy(message.data(), &timestamp, f_timestampSize);
+    if (connection->client.send(std::move(message))) {
+      m_sentCount++;
+    } else {
+      m_rejectedCount++;
+    }
+  }
+
+  void received(std::string_view message) {
+    if (message.size() < f_timestampSize) {
+      return;
+    }
+    int64_t timestamp;
+    std::memcpy(&timestamp, message.data(), f_timestampSize);
+    auto scheduledTime = std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{timestamp}};
+    auto latency = std::chrono::steady_clock::now() - scheduledTime;
+    m_latency.record(static_cast<uint64_t>(std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+            .count(),
+        0)));
+    m_receivedCount++;
+  }
+
+  size_t drawSize() {
+    size_t size{m_options.messageSize};
+    switch (m_options.sizeDistribution) {
+      case SizeDistribution::Fixed:
+        break;
+      case SizeDistribution::Uniform:
+        size = std::uniform_int_distribution<size_t>{
+            f_timestampSize, m_options.maxMessageSize}(m_random);
+        break;
+      case SizeDistribution::Exponential:
+        size = static_cast<size_t>(std::exponential_distribution<double>{
+            1.0 / static_cast<double>(m_options.messageSize)}(m_random));
+        size = std::min(size, m_options.maxMessageSize);
+        break;
+    }
+    return std::clamp(size, f_timestampSize, m_payload.size());
+  }
+
+  const LoadOptions &m_options;
+  boost::asio::io_context m_ioContext;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+      m_workGuard;
+  boost::asio::steady_timer m_timer;
+  std::vector<std::unique_ptr<Connection>> m_connections;
+  std::string m_payload;
+  std::mt19937 m_random;
+  Histogram m_latency;
+  double m_intervalNs;
+  std::chrono::steady_clock::time_point m_startTime;
+  std::chrono::steady_clock::time_point m_endTime;
+  uint64_t m_scheduledCount;
+  size_t m_nextConnection;
+  bool m_isStopping;
+  std::atomic<size_t> m_connectedCount;
+  std::atomic<size_t> m_failureCount;
+  std::atomic<uint64_t> m_sentCount;
+  std::atomic<uint64_t> m_receivedCount;
+  std::atomic<uint64_t> m_rejectedCount;
+  std::thread m_thread;
+};
+
+LoadGenerator::LoadGenerator(const LoadOptions &options)
+    : m_options{options}, m_workers{} {
+  auto threadCount = std::max<size_t>(1, m_options.threadCount);
+  std::random_device seeds;
+  for (size_t i = 0; i < threadCount; i++) {
+    // connections are split evenly, and so is the rate, so that every
+    // connection sends at the same rate.
+    auto connectionCount = m_options.connectionCount / threadCount +
+                           (i < m_options.connectionCount % threadCount);
+    auto rate = m_options.connectionCount > 0
+                    ? m_options.rate * connectionCount /
+                          m_options.connectionCount
+                    : 0;
+    m_workers.push_back(std::make_unique<Worker>(m_options, connectionCount,
+                                                 rate, seeds()));
+  }
+}
+
+LoadGenerator::~LoadGenerator() = default;
+
+LoadReport LoadGenerator::run() {
+  for (auto &worker : m_workers) {
+    worker->connect();
+  }
+  auto sum = [this](auto count) {
+    uint64_t total{0};
+    for (const auto &worker : m_workers) {
+      total += ((*worker).*count)();
+    }
+    return total;
+  };
+  waitUntil(
+      [this, &sum]() {
+        return sum(&Worker::connectedCount) + sum(&Worker::failureCount) >=
+               m_options.connectionCount;
+      },
+      f_connectTimeout);
+  LoadReport report;
+  report.connections = sum(&Worker::connectedCount);
+  auto startTime = std::chrono::steady_clock::now();
+  auto endTime = startTime + m_options.duration;
+  for (auto &worker : m_workers) {
+    worker->start(startTime, endTime);
+  }
+  std::this_thread::sleep_until(endTime);
+  waitUntil(
+      [&sum]() {
+        return sum(&Worker::receivedCount) >= sum(&Worker::sentCount);
+      },
+      f_drainTimeout);
+  for (auto &worker : m_workers) {
+    worker->disconnect();
+  }
+  for (auto &worker : m_workers) {
+    worker->join();
+    report.latency += worker->latency();
+  }
+  report.connectionFailures = sum(&Worker::failureCount);
+  report.messagesSent = sum(&Worker::sentCount);
+  report.messagesReceived = sum(&Worker::receivedCount);
+  report.messagesRejected = sum(&Worker::rejectedCount);
+  report.duration = m_options.duration;
+  return report;
+}
+}  // namespace example::loadgen
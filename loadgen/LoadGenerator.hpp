@@ -0,0 +1,139 @@
+#ifndef EXAMPLE_LOADGEN_LOAD_GENERATOR_HPP
+#define EXAMPLE_LOADGEN_LOAD_GENERATOR_HPP
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <example/ConnectionOptions.hpp>
+#include <memory>
+#include <vector>
+
+#include "Histogram.hpp"
+
+namespace example::loadgen {
+/**
+ * SizeDistribution enum selects how the sizes of sent messages are drawn.
+ */
+enum class SizeDistribution {
+  /** every message has the message size. */
+  Fixed,
+  /** sizes are uniformly distributed up to the maximum message size. */
+  Uniform,
+  /** sizes are exponentially distributed around the message size as mean,
+     up to the maximum message size. */
+  Exponential
+};
+/**
+ * LoadOptions struct configures a LoadGenerator.
+ */
+struct LoadOptions {
+  /**
+   * endpoint of the echo server.
+   */
+  boost::asio::ip::tcp::endpoint endpoint{};
+  /**
+   * number of threads, each one running the io_context of its share of the
+   * connections.
+   */
+  size_t threadCount{1};
+  /**
+   * number of connections, evenly split among threads.
+   */
+  size_t connectionCount{1};
+  /**
+   * number of messages sent per second over all connections.
+   */
+  double rate{1000};
+  /**
+   * time during which messages are sent.
+   */
+  std::chrono::nanoseconds duration{std::chrono::seconds(10)};
+  /**
+   * distribution of the sizes of sent messages.
+   */
+  SizeDistribution sizeDistribution{SizeDistribution::Fixed};
+  /**
+   * size in bytes of every message, or mean of the exponential
+   * distribution.
+   */
+  size_t messageSize{64};
+  /**
+   * largest size in bytes of the uniform and exponential distributions.
+   */
+  size_t maxMessageSize{4096};
+  /**
+   * options configuring every connection.
+   */
+  ConnectionOptions connectionOptions{};
+};
+/**
+ * LoadReport struct holds the results of a run of a LoadGenerator.
+ */
+struct LoadReport {
+  /**
+   * round trip latencies in nanoseconds, measured from the time each
+   * message was scheduled to be sent.
+   */
+  Histogram latency;
+  /**
+   * number of connections established.
+   */
+  size_t connections{0};
+  /**
+   * number of connections that failed or were closed by the server.
+   */
+  size_t connectionFailures{0};
+  /**
+   * number of messages sent.
+   */
+  uint64_t messagesSent{0};
+  /**
+   * number of echoed messages received.
+   */
+  uint64_t messagesReceived{0};
+  /**
+   * number of messages not sent because no connection was established or
+   * its send queue was full.
+   */
+  uint64_t messagesRejected{0};
+  /**
+   * time during which messages were sent.
+   */
+  std::chrono::nanoseconds duration{0};
+};
+/**
+ * LoadGenerator class sends messages to an echo server at a fixed rate over
+ * many connections, and measures the round trip latency of the echoes. The
+ * load is open loop: messages are sent on schedule, whether or not previous
+ * ones have been echoed, and each latency is measured from the time its
+ * message was scheduled instead of the time it was actually sent. Delays of
+ * the client, such as a stalled thread or a full send queue, are therefore
+ * counted against every message they hold back, which corrects the
+ * coordinated omission of closed loop measurements.
+ */
+class LoadGenerator {
+ public:
+  /**
+   * Constructs a LoadGenerator object.
+   *
+   * @param options configuring the load.
+   */
+  explicit LoadGenerator(const LoadOptions &options);
+  ~LoadGenerator();
+  /**
+   * connects, sends messages for the configured duration, waits for the
+   * last echoes and disconnects.
+   *
+   * @return results of the run.
+   */
+  LoadReport run();
+
+ private:
+  class Worker;
+
+  const LoadOptions m_options;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+};
+}  // namespace example::loadgen
+
+#endif
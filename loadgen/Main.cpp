@@ -0,0 +1,181 @@
+#include <charconv>
+#include <cstring>
+#include <example/Logging.hpp>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "EchoServer.hpp"
+#include "LoadGenerator.hpp"
+
+namespace {
+constexpr uint16_t f_defaultPort{1241};
+constexpr const char *f_usage{
+    "usage: example_loadgen client|server [options]\n"
+    "  --host ADDRESS            echo server address, default 127.0.0.1\n"
+    "  --port PORT               default 1241\n"
+    "  --threads N               io threads, default 1\n"
+    "  --connections N           client connections, default 1\n"
+    "  --rate N                  messages per second over all connections,\n"
+    "                            default 1000\n"
+    "  --duration SECONDS        time sending, default 10 for the client;\n"
+    "                            the server runs until interrupted if 0,\n"
+    "                            its default\n"
+    "  --size-distribution fixed|uniform|exponential\n"
+    "                            default fixed\n"
+    "  --message-size BYTES      size of every message, or mean of the\n"
+    "                            exponential distribution, default 64\n"
+    "  --max-message-size BYTES  largest size of the uniform and\n"
+    "                            exponential distributions, default 4096\n"
+    "  --chunk-size BYTES        writeChunkSize of every connection\n"
+    "  --codec none|zlib|lz4     codec compressing sent messages\n"
+    "  --log-level debug|info|warning|error|none\n"
+    "                            default none, connection failures are\n"
+    "                            counted in the report\n"};
+
+template <typename Number>
+bool parse(std::string_view text, Number &number) {
+  auto end = text.data() + text.size();
+  auto result = std::from_chars(text.data(), end, number);
+  return result.ec == std::errc{} && result.ptr == end;
+}
+
+bool parse(std::string_view text,
+           example::loadgen::SizeDistribution &distribution) {
+  using example::loadgen::SizeDistribution;
+  if (text == "fixed") {
+    distribution = SizeDistribution::Fixed;
+  } else if (text == "uniform") {
+    distribution = SizeDistribution::Uniform;
+  } else if (text == "exponential") {
+    distribution = SizeDistribution::Exponential;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parse(std::string_view text, const example::Codec *&codec) {
+  if (text == "none") {
+    codec = nullptr;
+    return true;
+  }
+  codec = text == "zlib"  ? example::Codec::zlib()
+          : text == "lz4" ? example::Codec::lz4()
+                          : nullptr;
+  return codec != nullptr;
+}
+
+bool parse(std::string_view text, example::LogLevel &level) {
+  using example::LogLevel;
+  constexpr std::pair<std::string_view, LogLevel> levels[]{
+      {"debug", LogLevel::Debug},
+      {"info", LogLevel::Info},
+      {"warning", LogLevel::Warning},
+      {"error", LogLevel::Error},
+      {"none", LogLevel::None}};
+  for (const auto &[name, value] : levels) {
+    if (text == name) {
+      level = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+int usageError(std::string_view message) {
+  std::cerr << message << '\n' << f_usage;
+  return 2;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2 || (std::strcmp(argv[1], "client") != 0 &&
+                   std::strcmp(argv[1], "server") != 0)) {
+    return usageError("missing mode");
+  }
+  const std::string_view mode{argv[1]};
+  example::loadgen::LoadOptions options;
+  std::string host{"127.0.0.1"};
+  uint16_t port{f_defaultPort};
+  double durationSeconds{mode == "client" ? 10.0 : 0.0};
+  // thousands of connections would otherwise log their every event.
+  auto logLevel{example::LogLevel::None};
+  for (int i = 2; i < argc; i += 2) {
+    const std::string_view name{argv[i]};
+    if (i + 1 == argc) {
+      return usageError("missing value of " + std::string{name});
+    }
+    const std::string_view value{argv[i + 1]};
+    bool isValid{false};
+    if (name == "--host") {
+      host = value;
+      isValid = true;
+    } else if (name == "--port") {
+      isValid = parse(value, port);
+    } else if (name == "--threads") {
+      isValid = parse(value, options.threadCount);
+    } else if (name == "--connections") {
+      isValid = parse(value, options.connectionCount);
+    } else if (name == "--rate") {
+      isValid = parse(value, options.rate) && options.rate >= 0;
+    } else if (name == "--duration") {
+      isValid = parse(value, durationSeconds) && durationSeconds >= 0;
+    } else if (name == "--size-distribution") {
+      isValid = parse(value, options.sizeDistribution);
+    } else if (name == "--message-size") {
+      isValid = parse(value, options.messageSize) && options.messageSize > 0;
+    } else if (name == "--max-message-size") {
+      isValid = parse(value, options.maxMessageSize);
+    } else if (name == "--chunk-size") {
+      isValid = parse(value, options.connectionOptions.writeChunkSize);
+    } else if (name == "--codec") {
+      isValid = parse(value, options.connectionOptions.codec);
+    } else if (name == "--log-level") {
+      isValid = parse(value, logLevel);
+    }
+    if (!isValid) {
+      return usageError("invalid option " + std::string{name} + " " +
+                        std::string{value});
+    }
+  }
+  options.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(durationSeconds));
+  example::Logger::setLevel(logLevel);
+
+  if (mode == "server") {
+    example::loadgen::EchoServer server{options.threadCount,
+                                        options.connectionOptions};
+    if (!server.run(port, options.duration)) {
+      std::cerr << "cannot listen to port " << port << '\n';
+      return 1;
+    }
+    auto stats = server.stats();
+    std::cout << "connections accepted: " << stats.connectionsAccepted
+              << "\nmessages echoed: " << stats.messagesSent << '\n';
+    return 0;
+  }
+
+  boost::system::error_code error;
+  auto address = boost::asio::ip::make_address(host, error);
+  if (error) {
+    return usageError("invalid host " + host);
+  }
+  options.endpoint = {address, port};
+  example::loadgen::LoadGenerator generator{options};
+  auto report = generator.run();
+  auto seconds = std::chrono::duration<double>(report.duration).count();
+  std::cout << "connections: " << report.connections << " established, "
+            << report.connectionFailures << " failed\n"
+            << "messages: " << report.messagesSent << " sent, "
+            << report.messagesReceived << " received, "
+            << report.messagesRejected << " rejected\n"
+            << "rate: " << options.rate << "/s target, "
+            << (seconds > 0 ? report.messagesSent / seconds : 0)
+            << "/s achieved\n"
+            << "latency in microseconds, from the scheduled send time:\n";
+  report.latency.print(std::cout, 1000);
+  return report.connectionFailures > 0 || report.messagesRejected > 0 ? 1
+                                                                      : 0;
+}
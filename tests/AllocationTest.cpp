@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <example/Allocation.hpp>
+#include <example/TcpClient.hpp>
+#include <example/TcpServer.hpp>
+#include <new>
+#include <random>
+
+#include "TestHelper.hpp"
+
+namespace {
+std::atomic<size_t> f_heapAllocations{0};
+}  // namespace
+
+void *operator new(size_t size) {
+  f_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto pointer = std::malloc(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+
+namespace example::tests {
+TEST(AllocationTest, SteadyStateMessagesDoNotAllocate) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    size_t messageCount{0};
+    void onReceivedBatch(ConnectionId, const MessageBatch &messages) override {
+      messageCount += messages.size();
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  const auto message{generateRandomString(messageSize)};
+  auto exchangeMessages = [&]() {
+    serverObserver.messageCount = 0;
+    for (size_t i = 0; i < messageCount; i++) {
+      client.send(message);
+      context.poll();
+    }
+    while (serverObserver.messageCount < messageCount) {
+      context.run_one();
+    }
+  };
+  exchangeMessages();
+  auto stats = allocationStats();
+  auto heapAllocations = f_heapAllocations.load();
+  exchangeMessages();
+  EXPECT_EQ(allocationStats().bufferAllocations, stats.bufferAllocations);
+  EXPECT_EQ(allocationStats().handlerAllocations, stats.handlerAllocations);
+  EXPECT_EQ(allocationStats().slabAllocations, stats.slabAllocations);
+  EXPECT_EQ(f_heapAllocations.load(), heapAllocations);
+}
+}  // namespace example::tests
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <example/AwaitableClient.hpp>
+#include <example/AwaitableServer.hpp>
+#include <example/TcpClient.hpp>
+#include <random>
+
+#include "TestHelper.hpp"
+
+namespace example::tests {
+TEST(AwaitableTest, ServerEchoesClientMessages) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  AwaitableServer server{context};
+  EXPECT_EQ(server.listen(protocol, port), true);
+  boost::asio::co_spawn(
+      context,
+      [&server]() -> boost::asio::awaitable<void> {
+        auto connection = co_await server.accept();
+        try {
+          while (true) {
+            co_await connection.send(co_await connection.receiveBatch());
+          }
+        } catch (const boost::system::system_error &) {
+        }
+      },
+      boost::asio::detached);
+  const auto message{generateRandomString(messageSize)};
+  size_t receivedCount{0};
+  AwaitableClient client{context};
+  boost::asio::co_spawn(
+      context,
+      [&]() -> boost::asio::awaitable<void> {
+        auto connection = co_await client.connect({protocol, port});
+        for (size_t i = 0; i < messageCount; i++) {
+          co_await connection.send(message);
+        }
+        while (receivedCount < messageCount) {
+          EXPECT_EQ((co_await connection.receive()).view(), message);
+          receivedCount++;
+        }
+        connection.close();
+      },
+      boost::asio::detached);
+  context.run_for(std::chrono::seconds(5));
+  EXPECT_EQ(receivedCount, messageCount);
+}
+
+TEST(AwaitableTest, ServerReassemblesChunkedMessages) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.writeChunkSize = 16 << 10;
+  boost::asio::io_context context;
+  AwaitableServer server{context, Framing::binary()};
+  EXPECT_EQ(server.listen(protocol, port), true);
+  const std::vector<std::string> messages{generateRandomString(100 << 10),
+                                          "small",
+                                          generateRandomString(50 << 10)};
+  std::vector<std::string> receivedMessages;
+  boost::asio::co_spawn(
+      context,
+      [&]() -> boost::asio::awaitable<void> {
+        auto connection = co_await server.accept();
+        while (receivedMessages.size() < messages.size()) {
+          for (const auto &message : co_await connection.receiveBatch()) {
+            receivedMessages.emplace_back(message.view());
+          }
+        }
+      },
+      boost::asio::detached);
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver, Framing::binary(), options};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  for (const auto &message : messages) {
+    EXPECT_TRUE(client.send(message));
+  }
+  context.run_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(receivedMessages, messages);
+}
+
+TEST(AwaitableTest, ServerDecompressesMessages) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  if (!Codec::zlib()) {
+    GTEST_SKIP() << "zlib codec not built";
+  }
+  ConnectionOptions options;
+  options.codec = Codec::zlib();
+  options.writeChunkSize = 16 << 10;
+  boost::asio::io_context context;
+  AwaitableServer server{context, Framing::binary()};
+  EXPECT_EQ(server.listen(protocol, port), true);
+  std::string text;
+  for (size_t i = 0; text.size() < (1 << 20); i++) {
+    text += "{\"id\": " + std::to_string(i) + ", \"name\": \"example\"}";
+  }
+  const std::vector<std::string> messages{"small", text.substr(0, 2000),
+                                          text};
+  std::vector<std::string> receivedMessages;
+  boost::asio::co_spawn(
+      context,
+      [&]() -> boost::asio::awaitable<void> {
+        auto connection = co_await server.accept();
+        while (receivedMessages.size() < messages.size()) {
+          for (const auto &message : co_await connection.receiveBatch()) {
+            receivedMessages.emplace_back(message.view());
+          }
+        }
+      },
+      boost::asio::detached);
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver, Framing::binary(), options};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  for (const auto &message : messages) {
+    EXPECT_TRUE(client.send(message));
+  }
+  context.run_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(receivedMessages, messages);
+}
+}  // namespace example::tests
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <example/Codec.hpp>
+#include <example/Framing.hpp>
+
+namespace example::tests {
+TEST(FramingTest, BinaryEncodesAndDecodes) {
+  char buffer[Framing::maxHeaderSize];
+  const auto &framing{Framing::binary()};
+  auto size = framing.encode({123456, 7}, buffer);
+  FrameHeader header;
+  size_t headerSize;
+  EXPECT_EQ(framing.decode(buffer, size, header, headerSize), true);
+  EXPECT_EQ(headerSize, size);
+  EXPECT_EQ(header.size, 123456);
+  EXPECT_EQ(header.flags, 7);
+}
+
+TEST(FramingTest, TextEncodesAndDecodes) {
+  char buffer[Framing::maxHeaderSize];
+  const auto &framing{Framing::text()};
+  auto size = framing.encode({123456, 0}, buffer);
+  EXPECT_EQ(std::string(buffer, size), "123456;");
+  FrameHeader header;
+  size_t headerSize;
+  EXPECT_EQ(framing.decode(buffer, size, header, headerSize), true);
+  EXPECT_EQ(headerSize, size);
+  EXPECT_EQ(header.size, 123456);
+}
+
+TEST(FramingTest, IncompleteHeaderIsNotDecoded) {
+  char buffer[Framing::maxHeaderSize];
+  for (const auto *framing : {&Framing::text(), &Framing::binary()}) {
+    auto size = framing->encode({1000, 0}, buffer);
+    FrameHeader header;
+    size_t headerSize;
+    EXPECT_EQ(framing->decode(buffer, size - 1, header, headerSize), true);
+    EXPECT_EQ(headerSize, 0);
+  }
+}
+
+TEST(FramingTest, InvalidTextHeaderFails) {
+  FrameHeader header;
+  size_t headerSize;
+  const std::string invalidSize{"12a;"};
+  EXPECT_EQ(Framing::text().decode(invalidSize.data(), invalidSize.size(),
+                                   header, headerSize),
+            false);
+  const std::string missingSeparator(Framing::maxHeaderSize, '1');
+  EXPECT_EQ(Framing::text().decode(missingSeparator.data(),
+                                   missingSeparator.size(), header,
+                                   headerSize),
+            false);
+}
+
+TEST(FramingTest, CodecsCompressAndDecompress) {
+  std::string message;
+  for (size_t i = 0; message.size() < 10000; i++) {
+    message += "{\"id\": " + std::to_string(i) + ", \"name\": \"example\"}";
+  }
+  for (const auto *codec : {Codec::zlib(), Codec::lz4()}) {
+    if (!codec) {
+      continue;
+    }
+    std::string compressed;
+    ASSERT_EQ(codec->compress(message, compressed), true);
+    EXPECT_LT(compressed.size(), message.size());
+    EXPECT_EQ(Codec::of(compressed), codec);
+    std::string decompressed;
+    EXPECT_EQ(codec->decompress(compressed, message.size(), decompressed),
+              true);
+    EXPECT_EQ(decompressed, message);
+    EXPECT_EQ(codec->decompress(compressed, message.size() - 1, decompressed),
+              false);
+    compressed.resize(compressed.size() / 2);
+    EXPECT_EQ(codec->decompress(compressed, message.size(), decompressed),
+              false);
+    const std::string incompressible{"abc"};
+    EXPECT_EQ(codec->compress(incompressible, compressed), false);
+  }
+}
+
+TEST(FramingTest, CodecsRejectImplausibleSizes) {
+  const std::string zeros(1 << 20, '\0');
+  for (const auto *codec : {Codec::zlib(), Codec::lz4()}) {
+    if (!codec) {
+      continue;
+    }
+    std::string compressed;
+    ASSERT_EQ(codec->compress(zeros, compressed), true);
+    std::string decompressed;
+    EXPECT_EQ(codec->decompress(compressed, zeros.size(), decompressed), true);
+    EXPECT_EQ(decompressed, zeros);
+    // a header claiming 4 GiB for a few bytes is rejected before the buffer
+    // is resized.
+    std::string forged{compressed.substr(0, 16)};
+    forged.replace(1, 4, "\xff\xff\xff\xff");
+    std::string message;
+    EXPECT_EQ(
+        codec->decompress(forged, std::numeric_limits<size_t>::max(), message),
+        false);
+    EXPECT_EQ(message.capacity(), std::string{}.capacity());
+  }
+}
+}  // namespace example::tests
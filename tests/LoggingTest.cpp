@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <example/Logging.hpp>
+#include <string>
+#include <vector>
+
+namespace example::tests {
+namespace {
+struct TestSink : LogSink {
+  std::vector<std::pair<LogLevel, std::string>> messages;
+  void write(LogLevel level, std::string_view message) override {
+    messages.emplace_back(level, message);
+  }
+  void flush() override {}
+};
+}  // namespace
+
+TEST(LoggingTest, LoggerWritesMessagesToSink) {
+  TestSink sink;
+  Logger::flush();
+  Logger::setSink(&sink);
+  EXAMPLE_LOG_INFO("value ", 42, ' ', std::string{"text"});
+  EXAMPLE_LOG_ERROR("error");
+  Logger::flush();
+  Logger::setSink(nullptr);
+  ASSERT_EQ(sink.messages.size(), 2);
+  EXPECT_EQ(sink.messages[0].first, LogLevel::Info);
+  EXPECT_EQ(sink.messages[0].second, "value 42 text");
+  EXPECT_EQ(sink.messages[1].first, LogLevel::Error);
+  EXPECT_EQ(sink.messages[1].second, "error");
+}
+
+TEST(LoggingTest, LoggerFiltersLevels) {
+  TestSink sink;
+  Logger::flush();
+  Logger::setSink(&sink);
+  auto isEvaluated{false};
+  auto evaluate = [&isEvaluated]() {
+    isEvaluated = true;
+    return "debug";
+  };
+  EXAMPLE_LOG_DEBUG(evaluate());
+  Logger::setLevel(LogLevel::Error);
+  EXAMPLE_LOG_WARNING("warning");
+  Logger::setLevel(LogLevel::Debug);
+  EXAMPLE_LOG_DEBUG("debug");
+  Logger::setLevel(LogLevel::Info);
+  Logger::flush();
+  Logger::setSink(nullptr);
+  EXPECT_EQ(isEvaluated, false);
+  ASSERT_EQ(sink.messages.size(), 1);
+  EXPECT_EQ(sink.messages[0].second, "debug");
+}
+}  // namespace example::tests
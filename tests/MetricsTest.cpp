@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <example/Metrics.hpp>
+#include <sstream>
+
+namespace example::tests {
+TEST(MetricsTest, HistogramComputesPercentiles) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 99; i++) {
+    histogram.record(std::chrono::nanoseconds(1000));
+  }
+  histogram.record(std::chrono::nanoseconds(1000000));
+  auto snapshot = histogram.snapshot();
+  EXPECT_EQ(snapshot.count, 100);
+  EXPECT_EQ(snapshot.percentile(50), std::chrono::nanoseconds(1024));
+  EXPECT_EQ(snapshot.percentile(99.9), std::chrono::nanoseconds(1048576));
+  EXPECT_EQ(snapshot.mean(), std::chrono::nanoseconds(10990));
+}
+
+TEST(MetricsTest, ConnectionCountersAreAddedToParent) {
+  TrafficMetrics parent;
+  TrafficMetrics first{&parent};
+  TrafficMetrics second{&parent};
+  first.recordReceived(100, 2);
+  second.recordReceived(50, 1);
+  first.recordWritten(10, 20);
+  second.recordWritten(20, 20);
+  first.recordSent(std::chrono::microseconds(1));
+  auto stats = parent.stats();
+  EXPECT_EQ(stats.bytesReceived, 150);
+  EXPECT_EQ(stats.messagesReceived, 3);
+  EXPECT_EQ(stats.reads, 2);
+  EXPECT_EQ(stats.bytesSent, 30);
+  EXPECT_EQ(stats.writes, 2);
+  EXPECT_EQ(stats.partialWrites, 1);
+  EXPECT_EQ(stats.messagesSent, 1);
+  EXPECT_EQ(stats.sendLatency.count, 1);
+  EXPECT_EQ(first.stats().bytesReceived, 100);
+}
+
+TEST(MetricsTest, TextExporterWritesPrometheusFormat) {
+  ServerStats stats;
+  stats.connectionsAccepted = 3;
+  stats.sendLatency.buckets[10] = 2;
+  stats.sendLatency.count = 2;
+  std::ostringstream stream;
+  TextMetricsExporter exporter{stream, "test"};
+  exporter.exportStats(stats);
+  auto text = stream.str();
+  EXPECT_NE(text.find("# TYPE test_connections_accepted_total counter\n"
+                      "test_connections_accepted_total 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_send_latency_seconds_bucket{le=\"+Inf\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_send_latency_seconds_count 2\n"),
+            std::string::npos);
+}
+}  // namespace example::tests
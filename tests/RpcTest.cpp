@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <example/RpcClient.hpp>
+#include <example/RpcServer.hpp>
+#include <thread>
+
+namespace example::tests {
+TEST(RpcTest, ClientMatchesResponsesReceivedOutOfOrder) {
+  constexpr uint16_t port{1234};
+  constexpr size_t requestCount{100};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  const auto timeout{std::chrono::seconds(1)};
+  boost::asio::io_context context;
+  struct : RpcServer::Observer {
+    RpcServer *server{nullptr};
+    std::vector<std::tuple<ConnectionId, uint64_t, std::string>> requests;
+    void onRequest(ConnectionId connectionId, uint64_t requestId,
+                   const MessageView &request) override {
+      requests.emplace_back(connectionId, requestId, request.str());
+      if (requests.size() < requestCount) {
+        return;
+      }
+      for (auto it = requests.rbegin(); it != requests.rend(); it++) {
+        server->respond(std::get<0>(*it), std::get<1>(*it),
+                        "response to " + std::get<2>(*it));
+      }
+    };
+  } serverObserver;
+  RpcServer server{context, serverObserver};
+  serverObserver.server = &server;
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  RpcClient::Observer clientObserver;
+  RpcClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  std::vector<std::future<std::string>> responses;
+  for (size_t i = 0; i < requestCount; i++) {
+    responses.push_back(client.call(std::to_string(i), timeout));
+  }
+  for (size_t i = 0; i < requestCount; i++) {
+    EXPECT_EQ(responses[i].get(), "response to " + std::to_string(i));
+  }
+  EXPECT_EQ(client.pendingCount(), 0);
+  context.stop();
+  thread.join();
+}
+
+TEST(RpcTest, CallTimesOut) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  RpcServer::Observer serverObserver;
+  RpcServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  RpcClient::Observer clientObserver;
+  RpcClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto response = client.call("request", std::chrono::milliseconds(50));
+  EXPECT_EQ(response.wait_for(std::chrono::milliseconds(500)),
+            std::future_status::ready);
+  try {
+    response.get();
+    FAIL();
+  } catch (const RpcError &e) {
+    EXPECT_EQ(e.status(), RpcStatus::Timeout);
+  }
+  EXPECT_EQ(client.pendingCount(), 0);
+  context.stop();
+  thread.join();
+}
+
+TEST(RpcTest, CallTimesOutAfterFailedCall) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  RpcServer::Observer serverObserver;
+  RpcServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  RpcClient::Observer clientObserver;
+  RpcClient client{context, clientObserver};
+  auto failedResponse = client.call("request", std::chrono::milliseconds(50));
+  try {
+    failedResponse.get();
+    FAIL();
+  } catch (const RpcError &e) {
+    EXPECT_EQ(e.status(), RpcStatus::SendFailed);
+  }
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto response = client.call("request", std::chrono::milliseconds(100));
+  // the deadline of the failed call must not keep this one from arming the
+  // timer.
+  auto status = response.wait_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(status, std::future_status::ready);
+  if (status == std::future_status::ready) {
+    try {
+      response.get();
+      FAIL();
+    } catch (const RpcError &e) {
+      EXPECT_EQ(e.status(), RpcStatus::Timeout);
+    }
+  }
+  context.stop();
+  thread.join();
+}
+
+TEST(RpcTest, ServerRespondsFromAnotherThread) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : RpcServer::Observer {
+    std::atomic<ConnectionId> connectionId{0};
+    std::atomic<uint64_t> requestId{0};
+    void onRequest(ConnectionId connectionId, uint64_t requestId,
+                   const MessageView &) override {
+      this->requestId = requestId;
+      this->connectionId = connectionId;
+    };
+  } serverObserver;
+  RpcServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  RpcClient::Observer clientObserver;
+  RpcClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto response = client.call("request", std::chrono::seconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_NE(serverObserver.connectionId, 0);
+  EXPECT_EQ(server.respond(serverObserver.connectionId,
+                           serverObserver.requestId, "response"),
+            true);
+  EXPECT_EQ(response.get(), "response");
+  context.stop();
+  thread.join();
+}
+}  // namespace example::tests
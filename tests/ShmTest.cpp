@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <example/ShmClient.hpp>
+#include <example/ShmRing.hpp>
+#include <example/ShmServer.hpp>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+#include "TestHelper.hpp"
+
+namespace {
+const boost::asio::local::stream_protocol::endpoint f_endpoint{
+    (std::filesystem::temp_directory_path() / "example_shm_tests.sock")
+        .string()};
+}  // namespace
+
+namespace example::tests {
+TEST(ShmTest, RingWrapsAround) {
+  ShmRing::Control control;
+  std::array<char, 8> data;
+  ShmRing ring{control, data.data(), data.size()};
+  char buffer[8];
+  EXPECT_EQ(ring.write("abcde", 5), 5);
+  EXPECT_EQ(ring.read(buffer, 3), 3);
+  EXPECT_EQ(ring.write("fghijkl", 7), 6);
+  EXPECT_EQ(ring.writableSize(), 0);
+  EXPECT_EQ(ring.read(buffer, sizeof(buffer)), 8);
+  EXPECT_EQ(std::string(buffer, 8), "defghijk");
+  EXPECT_EQ(ring.readableSize(), 0);
+}
+
+TEST(ShmTest, ConnectRejectsEmptyRing) {
+  // mirrors the layout of the segment header written by the server.
+  struct SegmentHeader {
+    std::array<ShmRing::Control, 2> rings;
+    uint64_t ringSize;
+  };
+  boost::asio::io_context context;
+  ShmConnection::Socket server{context};
+  ShmConnection::Socket client{context};
+  boost::asio::local::connect_pair(server, client);
+  std::array<int, 3> descriptors{::memfd_create("example", MFD_CLOEXEC),
+                                 ::eventfd(0, EFD_CLOEXEC),
+                                 ::eventfd(0, EFD_CLOEXEC)};
+  ASSERT_EQ(::ftruncate(descriptors[0], sizeof(SegmentHeader)), 0);
+  char byte{0};
+  iovec data{&byte, sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(descriptors))]{};
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  auto *controlMessage = CMSG_FIRSTHDR(&message);
+  controlMessage->cmsg_level = SOL_SOCKET;
+  controlMessage->cmsg_type = SCM_RIGHTS;
+  controlMessage->cmsg_len = CMSG_LEN(sizeof(descriptors));
+  std::memcpy(CMSG_DATA(controlMessage), descriptors.data(),
+              sizeof(descriptors));
+  ASSERT_EQ(::sendmsg(server.native_handle(), &message, 0), 1);
+  for (auto descriptor : descriptors) {
+    ::close(descriptor);
+  }
+  ShmConnection::Observer observer;
+  EXPECT_EQ(ShmConnection::connect(std::move(client), observer,
+                                   Framing::binary(), {}),
+            nullptr);
+}
+
+TEST(ShmTest, ConnectionRejectsSendsOnceClosed) {
+  boost::asio::io_context context;
+  ShmConnection::Socket serverSocket{context};
+  ShmConnection::Socket clientSocket{context};
+  boost::asio::local::connect_pair(serverSocket, clientSocket);
+  ShmConnection::Observer observer;
+  auto server = ShmConnection::accept(std::move(serverSocket), observer,
+                                      Framing::binary(), {});
+  ASSERT_NE(server, nullptr);
+  auto client = ShmConnection::connect(std::move(clientSocket), observer,
+                                       Framing::binary(), {});
+  ASSERT_NE(client, nullptr);
+  EXPECT_EQ(client->send(std::string{"message"}), true);
+  client->close();
+  EXPECT_EQ(client->send(std::string{"message"}), false);
+}
+
+TEST(ShmTest, ClientAndServerExchangeMessages) {
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  boost::asio::io_context context;
+  struct : ShmServer::Observer {
+    ShmServer *server{nullptr};
+    size_t messageCount{0};
+    void onReceived(ConnectionId id, const std::string &m) override {
+      server->send(id, m);
+      messageCount++;
+    };
+  } serverObserver;
+  ShmServer server{context, serverObserver};
+  serverObserver.server = &server;
+  EXPECT_EQ(server.listen(f_endpoint), true);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  struct : ShmClient::Observer {
+    std::string message{generateRandomString(messageSize)};
+    size_t messageCount{0};
+    void onReceived(const std::string &m) override {
+      EXPECT_EQ(message, m);
+      messageCount++;
+    };
+  } clientObserver;
+  ShmClient client{context, clientObserver};
+  client.connect(f_endpoint);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    EXPECT_EQ(client.send(clientObserver.message), true);
+  }
+  EXPECT_EQ(client.send(std::shared_ptr<const Buffer>{}), false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.messageCount, messageCount);
+  EXPECT_EQ(clientObserver.messageCount, messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(ShmTest, MessagesLargerThanRingAreQueued) {
+  constexpr size_t messageSize{100000};
+  constexpr size_t messageCount{20};
+  ConnectionOptions options;
+  options.sharedMemoryRingSize = 4096;
+  options.busyPollDuration = std::chrono::microseconds(50);
+  boost::asio::io_context context;
+  struct : ShmServer::Observer {
+    std::string message{generateRandomString(messageSize)};
+    size_t messageCount{0};
+    void onReceived(ConnectionId, const std::string &m) override {
+      EXPECT_EQ(message, m);
+      messageCount++;
+    };
+  } serverObserver;
+  ShmServer server{context, serverObserver, Framing::binary(), options};
+  server.listen(f_endpoint);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  ShmClient::Observer clientObserver;
+  ShmClient client{context, clientObserver, Framing::binary(), options};
+  client.connect(f_endpoint);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    EXPECT_EQ(client.send(serverObserver.message), true);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(serverObserver.messageCount, messageCount);
+  ConnectionStats stats;
+  EXPECT_EQ(client.stats(stats), true);
+  EXPECT_EQ(stats.messagesSent, messageCount);
+  EXPECT_EQ(stats.pendingBytes, 0);
+  context.stop();
+  thread.join();
+}
+
+TEST(ShmTest, ClientDetectsServerClose) {
+  boost::asio::io_context context;
+  ShmServer::Observer serverObserver;
+  ShmServer server{context, serverObserver};
+  server.listen(f_endpoint);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  struct : ShmClient::Observer {
+    bool isConnected{false};
+    void onConnected() override { isConnected = true; };
+    void onDisconnected() override { isConnected = false; };
+  } clientObserver;
+  ShmClient client{context, clientObserver};
+  client.connect(f_endpoint);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(clientObserver.isConnected, true);
+  boost::asio::post(context, [&server]() { server.close(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(clientObserver.isConnected, false);
+  EXPECT_EQ(server.stats().connectionsClosed, 1);
+  context.stop();
+  thread.join();
+}
+
+TEST(ShmTest, ClientNotifiesFailedConnect) {
+  std::filesystem::remove(f_endpoint.path());
+  boost::asio::io_context context;
+  struct : ShmClient::Observer {
+    int disconnectedCount{0};
+    void onDisconnected() override { disconnectedCount++; };
+  } clientObserver;
+  ShmClient client{context, clientObserver};
+  client.connect(f_endpoint);
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(clientObserver.disconnectedCount, 1);
+}
+}  // namespace example::tests
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <example/SlotMap.hpp>
+#include <string>
+#include <vector>
+
+namespace example::tests {
+TEST(SlotMapTest, ErasedHandlesBecomeStale) {
+  SlotMap<std::string> map;
+  auto first{map.insert("first")};
+  auto second{map.insert("second")};
+  EXPECT_NE(first, SlotMap<std::string>::invalidHandle);
+  EXPECT_NE(first, second);
+  ASSERT_NE(map.find(first), nullptr);
+  EXPECT_EQ(*map.find(first), "first");
+  EXPECT_EQ(map.erase(first), true);
+  EXPECT_EQ(map.erase(first), false);
+  EXPECT_EQ(map.find(first), nullptr);
+  auto third{map.insert("third")};
+  EXPECT_NE(third, first);
+  EXPECT_EQ(static_cast<uint32_t>(third), static_cast<uint32_t>(first));
+  EXPECT_EQ(map.find(first), nullptr);
+  ASSERT_NE(map.find(third), nullptr);
+  EXPECT_EQ(*map.find(third), "third");
+  EXPECT_EQ(*map.find(second), "second");
+  map.clear();
+  EXPECT_EQ(map.empty(), true);
+  EXPECT_EQ(map.find(second), nullptr);
+  EXPECT_EQ(map.find(third), nullptr);
+}
+
+TEST(SlotMapTest, ValuesRemainContiguousAfterErase) {
+  SlotMap<int> map;
+  std::vector<SlotMap<int>::Handle> handles;
+  for (int i = 0; i < 10; i++) {
+    handles.push_back(map.insert(i));
+  }
+  for (int i = 0; i < 10; i += 2) {
+    EXPECT_EQ(map.erase(handles[i]), true);
+  }
+  std::vector<int> values{map.begin(), map.end()};
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(values, (std::vector<int>{1, 3, 5, 7, 9}));
+  for (int i = 1; i < 10; i += 2) {
+    ASSERT_NE(map.find(handles[i]), nullptr);
+    EXPECT_EQ(*map.find(handles[i]), i);
+  }
+}
+
+TEST(SlotMapTest, HandlesIdentifyTheirPartition) {
+  constexpr uint32_t partitionCount{3};
+  std::vector<SlotMap<int>> maps;
+  for (uint32_t partition = 0; partition < partitionCount; partition++) {
+    maps.emplace_back(partition, partitionCount);
+  }
+  for (uint32_t partition = 0; partition < partitionCount; partition++) {
+    for (int i = 0; i < 5; i++) {
+      auto handle{maps[partition].insert(i)};
+      EXPECT_EQ(SlotMap<int>::partitionOf(handle, partitionCount), partition);
+      for (uint32_t other = 0; other < partitionCount; other++) {
+        EXPECT_EQ(maps[other].find(handle) != nullptr, other == partition);
+      }
+    }
+  }
+}
+}  // namespace example::tests
@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <example/ShardedTcpServer.hpp>
 #include <example/TcpClient.hpp>
 #include <example/TcpServer.hpp>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <random>
 #include <thread>
 
@@ -23,7 +28,7 @@ TEST(TcpTest, ServerAcceptsAndClientConnects) {
   boost::asio::io_context context;
   struct : TcpServer::Observer {
     bool hasAccepted{false};
-    void onConnectionAccepted(int) override { hasAccepted = true; };
+    void onConnectionAccepted(ConnectionId) override { hasAccepted = true; };
   } serverObserver;
   TcpServer server{context, serverObserver};
   server.listen(protocol, port);
@@ -51,7 +56,7 @@ TEST(TcpTest, ClientSends) {
   struct : TcpServer::Observer {
     std::string message{generateRandomString(messageSize)};
     size_t messageCount{0};
-    void onReceived(int, const std::string &m) override {
+    void onReceived(ConnectionId, const std::string &m) override {
       EXPECT_EQ(message, m);
       messageCount++;
     };
@@ -80,8 +85,8 @@ TEST(TcpTest, ServerSends) {
   const auto protocol{boost::asio::ip::tcp::v4()};
   boost::asio::io_context context;
   struct : TcpServer::Observer {
-    int connectionId;
-    void onConnectionAccepted(int id) override { connectionId = id; };
+    ConnectionId connectionId;
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
   } serverObserver;
   TcpServer server{context, serverObserver};
   server.listen(protocol, port);
@@ -107,14 +112,911 @@ TEST(TcpTest, ServerSends) {
   thread.join();
 }
 
+TEST(TcpTest, ClientAndServerSendOverUnixDomainSocket) {
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const boost::asio::local::stream_protocol::endpoint endpoint{
+      (std::filesystem::temp_directory_path() / "example_tests.sock")
+          .string()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    TcpServer *server{nullptr};
+    size_t messageCount{0};
+    void onReceived(ConnectionId id, const std::string &m) override {
+      server->send(id, m);
+      messageCount++;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  serverObserver.server = &server;
+  EXPECT_EQ(server.listen(endpoint), true);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  struct : TcpClient::Observer {
+    std::string message{generateRandomString(messageSize)};
+    size_t messageCount{0};
+    void onReceived(const std::string &m) override {
+      EXPECT_EQ(message, m);
+      messageCount++;
+    };
+  } clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect(endpoint);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    client.send(clientObserver.message);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.messageCount, messageCount);
+  EXPECT_EQ(clientObserver.messageCount, messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ClientSendsWithTextFraming) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::string message{generateRandomString(messageSize)};
+    size_t messageCount{0};
+    void onReceived(ConnectionId, const std::string &m) override {
+      EXPECT_EQ(message, m);
+      messageCount++;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::text()};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver, Framing::text()};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    client.send(serverObserver.message);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.messageCount, messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerReceivesBatches) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{10};
+  constexpr size_t messageCount{10000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::string message{generateRandomString(messageSize)};
+    size_t messageCount{0};
+    size_t batchCount{0};
+    void onReceivedBatch(ConnectionId, const MessageBatch &messages) override {
+      for (const auto &m : messages) {
+        EXPECT_EQ(message, m.view());
+      }
+      messageCount += messages.size();
+      batchCount++;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    client.send(serverObserver.message);
+  }
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.messageCount, messageCount);
+  EXPECT_LT(serverObserver.batchCount, messageCount);
+}
+
+TEST(TcpTest, ServerRetainsReceivedViews) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<std::string> messages;
+    std::vector<SharedMessage> retainedMessages;
+    void onReceivedView(ConnectionId, const MessageView &m) override {
+      EXPECT_EQ(messages.at(retainedMessages.size()), m.view());
+      retainedMessages.push_back(m.retain());
+    };
+  } serverObserver;
+  for (size_t i = 0; i < messageCount; i++) {
+    serverObserver.messages.push_back(generateRandomString(messageSize));
+  }
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (const auto &message : serverObserver.messages) {
+    client.send(message);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  context.stop();
+  thread.join();
+  ASSERT_EQ(serverObserver.retainedMessages.size(), messageCount);
+  for (size_t i = 0; i < messageCount; i++) {
+    EXPECT_EQ(serverObserver.messages[i],
+              serverObserver.retainedMessages[i].view());
+  }
+}
+
+TEST(TcpTest, ServerSendsOwnedAndSharedMessages) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    ConnectionId connectionId;
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  struct : TcpClient::Observer {
+    std::vector<std::string> messages;
+    size_t messageCount{0};
+    void onReceived(const std::string &m) override {
+      EXPECT_EQ(messages.at(messageCount), m);
+      messageCount++;
+    };
+  } clientObserver;
+  for (size_t i = 0; i < messageCount; i++) {
+    clientObserver.messages.push_back(generateRandomString(messageSize));
+  }
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    const auto &message{clientObserver.messages[i]};
+    if (i % 2 == 0) {
+      server.send(serverObserver.connectionId, std::string{message});
+    } else {
+      server.send(serverObserver.connectionId,
+                  std::make_shared<const Buffer>(message));
+    }
+  }
+  EXPECT_EQ(server.send(serverObserver.connectionId,
+                        std::shared_ptr<const Buffer>{}),
+            false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(clientObserver.messageCount, messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerSendsWithSocketOptions) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{100000};
+  constexpr size_t messageCount{100};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.socketOptions.quickAck = true;
+  options.socketOptions.sendBufferSize = 1 << 16;
+  options.socketOptions.receiveBufferSize = 1 << 16;
+  options.socketOptions.zeroCopyThreshold = messageSize / 2;
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    ConnectionId connectionId;
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::binary(), options};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  struct : TcpClient::Observer {
+    std::vector<std::string> messages;
+    size_t messageCount{0};
+    void onReceived(const std::string &m) override {
+      EXPECT_EQ(messages.at(messageCount), m);
+      messageCount++;
+    };
+  } clientObserver;
+  for (size_t i = 0; i < messageCount; i++) {
+    clientObserver.messages.push_back(generateRandomString(messageSize));
+  }
+  TcpClient client{context, clientObserver, Framing::binary(), options};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    const auto &message{clientObserver.messages[i]};
+    if (i % 2 == 0) {
+      server.send(serverObserver.connectionId, std::string{message});
+    } else {
+      server.send(serverObserver.connectionId,
+                  std::make_shared<const Buffer>(message));
+    }
+  }
+  context.run_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(clientObserver.messageCount, messageCount);
+}
+
+TEST(TcpTest, ServerStreamsLargeMessages) {
+  constexpr uint16_t port{1234};
+  constexpr size_t smallSize{100};
+  constexpr size_t largeSize{1 << 20};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.streamingThreshold = smallSize + 1;
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<std::string> events;
+    std::string message;
+    size_t maxChunkSize{0};
+    void onReceived(ConnectionId, const std::string &m) override {
+      events.push_back("message " + std::to_string(m.size()));
+    };
+    void onMessageBegin(ConnectionId, size_t size) override {
+      events.push_back("begin " + std::to_string(size));
+    };
+    void onMessageChunk(ConnectionId, std::string_view chunk) override {
+      message.append(chunk);
+      maxChunkSize = std::max(maxChunkSize, chunk.size());
+    };
+    void onMessageEnd(ConnectionId) override { events.push_back("end"); };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::text(), options};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  const auto largeMessage{generateRandomString(largeSize)};
+  client.send(generateRandomString(smallSize));
+  client.send(largeMessage);
+  client.send(generateRandomString(smallSize));
+  context.run_for(std::chrono::milliseconds(200));
+  const std::vector<std::string> events{"message 100", "begin 1048576", "end",
+                                        "message 100"};
+  EXPECT_EQ(serverObserver.events, events);
+  EXPECT_EQ(serverObserver.message, largeMessage);
+  EXPECT_LT(serverObserver.maxChunkSize, largeSize);
+}
+
+TEST(TcpTest, ClientSendsFile) {
+  constexpr uint16_t port{1234};
+  constexpr size_t fileSize{4 << 20};
+  constexpr size_t offset{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  const auto path{std::filesystem::temp_directory_path() /
+                  "example_tests_file"};
+  const auto contents{generateRandomString(fileSize)};
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << contents;
+  }
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<std::string> messages;
+    void onReceived(ConnectionId, const std::string &m) override {
+      messages.push_back(m);
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_TRUE(client.send("before"));
+  EXPECT_TRUE(client.sendFile(path, offset, fileSize - 2 * offset));
+  EXPECT_TRUE(client.send("after"));
+  EXPECT_FALSE(client.sendFile(path, offset, fileSize));
+  context.run_for(std::chrono::milliseconds(500));
+  ASSERT_EQ(serverObserver.messages.size(), 3);
+  EXPECT_EQ(serverObserver.messages[0], "before");
+  EXPECT_EQ(serverObserver.messages[1],
+            contents.substr(offset, fileSize - 2 * offset));
+  EXPECT_EQ(serverObserver.messages[2], "after");
+  std::filesystem::remove(path);
+}
+
+TEST(TcpTest, ClientSendsHighPriorityBetweenChunks) {
+  constexpr uint16_t port{1234};
+  constexpr size_t largeSize{4 << 20};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.writeChunkSize = 16 << 10;
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<std::string> messages;
+    void onReceived(ConnectionId, const std::string &m) override {
+      messages.push_back(m);
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::binary()};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver, Framing::binary(), options};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  const auto largeMessage{generateRandomString(largeSize)};
+  EXPECT_TRUE(client.send(largeMessage, Priority::Low));
+  EXPECT_TRUE(client.send("normal"));
+  EXPECT_TRUE(client.send("high", Priority::High));
+  context.run_for(std::chrono::milliseconds(500));
+  const std::vector<std::string> messages{"high", "normal", largeMessage};
+  EXPECT_EQ(serverObserver.messages, messages);
+}
+
+TEST(TcpTest, ClientSendsCompressedMessages) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  if (!Codec::zlib()) {
+    GTEST_SKIP() << "zlib codec not built";
+  }
+  ConnectionOptions options;
+  options.codec = Codec::zlib();
+  options.writeChunkSize = 16 << 10;
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<std::string> messages;
+    void onReceived(ConnectionId, const std::string &m) override {
+      messages.push_back(m);
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::binary()};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver, Framing::binary(), options};
+  client.connect({protocol, port});
+  context.run_for(std::chrono::milliseconds(100));
+  std::string text;
+  for (size_t i = 0; text.size() < (1 << 20); i++) {
+    text += "{\"id\": " + std::to_string(i) + ", \"name\": \"example\"}";
+  }
+  const std::vector<std::string> messages{
+      "small", text.substr(0, 2000), generateRandomString(2000), text};
+  for (const auto &message : messages) {
+    EXPECT_TRUE(client.send(message));
+  }
+  context.run_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(serverObserver.messages, messages);
+  ConnectionStats stats;
+  EXPECT_TRUE(client.stats(stats));
+  EXPECT_LT(stats.bytesSent, text.size() / 2);
+}
+
+TEST(TcpTest, ShardedServerEchoes) {
+  constexpr uint16_t port{1234};
+  constexpr size_t shardCount{4};
+  constexpr size_t clientCount{16};
+  constexpr size_t messageCount{100};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  struct Observer : TcpServer::Observer {
+    ShardedTcpServer *server{nullptr};
+    std::mutex mutex;
+    std::map<ConnectionId, std::thread::id> connectionThreads;
+    void onConnectionAccepted(ConnectionId id) override {
+      std::lock_guard<std::mutex> guard{mutex};
+      connectionThreads[id] = std::this_thread::get_id();
+    };
+    void onReceived(ConnectionId id, const std::string &m) override {
+      {
+        std::lock_guard<std::mutex> guard{mutex};
+        EXPECT_EQ(connectionThreads.at(id), std::this_thread::get_id());
+      }
+      server->send(id, m);
+    };
+  } serverObserver;
+  ShardedTcpServer server{serverObserver, shardCount};
+  serverObserver.server = &server;
+  EXPECT_EQ(server.listen(protocol, port), true);
+  server.startAcceptingConnections();
+  boost::asio::io_context context;
+  struct ClientObserver : TcpClient::Observer {
+    std::atomic<size_t> messageCount{0};
+    void onReceived(const std::string &) override { messageCount++; };
+  } clientObserver;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (size_t i = 0; i < clientCount; i++) {
+    clients.push_back(std::make_unique<TcpClient>(context, clientObserver));
+    clients.back()->connect({protocol, port});
+  }
+  std::thread thread{[&context]() { context.run(); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 0; i < messageCount; i++) {
+    for (auto &client : clients) {
+      client->send(generateRandomString(100));
+    }
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(clientObserver.messageCount, clientCount * messageCount);
+  EXPECT_EQ(serverObserver.connectionThreads.size(), clientCount);
+  server.close();
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerBroadcasts) {
+  constexpr uint16_t port{1234};
+  constexpr size_t clientCount{8};
+  constexpr size_t messageCount{100};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<ConnectionId> connectionIds;
+    void onConnectionAccepted(ConnectionId id) override {
+      connectionIds.push_back(id);
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  struct : TcpClient::Observer {
+    std::string message{generateRandomString(1000)};
+    std::atomic<size_t> messageCount{0};
+    void onReceived(const std::string &m) override {
+      EXPECT_EQ(message, m);
+      messageCount++;
+    };
+  } clientObserver;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (size_t i = 0; i < clientCount; i++) {
+    clients.push_back(std::make_unique<TcpClient>(context, clientObserver));
+    clients.back()->connect({protocol, port});
+  }
+  std::thread thread{[&context]() { context.run(); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  boost::asio::post(context, [&]() {
+    for (size_t i = 0; i < messageCount; i++) {
+      EXPECT_EQ(server.broadcast(clientObserver.message), clientCount);
+      EXPECT_EQ(server.multicast({serverObserver.connectionIds.front()},
+                                 clientObserver.message),
+                1);
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(clientObserver.messageCount, (clientCount + 1) * messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerBroadcastDisconnectsSlowReceivers) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000000};
+  constexpr size_t messageCount{100};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    bool clientIsConnected{false};
+    void onConnectionAccepted(ConnectionId) override {
+      clientIsConnected = true;
+    };
+    void onConnectionClosed(ConnectionId) override {
+      clientIsConnected = false;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.setSlowReceiverPolicy(TcpServer::SlowReceiverPolicy::Disconnect,
+                               messageSize);
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  boost::asio::io_context clientContext;
+  TcpClient::Observer clientObserver;
+  TcpClient client{clientContext, clientObserver};
+  client.connect({protocol, port});
+  clientContext.run_for(std::chrono::milliseconds(100));
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.clientIsConnected, true);
+  const auto message{generateRandomString(messageSize)};
+  for (size_t i = 0; i < messageCount; i++) {
+    server.broadcast(message);
+    context.run_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(serverObserver.clientIsConnected, false);
+}
+
+TEST(TcpTest, ServerSendQueueReachesWatermarks) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{100000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    ConnectionId connectionId;
+    bool isSendQueueHigh{false};
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
+    void onSendQueueHigh(ConnectionId) override { isSendQueueHigh = true; };
+    void onWritable(ConnectionId) override { isSendQueueHigh = false; };
+  } serverObserver;
+  ConnectionOptions options;
+  options.sendQueueHighWatermark = 10 * messageSize;
+  options.sendQueueLowWatermark = messageSize;
+  TcpServer server{context, serverObserver, Framing::text(), options};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  boost::asio::io_context clientContext;
+  TcpClient::Observer clientObserver;
+  TcpClient client{clientContext, clientObserver};
+  client.connect({protocol, port});
+  clientContext.run_for(std::chrono::milliseconds(100));
+  context.run_for(std::chrono::milliseconds(100));
+  const auto message{generateRandomString(messageSize)};
+  size_t sentCount{0};
+  while (server.send(serverObserver.connectionId, message)) {
+    sentCount++;
+    context.poll();
+  }
+  EXPECT_GT(sentCount, 0);
+  EXPECT_EQ(serverObserver.isSendQueueHigh, true);
+  clientContext.run_for(std::chrono::milliseconds(100));
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.isSendQueueHigh, false);
+  EXPECT_EQ(server.send(serverObserver.connectionId, message), true);
+}
+
+TEST(TcpTest, ServerSubmitsFromManyThreads) {
+  constexpr uint16_t port{1234};
+  constexpr size_t producerCount{4};
+  constexpr size_t messageCount{1000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::atomic<ConnectionId> connectionId{0};
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  struct : TcpClient::Observer {
+    std::vector<size_t> nextMessages = std::vector<size_t>(producerCount);
+    std::atomic<size_t> messageCount{0};
+    void onReceived(const std::string &m) override {
+      auto separator = m.find(':');
+      auto producer = std::stoul(m.substr(0, separator));
+      EXPECT_EQ(std::stoul(m.substr(separator + 1)), nextMessages[producer]++);
+      messageCount++;
+    };
+  } clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::thread thread{[&context]() { context.run(); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_NE(serverObserver.connectionId, 0);
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < producerCount; i++) {
+    producers.emplace_back([&, i]() {
+      for (size_t j = 0; j < messageCount; j++) {
+        server.submit(serverObserver.connectionId,
+                      std::to_string(i) + ":" + std::to_string(j));
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(clientObserver.messageCount, producerCount * messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ClientSendsFromTwoThreadsWhileWriting) {
+  constexpr uint16_t port{1234};
+  constexpr size_t producerCount{2};
+  constexpr size_t messageCount{5000};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  const std::string largeMessage(8 << 20, 'x');
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<size_t> nextMessages = std::vector<size_t>(producerCount);
+    std::atomic<size_t> messageCount{0};
+    std::atomic<size_t> largeMessageCount{0};
+    void onReceived(ConnectionId, const std::string &m) override {
+      auto separator = m.find(':');
+      if (separator == std::string::npos) {
+        largeMessageCount++;
+        return;
+      }
+      auto producer = std::stoul(m.substr(0, separator));
+      EXPECT_EQ(std::stoul(m.substr(separator + 1)), nextMessages[producer]++);
+      messageCount++;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  struct : TcpClient::Observer {
+    std::atomic<bool> isConnected{false};
+    void onConnected() override { isConnected = true; };
+  } clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::thread thread{[&context]() { context.run(); }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(clientObserver.isConnected, true);
+  // the large message keeps the connection writing, so that the io thread
+  // drains submissions while both producers push to the emptied queue.
+  EXPECT_EQ(client.send(largeMessage), true);
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < producerCount; i++) {
+    producers.emplace_back([&, i]() {
+      for (size_t j = 0; j < messageCount; j++) {
+        client.send(std::to_string(i) + ":" + std::to_string(j));
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(serverObserver.largeMessageCount, 1);
+  EXPECT_EQ(serverObserver.messageCount, producerCount * messageCount);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerBoundsBufferedBytes) {
+  constexpr uint16_t port{1234};
+  constexpr size_t clientCount{4};
+  constexpr size_t messageSize{100000};
+  constexpr size_t maxBufferedBytes{10 * messageSize};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::vector<ConnectionId> connectionIds;
+    void onConnectionAccepted(ConnectionId id) override {
+      connectionIds.push_back(id);
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.setMaxBufferedBytes(maxBufferedBytes);
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  boost::asio::io_context clientContext;
+  TcpClient::Observer clientObserver;
+  std::vector<std::unique_ptr<TcpClient>> clients;
+  for (size_t i = 0; i < clientCount; i++) {
+    clients.push_back(
+        std::make_unique<TcpClient>(clientContext, clientObserver));
+    clients.back()->connect({protocol, port});
+  }
+  clientContext.run_for(std::chrono::milliseconds(100));
+  context.run_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(serverObserver.connectionIds.size(), clientCount);
+  const auto message{generateRandomString(messageSize)};
+  size_t sentBytes{0};
+  for (size_t i = 0; i < 1000; i++) {
+    for (auto connectionId : serverObserver.connectionIds) {
+      if (server.send(connectionId, message)) {
+        sentBytes += messageSize;
+      }
+    }
+  }
+  EXPECT_LE(sentBytes, maxBufferedBytes + clientCount * messageSize);
+}
+
+TEST(TcpTest, ServerCountsTraffic) {
+  constexpr uint16_t port{1234};
+  constexpr size_t messageSize{1000};
+  constexpr size_t messageCount{1000};
+  constexpr size_t headerSize{5};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    ConnectionId connectionId;
+    void onConnectionAccepted(ConnectionId id) override { connectionId = id; };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  const auto message{generateRandomString(messageSize)};
+  for (size_t i = 0; i < messageCount; i++) {
+    client.send(message);
+  }
+  server.send(serverObserver.connectionId, message);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  auto stats = server.stats();
+  EXPECT_EQ(stats.connectionsAccepted, 1);
+  EXPECT_EQ(stats.activeConnections, 1);
+  EXPECT_EQ(stats.messagesReceived, messageCount);
+  EXPECT_EQ(stats.bytesReceived, messageCount * (headerSize + messageSize));
+  EXPECT_EQ(stats.messagesSent, 1);
+  EXPECT_EQ(stats.bytesSent, headerSize + messageSize);
+  EXPECT_EQ(stats.sendLatency.count, 1);
+  EXPECT_EQ(stats.pendingBytes, 0);
+  ConnectionStats clientStats;
+  EXPECT_EQ(client.stats(clientStats), true);
+  EXPECT_EQ(clientStats.messagesSent, messageCount);
+  EXPECT_EQ(clientStats.messagesReceived, 1);
+  client.disconnect();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  stats = server.stats();
+  EXPECT_EQ(stats.connectionsClosed, 1);
+  EXPECT_EQ(stats.activeConnections, 0);
+  EXPECT_EQ(stats.connectionLifetime.count, 1);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerClosesIdleConnections) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.idleTimeout = std::chrono::milliseconds(100);
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::atomic<bool> clientIsConnected{false};
+    void onConnectionAccepted(ConnectionId) override {
+      clientIsConnected = true;
+    };
+    void onConnectionClosed(ConnectionId) override {
+      clientIsConnected = false;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::text(), options};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  for (int i = 0; i < 10; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    client.send("keepalive");
+  }
+  EXPECT_EQ(serverObserver.clientIsConnected, true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(serverObserver.clientIsConnected, false);
+  EXPECT_EQ(server.stats().connectionsClosed, 1);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerPausesAcceptingAtMaxConnections) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::atomic<int> acceptedCount{0};
+    std::atomic<int> pausedCount{0};
+    std::atomic<int> resumedCount{0};
+    void onConnectionAccepted(ConnectionId) override { acceptedCount++; };
+    void onAcceptPaused() override { pausedCount++; };
+    void onAcceptResumed() override { resumedCount++; };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  server.setMaxConnections(1);
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient first{context, clientObserver};
+  TcpClient second{context, clientObserver};
+  first.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  second.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.acceptedCount, 1);
+  EXPECT_EQ(serverObserver.pausedCount, 1);
+  first.disconnect();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.acceptedCount, 2);
+  EXPECT_EQ(serverObserver.resumedCount, 1);
+  EXPECT_EQ(serverObserver.pausedCount, 2);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerLimitsAcceptRate) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::atomic<int> acceptedCount{0};
+    std::atomic<int> pausedCount{0};
+    std::atomic<int> resumedCount{0};
+    void onConnectionAccepted(ConnectionId) override { acceptedCount++; };
+    void onAcceptPaused() override { pausedCount++; };
+    void onAcceptResumed() override { resumedCount++; };
+  } serverObserver;
+  TcpServer server{context, serverObserver};
+  // a burst below one token still lets one connection in every 200
+  // milliseconds.
+  server.setAcceptRateLimit({5, 0.5});
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient first{context, clientObserver};
+  TcpClient second{context, clientObserver};
+  TcpClient third{context, clientObserver};
+  first.connect({protocol, port});
+  second.connect({protocol, port});
+  third.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(serverObserver.acceptedCount, 1);
+  EXPECT_EQ(serverObserver.pausedCount, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  EXPECT_EQ(serverObserver.acceptedCount, 3);
+  EXPECT_EQ(serverObserver.resumedCount, 2);
+  context.stop();
+  thread.join();
+}
+
+TEST(TcpTest, ServerThrottlesReceivedMessages) {
+  constexpr uint16_t port{1234};
+  const auto protocol{boost::asio::ip::tcp::v4()};
+  ConnectionOptions options;
+  options.receiveMessageLimit = {100, 10};
+  boost::asio::io_context context;
+  struct : TcpServer::Observer {
+    std::atomic<int> receivedCount{0};
+    std::atomic<bool> isPaused{false};
+    std::atomic<int> resumedCount{0};
+    void onReceived(ConnectionId, const std::string &) override {
+      receivedCount++;
+    };
+    void onReceivePaused(ConnectionId) override { isPaused = true; };
+    void onReceiveResumed(ConnectionId) override {
+      isPaused = false;
+      resumedCount++;
+    };
+  } serverObserver;
+  TcpServer server{context, serverObserver, Framing::text(), options};
+  server.listen(protocol, port);
+  server.startAcceptingConnections();
+  std::thread thread{[&context]() { context.run(); }};
+  TcpClient::Observer clientObserver;
+  TcpClient client{context, clientObserver};
+  client.connect({protocol, port});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // the first batch leaves the connection in debt for 400 milliseconds,
+  // during which the second one waits in the socket.
+  for (int i = 0; i < 50; i++) {
+    client.send("message");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(serverObserver.receivedCount, 50);
+  EXPECT_EQ(serverObserver.isPaused, true);
+  for (int i = 0; i < 50; i++) {
+    client.send("message");
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(serverObserver.receivedCount, 50);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  EXPECT_EQ(serverObserver.receivedCount, 100);
+  EXPECT_GE(serverObserver.resumedCount, 1);
+  context.stop();
+  thread.join();
+}
+
 TEST(TcpTest, ClientDisconnects) {
   constexpr uint16_t port{1234};
   const auto protocol{boost::asio::ip::tcp::v4()};
   boost::asio::io_context context;
   struct : TcpServer::Observer {
     bool clientIsConnected{false};
-    void onConnectionAccepted(int) override { clientIsConnected = true; };
-    void onConnectionClosed(int) override { clientIsConnected = false; };
+    void onConnectionAccepted(ConnectionId) override {
+      clientIsConnected = true;
+    };
+    void onConnectionClosed(ConnectionId) override {
+      clientIsConnected = false;
+    };
   } serverObserver;
   TcpServer server{context, serverObserver};
   server.listen(protocol, port);
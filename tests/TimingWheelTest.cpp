@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <example/TimingWheel.hpp>
+#include <vector>
+
+namespace example::tests {
+TEST(TimingWheelTest, TimersExpireInOrderAfterTheirDelay) {
+  boost::asio::io_context context;
+  auto &wheel = TimingWheel::of(context);
+  const auto startTime = std::chrono::steady_clock::now();
+  const std::vector<std::chrono::milliseconds> delays{
+      std::chrono::milliseconds(300), std::chrono::milliseconds(5),
+      std::chrono::milliseconds(70), std::chrono::milliseconds(20)};
+  std::vector<std::chrono::milliseconds> expired;
+  std::vector<std::unique_ptr<TimingWheel::Timer>> timers;
+  for (auto delay : delays) {
+    timers.push_back(std::make_unique<TimingWheel::Timer>([&, delay]() {
+      EXPECT_GE(std::chrono::steady_clock::now() - startTime, delay);
+      expired.push_back(delay);
+    }));
+    wheel.arm(*timers.back(), delay);
+  }
+  EXPECT_EQ(wheel.size(), delays.size());
+  context.run_for(std::chrono::milliseconds(400));
+  EXPECT_EQ(expired, (std::vector<std::chrono::milliseconds>{
+                         std::chrono::milliseconds(5),
+                         std::chrono::milliseconds(20),
+                         std::chrono::milliseconds(70),
+                         std::chrono::milliseconds(300)}));
+  EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TimingWheelTest, CancelledAndDestroyedTimersDoNotExpire) {
+  boost::asio::io_context context;
+  auto &wheel = TimingWheel::of(context);
+  size_t expiredCount{0};
+  TimingWheel::Timer cancelled{[&expiredCount]() { expiredCount++; }};
+  TimingWheel::Timer rearmed{[&expiredCount]() { expiredCount++; }};
+  wheel.arm(cancelled, std::chrono::milliseconds(10));
+  wheel.arm(rearmed, std::chrono::milliseconds(10));
+  {
+    TimingWheel::Timer destroyed{[&expiredCount]() { expiredCount++; }};
+    wheel.arm(destroyed, std::chrono::milliseconds(10));
+  }
+  wheel.cancel(cancelled);
+  wheel.arm(rearmed, std::chrono::milliseconds(200));
+  EXPECT_EQ(cancelled.isArmed(), false);
+  EXPECT_EQ(rearmed.isArmed(), true);
+  context.run_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(expiredCount, 0);
+  context.restart();
+  context.run_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(expiredCount, 1);
+  EXPECT_EQ(rearmed.isArmed(), false);
+}
+}  // namespace example::tests
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include <example/TokenBucket.hpp>
+
+namespace example::tests {
+TEST(TokenBucketTest, AllowsBurstThenRefillsAtRate) {
+  TokenBucket bucket{{10, 3}};
+  const auto startTime = std::chrono::steady_clock::now();
+  EXPECT_TRUE(bucket.isLimited());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(bucket.tryTake(1, startTime));
+  }
+  EXPECT_FALSE(bucket.tryTake(1, startTime));
+  EXPECT_EQ(bucket.delay(1, startTime), std::chrono::milliseconds(100));
+  EXPECT_TRUE(bucket.tryTake(1, startTime + std::chrono::milliseconds(100)));
+  // tokens beyond the burst are not accumulated.
+  const auto laterTime = startTime + std::chrono::seconds(10);
+  EXPECT_TRUE(bucket.tryTake(3, laterTime));
+  EXPECT_FALSE(bucket.tryTake(1, laterTime));
+}
+
+TEST(TokenBucketTest, HoldsAtLeastOneToken) {
+  TokenBucket bucket{{0.5, 0}};
+  const auto startTime = std::chrono::steady_clock::now();
+  EXPECT_TRUE(bucket.tryTake(1, startTime));
+  EXPECT_FALSE(bucket.tryTake(1, startTime));
+  EXPECT_EQ(bucket.delay(1, startTime), std::chrono::seconds(2));
+}
+
+TEST(TokenBucketTest, TakesIntoDebt) {
+  TokenBucket bucket{{1000, 0}};
+  const auto startTime = std::chrono::steady_clock::now();
+  bucket.take(1500, startTime);
+  EXPECT_EQ(bucket.delay(0, startTime), std::chrono::milliseconds(500));
+  EXPECT_EQ(bucket.delay(0, startTime + std::chrono::milliseconds(500)),
+            std::chrono::nanoseconds(0));
+  TokenBucket unlimited;
+  EXPECT_FALSE(unlimited.isLimited());
+  unlimited.take(1e9, startTime);
+  EXPECT_TRUE(unlimited.tryTake(1e9, startTime));
+  EXPECT_EQ(unlimited.delay(1e9, startTime), std::chrono::nanoseconds(0));
+}
+}  // namespace example::tests